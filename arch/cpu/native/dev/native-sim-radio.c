@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         IEEE 802.15.4 radio on the emulated medium of the native
+ *         simulation mode (NATIVE_SIM=1).
+ */
+
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "sys/energest.h"
+
+#include "native-sim.h"
+#include "dev/native-sim-radio.h"
+
+#define MIN_CHANNEL 11
+#define MAX_CHANNEL 26
+
+/* The medium reports no signal levels, use those of a good link */
+#define SIM_RSSI -60
+#define SIM_LQI  105
+
+static uint8_t radio_is_on;
+static uint8_t channel = IEEE802154_DEFAULT_CHANNEL;
+static uint8_t receiving;
+static rtimer_clock_t last_packet_timestamp;
+
+static uint8_t rx_buf[NATIVE_SIM_MAX_FRAME];
+static uint16_t rx_len;
+
+static const void *pending_data;
+
+/* If we are in the polling mode, poll_mode is 1; otherwise 0 */
+static int poll_mode = 0;
+static int send_on_cca = 0;
+
+PROCESS(native_sim_radio_process, "native sim radio process");
+/*---------------------------------------------------------------------------*/
+static void
+send_state(void)
+{
+  uint8_t state[2];
+
+  state[0] = radio_is_on;
+  state[1] = channel;
+  native_sim_send(NATIVE_SIM_MSG_RADIO, state, sizeof(state));
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_radio_rx_start(native_sim_time_t time)
+{
+  if(radio_is_on) {
+    receiving = 1;
+    last_packet_timestamp = (rtimer_clock_t)time;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_radio_rx_end(uint8_t ok, const uint8_t *data, uint16_t len)
+{
+  if(!receiving) {
+    /* Reception aborted by a radio off or channel change */
+    return;
+  }
+  receiving = 0;
+  if(ok && len <= sizeof(rx_buf)) {
+    memcpy(rx_buf, data, len);
+    rx_len = len;
+    if(!poll_mode) {
+      process_poll(&native_sim_radio_process);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_on(void)
+{
+  if(!radio_is_on) {
+    ENERGEST_ON(ENERGEST_TYPE_LISTEN);
+    radio_is_on = 1;
+    send_state();
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_off(void)
+{
+  if(radio_is_on) {
+    ENERGEST_OFF(ENERGEST_TYPE_LISTEN);
+    radio_is_on = 0;
+    /* A frame being received is lost, a received one stays buffered */
+    receiving = 0;
+    send_state();
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_channel(uint8_t c)
+{
+  if(c != channel) {
+    channel = c;
+    receiving = 0;
+    send_state();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short bufsize)
+{
+  int len = rx_len;
+
+  if(rx_len == 0) {
+    return 0;
+  }
+  rx_len = 0;
+  if(bufsize < len) {
+    return 0;
+  }
+
+  memcpy(buf, rx_buf, len);
+  if(!poll_mode) {
+    packetbuf_set_attr(PACKETBUF_ATTR_RSSI, SIM_RSSI);
+    packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, SIM_LQI);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return !receiving;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_send(const void *payload, unsigned short payload_len)
+{
+  uint8_t frame[NATIVE_SIM_MAX_FRAME + 1];
+  native_sim_time_t end;
+  int was_on = radio_is_on;
+
+  if(payload_len == 0 || payload_len > NATIVE_SIM_MAX_FRAME) {
+    return RADIO_TX_ERR;
+  }
+  if(send_on_cca && !channel_clear()) {
+    return RADIO_TX_COLLISION;
+  }
+
+  if(was_on) {
+    ENERGEST_SWITCH(ENERGEST_TYPE_LISTEN, ENERGEST_TYPE_TRANSMIT);
+  } else {
+    ENERGEST_ON(ENERGEST_TYPE_TRANSMIT);
+  }
+
+  /* Half duplex: whatever was being received is lost */
+  receiving = 0;
+
+  frame[0] = channel;
+  memcpy(frame + 1, payload, payload_len);
+  native_sim_send(NATIVE_SIM_MSG_TX, frame, payload_len + 1);
+
+  /* Block for the air time of the frame */
+  end = native_sim_now() + NATIVE_SIM_AIRTIME(payload_len);
+  while(native_sim_now() < end) {
+    native_sim_wait(end);
+  }
+
+  if(was_on) {
+    ENERGEST_SWITCH(ENERGEST_TYPE_TRANSMIT, ENERGEST_TYPE_LISTEN);
+  } else {
+    ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare_packet(const void *data, unsigned short len)
+{
+  if(len > NATIVE_SIM_MAX_FRAME) {
+    return RADIO_TX_ERR;
+  }
+  pending_data = data;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit_packet(unsigned short len)
+{
+  int ret = RADIO_TX_ERR;
+  if(pending_data != NULL) {
+    ret = radio_send(pending_data, len);
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return receiving;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return !receiving && rx_len > 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(native_sim_radio_process, ev, data)
+{
+  int len;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    if(poll_mode) {
+      continue;
+    }
+
+    packetbuf_clear();
+    len = radio_read(packetbuf_dataptr(), PACKETBUF_SIZE);
+    if(len > 0) {
+      packetbuf_set_datalen(len);
+      NETSTACK_MAC.input();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  process_start(&native_sim_radio_process, NULL);
+  send_state();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  switch(param) {
+  case RADIO_PARAM_POWER_MODE:
+    *value = radio_is_on ? RADIO_POWER_MODE_ON : RADIO_POWER_MODE_OFF;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_RX_MODE:
+    *value = poll_mode ? RADIO_RX_MODE_POLL_MODE : 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_TX_MODE:
+    *value = send_on_cca ? RADIO_TX_MODE_SEND_ON_CCA : 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_LAST_RSSI:
+  case RADIO_PARAM_RSSI:
+    *value = SIM_RSSI;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_LAST_LINK_QUALITY:
+    *value = SIM_LQI;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_MAX_PAYLOAD_LEN:
+    *value = NATIVE_SIM_MAX_FRAME;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_CHANNEL:
+    *value = channel;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_CHANNEL_MIN:
+    *value = MIN_CHANNEL;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_CHANNEL_MAX:
+    *value = MAX_CHANNEL;
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  switch(param) {
+  case RADIO_PARAM_POWER_MODE:
+    if(value == RADIO_POWER_MODE_ON) {
+      radio_on();
+      return RADIO_RESULT_OK;
+    }
+    if(value == RADIO_POWER_MODE_OFF) {
+      radio_off();
+      return RADIO_RESULT_OK;
+    }
+    return RADIO_RESULT_INVALID_VALUE;
+  case RADIO_PARAM_RX_MODE:
+    /* Neither address filtering nor auto-ACK are emulated */
+    if(value & ~RADIO_RX_MODE_POLL_MODE) {
+      return RADIO_RESULT_NOT_SUPPORTED;
+    }
+    poll_mode = (value & RADIO_RX_MODE_POLL_MODE) != 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_TX_MODE:
+    if(value & ~RADIO_TX_MODE_SEND_ON_CCA) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    send_on_cca = (value & RADIO_TX_MODE_SEND_ON_CCA) != 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_CHANNEL:
+    if(value < MIN_CHANNEL || value > MAX_CHANNEL) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    set_channel(value);
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  if(param == RADIO_PARAM_LAST_PACKET_TIMESTAMP) {
+    if(size != sizeof(rtimer_clock_t) || !dest) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    *(rtimer_clock_t *)dest = last_packet_timestamp;
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver native_sim_radio_driver =
+{
+  init,
+  prepare_packet,
+  transmit_packet,
+  radio_send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  radio_on,
+  radio_off,
+  get_value,
+  set_value,
+  get_object,
+  set_object
+};
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         IEEE 802.15.4 radio on the emulated medium of the native
+ *         simulation mode (NATIVE_SIM=1).
+ */
+
+#ifndef NATIVE_SIM_RADIO_H_
+#define NATIVE_SIM_RADIO_H_
+
+#include "contiki.h"
+#include "dev/radio.h"
+#include "native-sim-protocol.h"
+
+extern const struct radio_driver native_sim_radio_driver;
+
+/**
+ * \brief Called by the simulation layer when a frame starts on the air
+ * \param time The virtual time of the start of frame
+ */
+void native_sim_radio_rx_start(native_sim_time_t time);
+
+/**
+ * \brief Called by the simulation layer when a frame ends
+ * \param ok Zero if the frame was lost (collision or link loss)
+ * \param data The frame
+ * \param len The frame length
+ */
+void native_sim_radio_rx_end(uint8_t ok, const uint8_t *data, uint16_t len);
+
+#endif /* NATIVE_SIM_RADIO_H_ */
@@ -32,6 +32,13 @@
 #ifndef NATIVE_DEF_H_
 #define NATIVE_DEF_H_
 /*---------------------------------------------------------------------------*/
+/* Multi-node simulation on a virtual clock, enabled with NATIVE_SIM=1 */
+#ifdef NATIVE_CONF_SIM
+#define NATIVE_SIM NATIVE_CONF_SIM
+#else
+#define NATIVE_SIM 0
+#endif
+/*---------------------------------------------------------------------------*/
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
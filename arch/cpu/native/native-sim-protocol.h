@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Wire protocol between native simulation nodes and the medium
+ *         (tools/native-sim). Shared by both sides, host byte order.
+ */
+
+#ifndef NATIVE_SIM_PROTOCOL_H_
+#define NATIVE_SIM_PROTOCOL_H_
+
+#include <stdint.h>
+
+/* Largest frame carried over the emulated medium */
+#define NATIVE_SIM_MAX_FRAME 127
+
+/* Node to medium */
+#define NATIVE_SIM_MSG_HELLO     1 /* time unused, id in payload */
+#define NATIVE_SIM_MSG_WAIT      2 /* time: deadline, UINT64_MAX for none */
+#define NATIVE_SIM_MSG_TX        3 /* payload: channel, frame */
+#define NATIVE_SIM_MSG_RADIO     4 /* payload: on, channel */
+
+/* Medium to node */
+#define NATIVE_SIM_MSG_WAKE      16 /* time: the new virtual time */
+#define NATIVE_SIM_MSG_RX_START  17 /* time: start of frame (SFD) */
+#define NATIVE_SIM_MSG_RX_END    18 /* payload: ok, frame */
+#define NATIVE_SIM_MSG_BUTTON    19 /* user button press */
+
+/* Virtual time is in microseconds */
+typedef uint64_t native_sim_time_t;
+
+#define NATIVE_SIM_TIME_NONE UINT64_MAX
+
+struct native_sim_msg_hdr {
+  uint8_t type;
+  uint8_t pad;
+  uint16_t len;      /* payload length */
+  uint32_t reserved;
+  native_sim_time_t time;
+};
+
+/* Air time of a frame of len bytes from the SFD on: length byte, frame
+ * and 2-byte FCS at 32 us per byte, as RADIO_PHY_OVERHEAD on Cooja */
+#define NATIVE_SIM_AIRTIME(len) ((native_sim_time_t)((len) + 3) * 32)
+
+#endif /* NATIVE_SIM_PROTOCOL_H_ */
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Native simulation mode: node side of the emulated medium.
+ */
+
+#include "contiki.h"
+#include "sys/platform.h"
+#include "native-sim.h"
+#include "dev/native-sim-radio.h"
+#include "dev/button-hal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Sim"
+#define LOG_LEVEL LOG_LEVEL_MAIN
+
+#define SIM_PRIO (CONTIKI_MIN_INIT_PRIO + 40)
+
+static const char *socket_path;
+static uint16_t node_id_option;
+static uint32_t seed_option;
+static int sock = -1;
+static native_sim_time_t now;
+
+/* Posted as the data of button_hal_press_event */
+static button_hal_button_t sim_button;
+/*---------------------------------------------------------------------------*/
+static int
+socket_callback(const char *optarg)
+{
+  socket_path = optarg;
+  return 0;
+}
+CONTIKI_OPTION(SIM_PRIO, { "sim-socket", required_argument, NULL, 0 },
+               socket_callback, "medium socket (set by native-sim)\n");
+/*---------------------------------------------------------------------------*/
+static int
+id_callback(const char *optarg)
+{
+  node_id_option = atoi(optarg);
+  return 0;
+}
+CONTIKI_OPTION(SIM_PRIO + 1, { "sim-id", required_argument, NULL, 0 },
+               id_callback, "node ID (set by native-sim)\n");
+/*---------------------------------------------------------------------------*/
+static int
+seed_callback(const char *optarg)
+{
+  seed_option = strtoul(optarg, NULL, 0);
+  return 0;
+}
+CONTIKI_OPTION(SIM_PRIO + 2, { "sim-seed", required_argument, NULL, 0 },
+               seed_callback, "simulation seed (set by native-sim)\n");
+/*---------------------------------------------------------------------------*/
+static void
+read_all(void *buf, size_t len)
+{
+  uint8_t *p = buf;
+  ssize_t n;
+
+  while(len > 0) {
+    n = read(sock, p, len);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      /* The medium ended the simulation */
+      exit(EXIT_SUCCESS);
+    }
+    p += n;
+    len -= n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_all(const void *buf, size_t len)
+{
+  const uint8_t *p = buf;
+  ssize_t n;
+
+  while(len > 0) {
+    n = write(sock, p, len);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      exit(EXIT_SUCCESS);
+    }
+    p += n;
+    len -= n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_msg(uint8_t type, native_sim_time_t time, const void *payload,
+         uint16_t len)
+{
+  struct native_sim_msg_hdr hdr;
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = type;
+  hdr.len = len;
+  hdr.time = time;
+  write_all(&hdr, sizeof(hdr));
+  if(len > 0) {
+    write_all(payload, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_send(uint8_t type, const void *payload, uint16_t len)
+{
+  send_msg(type, now, payload, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_init(void)
+{
+  struct sockaddr_un addr;
+
+  if(socket_path == NULL || node_id_option == 0) {
+    errx(EXIT_FAILURE, "NATIVE_SIM build: start the node with tools/native-sim");
+  }
+
+  sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(sock < 0) {
+    err(EXIT_FAILURE, "socket");
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+  if(connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    err(EXIT_FAILURE, "connect %s", socket_path);
+  }
+
+  send_msg(NATIVE_SIM_MSG_HELLO, 0, &node_id_option, sizeof(node_id_option));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_sim_node_id(void)
+{
+  return node_id_option;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+native_sim_seed(void)
+{
+  return seed_option;
+}
+/*---------------------------------------------------------------------------*/
+native_sim_time_t
+native_sim_now(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_wait(native_sim_time_t deadline)
+{
+  struct native_sim_msg_hdr hdr;
+  uint8_t payload[NATIVE_SIM_MAX_FRAME + 1];
+
+  /* Anything printed so far belongs to the current time step */
+  fflush(stdout);
+  send_msg(NATIVE_SIM_MSG_WAIT, deadline, NULL, 0);
+
+  while(1) {
+    read_all(&hdr, sizeof(hdr));
+    if(hdr.len > sizeof(payload)) {
+      errx(EXIT_FAILURE, "oversized message from the medium");
+    }
+    if(hdr.len > 0) {
+      read_all(payload, hdr.len);
+    }
+    now = hdr.time;
+
+    switch(hdr.type) {
+    case NATIVE_SIM_MSG_WAKE:
+      return;
+    case NATIVE_SIM_MSG_RX_START:
+      native_sim_radio_rx_start(hdr.time);
+      break;
+    case NATIVE_SIM_MSG_RX_END:
+      if(hdr.len > 0) {
+        native_sim_radio_rx_end(payload[0], payload + 1, hdr.len - 1);
+      }
+      break;
+    case NATIVE_SIM_MSG_BUTTON:
+      process_post(PROCESS_BROADCAST, button_hal_press_event, &sim_button);
+      break;
+    default:
+      LOG_WARN("unknown message type %u\n", hdr.type);
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Native simulation mode: node side of the emulated medium.
+ *
+ *         With NATIVE_SIM=1, a native node runs on a virtual clock owned
+ *         by the medium (tools/native-sim). The node only blocks in
+ *         native_sim_wait(), which hands control to the medium until the
+ *         given deadline or until a radio event for this node occurs.
+ *         Time in between is skipped, so simulations run as fast as the
+ *         nodes can compute.
+ */
+
+#ifndef NATIVE_SIM_H_
+#define NATIVE_SIM_H_
+
+#include "contiki.h"
+#include "native-sim-protocol.h"
+
+/**
+ * \brief Connects to the medium. Exits if the node was not started by it.
+ */
+void native_sim_init(void);
+
+/**
+ * \brief The node ID assigned by the medium
+ */
+uint16_t native_sim_node_id(void);
+
+/**
+ * \brief The simulation seed, as given to the medium
+ */
+uint32_t native_sim_seed(void);
+
+/**
+ * \brief The current virtual time in microseconds
+ */
+native_sim_time_t native_sim_now(void);
+
+/**
+ * \brief Yields to the medium until deadline or until the next event
+ * \param deadline Absolute virtual time, NATIVE_SIM_TIME_NONE for none
+ *
+ * Radio events received meanwhile are passed to the radio driver before
+ * the function returns.
+ */
+void native_sim_wait(native_sim_time_t deadline);
+
+/**
+ * \brief Sends a message to the medium, stamped with the current time
+ */
+void native_sim_send(uint8_t type, const void *payload, uint16_t len);
+
+#endif /* NATIVE_SIM_H_ */
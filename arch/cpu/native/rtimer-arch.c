@@ -52,6 +52,54 @@
 #define PRINTF(...)
 #endif
 
+#if NATIVE_SIM
+static int rtimer_pending;
+static rtimer_clock_t rtimer_next_expiration;
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+  rtimer_pending = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  rtimer_next_expiration = t;
+  rtimer_pending = 1;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_clock_t
+rtimer_arch_next(void)
+{
+  return rtimer_next_expiration;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_pending(void)
+{
+  return rtimer_pending;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_check(void)
+{
+  static int in_rtimer;
+
+  /* No nesting: an rtimer callback busy waiting must not run the next one */
+  if(!in_rtimer && rtimer_pending
+     && !RTIMER_CLOCK_LT(RTIMER_NOW(), rtimer_next_expiration)) {
+    /* Execute rtimer */
+    rtimer_pending = 0;
+    in_rtimer = 1;
+    rtimer_run_next();
+    in_rtimer = 0;
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+#else /* NATIVE_SIM */
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
@@ -84,3 +132,4 @@ rtimer_arch_schedule(rtimer_clock_t t)
   setitimer(ITIMER_REAL, &val, NULL);
 }
 /*---------------------------------------------------------------------------*/
+#endif /* NATIVE_SIM */
@@ -42,8 +42,36 @@
 
 #include "contiki.h"
 
+#if NATIVE_SIM
+#include "native-sim.h"
+
+/* Microsecond ticks on the virtual clock of the simulation */
+#define RTIMER_ARCH_SECOND UINT64_C(1000000)
+
+#define US_TO_RTIMERTICKS(US)   (US)
+#define RTIMERTICKS_TO_US(T)    (T)
+#define RTIMERTICKS_TO_US_64(T) (T)
+
+#define rtimer_arch_now() ((rtimer_clock_t)native_sim_now())
+
+rtimer_clock_t rtimer_arch_next(void);
+int rtimer_arch_pending(void);
+int rtimer_arch_check(void);
+
+/** \brief Virtual time only advances in native_sim_wait(): hand control
+ * to the medium until the deadline or the next radio event. */
+#define RTIMER_BUSYWAIT_UNTIL_ABS(cond, t0, max_time) \
+  ({                                                                \
+    bool c;                                                         \
+    while(!(c = cond) && RTIMER_CLOCK_LT(RTIMER_NOW(), (t0) + (max_time))) { \
+      native_sim_wait((t0) + (max_time));                           \
+    }                                                               \
+    c;                                                              \
+  })
+#else /* NATIVE_SIM */
 #define RTIMER_ARCH_SECOND CLOCK_CONF_SECOND
 
 #define rtimer_arch_now() clock_time()
+#endif /* NATIVE_SIM */
 
 #endif /* RTIMER_ARCH_H_ */
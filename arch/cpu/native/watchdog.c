@@ -30,9 +30,15 @@
  *
  */
 
+#include "contiki.h"
 #include "dev/watchdog.h"
 #include <stdlib.h>
 
+#if NATIVE_SIM
+#include "sys/rtimer.h"
+#include "native-sim.h"
+#endif /* NATIVE_SIM */
+
 /*---------------------------------------------------------------------------*/
 void
 watchdog_init(void)
@@ -47,6 +53,17 @@ watchdog_start(void)
 void
 watchdog_periodic(void)
 {
+#if NATIVE_SIM
+  /*
+   * Code busy waiting on the main loop (e.g. tsch_get_lock()) expects an
+   * interrupt to make progress. As in Cooja, let simulated time advance
+   * to the next rtimer and run it.
+   */
+  if(!rtimer_arch_check() && rtimer_arch_pending()) {
+    native_sim_wait(rtimer_arch_next());
+    rtimer_arch_check();
+  }
+#endif /* NATIVE_SIM */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Receiver-side channel model for the Cooja radio.
+ */
+
+#include "contiki.h"
+#include "sys/node-id.h"
+#include "dev/channel-model.h"
+
+#if MAC_CONF_WITH_TSCH
+#include "net/mac/tsch/tsch.h"
+#endif /* MAC_CONF_WITH_TSCH */
+
+#if CHANNEL_MODEL_ENABLED
+
+#define MIN_CHANNEL 11
+#define NUM_CHANNELS 16
+
+static uint32_t prng_state;
+static uint8_t initialized;
+static struct channel_model_stats stats;
+
+#ifdef CHANNEL_MODEL_CELLS
+static const struct channel_model_cell default_cells[] = CHANNEL_MODEL_CELLS;
+static const struct channel_model_cell *cells = default_cells;
+static uint16_t cells_count = sizeof(default_cells) / sizeof(default_cells[0]);
+#else
+static const struct channel_model_cell *cells;
+static uint16_t cells_count;
+#endif /* CHANNEL_MODEL_CELLS */
+
+#ifdef CHANNEL_MODEL_TRACE
+static const struct channel_model_trace_entry default_trace[] = CHANNEL_MODEL_TRACE;
+static const struct channel_model_trace_entry *trace = default_trace;
+static uint16_t trace_count = sizeof(default_trace) / sizeof(default_trace[0]);
+#else
+static const struct channel_model_trace_entry *trace;
+static uint16_t trace_count;
+#endif /* CHANNEL_MODEL_TRACE */
+static uint32_t trace_period = CHANNEL_MODEL_TRACE_PERIOD;
+
+/* Gilbert-Elliott state per physical channel */
+static uint8_t ge_bad[NUM_CHANNELS];
+static uint32_t ge_last_slot[NUM_CHANNELS];
+/* Number of per-slot transitions simulated before falling back to the
+ * stationary distribution of the chain */
+#define GE_MAX_STEPS 32
+
+/*---------------------------------------------------------------------------*/
+/* xorshift32, kept separate from random_rand() so that enabling the model
+ * does not perturb the random sequence seen by the application */
+static uint32_t
+prng_next(void)
+{
+  prng_state ^= prng_state << 13;
+  prng_state ^= prng_state >> 17;
+  prng_state ^= prng_state << 5;
+  return prng_state;
+}
+/*---------------------------------------------------------------------------*/
+void
+channel_model_set_seed(uint32_t seed)
+{
+  prng_state = seed ^ ((uint32_t)node_id * 2654435761u);
+  if(prng_state == 0) {
+    prng_state = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+channel_model_trial(uint16_t per_mille)
+{
+  if(per_mille == 0) {
+    return 0;
+  }
+  if(per_mille >= 1000) {
+    return 1;
+  }
+  return (prng_next() % 1000) < per_mille;
+}
+/*---------------------------------------------------------------------------*/
+void
+channel_model_cells_set(const struct channel_model_cell *c, uint16_t count)
+{
+  cells = c;
+  cells_count = count;
+}
+/*---------------------------------------------------------------------------*/
+void
+channel_model_trace_set(const struct channel_model_trace_entry *t,
+                        uint16_t count, uint32_t period)
+{
+  trace = t;
+  trace_count = count;
+  trace_period = period;
+}
+/*---------------------------------------------------------------------------*/
+const struct channel_model_stats *
+channel_model_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
+static void
+cells_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+cells_drop(const struct channel_model_rx *rx)
+{
+  uint16_t i;
+  uint16_t channel;
+
+#if CHANNEL_MODEL_CELLS_BY_OFFSET
+  if(rx->channel_offset == 0xff) {
+    return 0;
+  }
+  channel = rx->channel_offset;
+#else
+  channel = rx->channel;
+#endif
+
+  for(i = 0; i < cells_count; i++) {
+    if((cells[i].timeslot == CHANNEL_MODEL_ANY || cells[i].timeslot == rx->timeslot)
+       && (cells[i].channel == CHANNEL_MODEL_ANY || cells[i].channel == channel)) {
+      return channel_model_trial(cells[i].loss);
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct channel_model_driver channel_model_cells = {
+  "cells",
+  cells_init,
+  cells_drop,
+};
+/*---------------------------------------------------------------------------*/
+static void
+ge_init(void)
+{
+  uint8_t i;
+  for(i = 0; i < NUM_CHANNELS; i++) {
+    ge_bad[i] = 0;
+    ge_last_slot[i] = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+ge_drop(const struct channel_model_rx *rx)
+{
+  uint8_t i;
+  uint32_t steps;
+
+  if(rx->channel < MIN_CHANNEL || rx->channel >= MIN_CHANNEL + NUM_CHANNELS) {
+    return 0;
+  }
+  i = rx->channel - MIN_CHANNEL;
+
+  /* Advance the chain of this channel to the current slot */
+  steps = rx->slot - ge_last_slot[i];
+  ge_last_slot[i] = rx->slot;
+  if(steps > GE_MAX_STEPS) {
+    /* Close enough to stationary: P(bad) = p / (p + r) */
+    ge_bad[i] = channel_model_trial(
+        (uint32_t)CHANNEL_MODEL_GE_P_GOOD_BAD * 1000
+        / (CHANNEL_MODEL_GE_P_GOOD_BAD + CHANNEL_MODEL_GE_P_BAD_GOOD));
+  } else {
+    while(steps-- > 0) {
+      if(ge_bad[i]) {
+        ge_bad[i] = !channel_model_trial(CHANNEL_MODEL_GE_P_BAD_GOOD);
+      } else {
+        ge_bad[i] = channel_model_trial(CHANNEL_MODEL_GE_P_GOOD_BAD);
+      }
+    }
+  }
+
+  return channel_model_trial(ge_bad[i] ? CHANNEL_MODEL_GE_LOSS_BAD
+                                       : CHANNEL_MODEL_GE_LOSS_GOOD);
+}
+/*---------------------------------------------------------------------------*/
+const struct channel_model_driver channel_model_gilbert_elliott = {
+  "gilbert-elliott",
+  ge_init,
+  ge_drop,
+};
+/*---------------------------------------------------------------------------*/
+static void
+trace_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+trace_drop(const struct channel_model_rx *rx)
+{
+  uint16_t i;
+  uint32_t slot;
+
+  if(rx->channel < MIN_CHANNEL || rx->channel >= MIN_CHANNEL + NUM_CHANNELS) {
+    return 0;
+  }
+
+  slot = trace_period ? rx->slot % trace_period : rx->slot;
+  for(i = 0; i < trace_count && trace[i].start <= slot; i++) {
+    if(slot - trace[i].start < trace[i].duration
+       && (trace[i].channel_mask & (1 << (rx->channel - MIN_CHANNEL)))) {
+      return channel_model_trial(trace[i].loss);
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct channel_model_driver channel_model_trace = {
+  "trace",
+  trace_init,
+  trace_drop,
+};
+/*---------------------------------------------------------------------------*/
+static void
+composite_init(void)
+{
+  channel_model_cells.init();
+  channel_model_trace.init();
+  channel_model_gilbert_elliott.init();
+}
+/*---------------------------------------------------------------------------*/
+static int
+composite_drop(const struct channel_model_rx *rx)
+{
+  /* Evaluate all models so that the PRNG sequence does not depend on
+   * which of them dropped the frame */
+  int drop = channel_model_cells.drop(rx);
+  drop |= channel_model_trace.drop(rx);
+  drop |= channel_model_gilbert_elliott.drop(rx);
+  return drop;
+}
+/*---------------------------------------------------------------------------*/
+const struct channel_model_driver channel_model_composite = {
+  "composite",
+  composite_init,
+  composite_drop,
+};
+/*---------------------------------------------------------------------------*/
+int
+channel_model_drop(uint8_t channel)
+{
+  struct channel_model_rx rx;
+  int drop;
+
+  if(!initialized) {
+    /* Deferred until the first frame, when the node ID is known */
+    channel_model_set_seed(CHANNEL_MODEL_SEED);
+    CHANNEL_MODEL_DRIVER.init();
+    initialized = 1;
+  }
+
+  rx.channel = channel;
+  rx.channel_offset = 0xff;
+#if MAC_CONF_WITH_TSCH
+  if(tsch_is_associated) {
+    uint16_t i;
+    uint16_t len = tsch_hopping_sequence_length.val;
+    struct tsch_asn_divisor_t sf_len;
+
+    TSCH_ASN_DIVISOR_INIT(sf_len, CHANNEL_MODEL_SLOTFRAME_LENGTH);
+    rx.slot = tsch_current_asn.ls4b;
+    rx.timeslot = TSCH_ASN_MOD(tsch_current_asn, sf_len);
+    if(current_link != NULL) {
+      rx.channel_offset = current_link->channel_offset;
+    } else {
+      /* Invert the hopping function channel = seq[(ASN + offset) % len] */
+      for(i = 0; i < len; i++) {
+        if(tsch_hopping_sequence[i] == channel) {
+          rx.channel_offset = (i + len
+              - TSCH_ASN_MOD(tsch_current_asn, tsch_hopping_sequence_length)) % len;
+          break;
+        }
+      }
+    }
+  } else
+#endif /* MAC_CONF_WITH_TSCH */
+  {
+    rx.slot = RTIMER_NOW() / CHANNEL_MODEL_SLOT_DURATION;
+    rx.timeslot = rx.slot % CHANNEL_MODEL_SLOTFRAME_LENGTH;
+  }
+
+  drop = CHANNEL_MODEL_DRIVER.drop(&rx);
+  stats.rx_total++;
+  if(drop) {
+    stats.rx_dropped++;
+  }
+  return drop;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* CHANNEL_MODEL_ENABLED */
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Receiver-side channel model for the Cooja radio.
+ *
+ *         Frames delivered by the simulator can additionally be dropped
+ *         by a deterministic, seeded channel model before the MAC layer
+ *         sees them. This allows experiments with lossy cells, bursty
+ *         links or recorded interference without dedicating simulated
+ *         nodes to generating interference traffic.
+ *
+ *         The model is selected with CHANNEL_MODEL_CONF_DRIVER. When it
+ *         is not set, the radio behaves exactly as without this module.
+ */
+
+#ifndef CHANNEL_MODEL_H_
+#define CHANNEL_MODEL_H_
+
+#include "contiki.h"
+
+/* The channel model driver. Unset (default) disables the channel model. */
+#ifdef CHANNEL_MODEL_CONF_DRIVER
+#define CHANNEL_MODEL_DRIVER CHANNEL_MODEL_CONF_DRIVER
+#define CHANNEL_MODEL_ENABLED 1
+#else
+#define CHANNEL_MODEL_ENABLED 0
+#endif
+
+/* Seed of the channel model PRNG. Combined with the node ID, so that every
+ * node draws an independent but reproducible sequence. */
+#ifdef CHANNEL_MODEL_CONF_SEED
+#define CHANNEL_MODEL_SEED CHANNEL_MODEL_CONF_SEED
+#else
+#define CHANNEL_MODEL_SEED 0x5eed
+#endif
+
+/* Slotframe length used to map absolute slot numbers to timeslots */
+#ifdef CHANNEL_MODEL_CONF_SLOTFRAME_LENGTH
+#define CHANNEL_MODEL_SLOTFRAME_LENGTH CHANNEL_MODEL_CONF_SLOTFRAME_LENGTH
+#elif defined(TSCH_SCHEDULE_CONF_DEFAULT_LENGTH)
+#define CHANNEL_MODEL_SLOTFRAME_LENGTH TSCH_SCHEDULE_CONF_DEFAULT_LENGTH
+#else
+#define CHANNEL_MODEL_SLOTFRAME_LENGTH 7
+#endif
+
+/* Slot duration used for slot numbering when TSCH is not the MAC layer */
+#ifdef CHANNEL_MODEL_CONF_SLOT_DURATION
+#define CHANNEL_MODEL_SLOT_DURATION CHANNEL_MODEL_CONF_SLOT_DURATION
+#else
+#define CHANNEL_MODEL_SLOT_DURATION (RTIMER_SECOND / 100)
+#endif
+
+/* Under TSCH, interpret the channel of loss cells as a channel offset
+ * rather than as a physical channel */
+#ifdef CHANNEL_MODEL_CONF_CELLS_BY_OFFSET
+#define CHANNEL_MODEL_CELLS_BY_OFFSET CHANNEL_MODEL_CONF_CELLS_BY_OFFSET
+#else
+#define CHANNEL_MODEL_CELLS_BY_OFFSET MAC_CONF_WITH_TSCH
+#endif
+
+/* Static loss cells, as an initializer list of struct channel_model_cell */
+#ifdef CHANNEL_MODEL_CONF_CELLS
+#define CHANNEL_MODEL_CELLS CHANNEL_MODEL_CONF_CELLS
+#endif
+
+/* Gilbert-Elliott parameters, all in per mille: transition probabilities
+ * per slot from good to bad and from bad to good, and the loss
+ * probabilities in each state */
+#ifdef CHANNEL_MODEL_CONF_GE_P_GOOD_BAD
+#define CHANNEL_MODEL_GE_P_GOOD_BAD CHANNEL_MODEL_CONF_GE_P_GOOD_BAD
+#else
+#define CHANNEL_MODEL_GE_P_GOOD_BAD 10
+#endif
+
+#ifdef CHANNEL_MODEL_CONF_GE_P_BAD_GOOD
+#define CHANNEL_MODEL_GE_P_BAD_GOOD CHANNEL_MODEL_CONF_GE_P_BAD_GOOD
+#else
+#define CHANNEL_MODEL_GE_P_BAD_GOOD 100
+#endif
+
+#ifdef CHANNEL_MODEL_CONF_GE_LOSS_GOOD
+#define CHANNEL_MODEL_GE_LOSS_GOOD CHANNEL_MODEL_CONF_GE_LOSS_GOOD
+#else
+#define CHANNEL_MODEL_GE_LOSS_GOOD 0
+#endif
+
+#ifdef CHANNEL_MODEL_CONF_GE_LOSS_BAD
+#define CHANNEL_MODEL_GE_LOSS_BAD CHANNEL_MODEL_CONF_GE_LOSS_BAD
+#else
+#define CHANNEL_MODEL_GE_LOSS_BAD 800
+#endif
+
+/* Static interference trace, as an initializer list of
+ * struct channel_model_trace_entry */
+#ifdef CHANNEL_MODEL_CONF_TRACE
+#define CHANNEL_MODEL_TRACE CHANNEL_MODEL_CONF_TRACE
+#endif
+
+/* Period of the interference trace in slots. 0: the trace is played once */
+#ifdef CHANNEL_MODEL_CONF_TRACE_PERIOD
+#define CHANNEL_MODEL_TRACE_PERIOD CHANNEL_MODEL_CONF_TRACE_PERIOD
+#else
+#define CHANNEL_MODEL_TRACE_PERIOD 0
+#endif
+
+/* Matches any timeslot or channel in a loss cell */
+#define CHANNEL_MODEL_ANY 0xffff
+
+/** \brief The context of a received frame, as seen by the channel model */
+struct channel_model_rx {
+  /* Absolute slot number (the ASN under TSCH) */
+  uint32_t slot;
+  /* Slot number modulo CHANNEL_MODEL_SLOTFRAME_LENGTH */
+  uint16_t timeslot;
+  /* Physical channel */
+  uint8_t channel;
+  /* Channel offset under TSCH, 0xff if unknown */
+  uint8_t channel_offset;
+};
+
+/** \brief A cell with a fixed loss probability */
+struct channel_model_cell {
+  uint16_t timeslot;
+  /* Physical channel or, with CHANNEL_MODEL_CELLS_BY_OFFSET, channel offset */
+  uint16_t channel;
+  /* Loss probability in per mille */
+  uint16_t loss;
+};
+
+/** \brief An interference burst: slots [start, start + duration) */
+struct channel_model_trace_entry {
+  uint32_t start;
+  uint16_t duration;
+  /* Bitmap of the affected channels, bit 0 is channel 11 */
+  uint16_t channel_mask;
+  /* Loss probability in per mille */
+  uint16_t loss;
+};
+
+/** \brief Channel model statistics */
+struct channel_model_stats {
+  uint32_t rx_total;
+  uint32_t rx_dropped;
+};
+
+/** \brief The structure of a channel model driver */
+struct channel_model_driver {
+  char *name;
+  /** Initializes the model */
+  void (* init)(void);
+  /** Returns 1 if the frame is lost, 0 otherwise */
+  int (* drop)(const struct channel_model_rx *rx);
+};
+
+extern const struct channel_model_driver channel_model_cells;
+extern const struct channel_model_driver channel_model_gilbert_elliott;
+extern const struct channel_model_driver channel_model_trace;
+/* Applies the cells, trace and Gilbert-Elliott models in that order */
+extern const struct channel_model_driver channel_model_composite;
+
+/**
+ * \brief Decides whether a frame just received by the radio is lost
+ * \param channel The physical channel the frame was received on
+ * \return 1 if the frame must be discarded, 0 otherwise
+ */
+int channel_model_drop(uint8_t channel);
+
+/**
+ * \brief Reseeds the channel model PRNG
+ * \param seed The new seed, combined with the node ID
+ */
+void channel_model_set_seed(uint32_t seed);
+
+/**
+ * \brief Draws a Bernoulli trial from the channel model PRNG
+ * \param per_mille The probability of success, in per mille
+ * \return 1 with probability per_mille / 1000, 0 otherwise
+ */
+int channel_model_trial(uint16_t per_mille);
+
+/**
+ * \brief Replaces the loss cells at runtime
+ * \param cells The loss cells, must remain valid while in use
+ * \param count The number of cells
+ */
+void channel_model_cells_set(const struct channel_model_cell *cells,
+                             uint16_t count);
+
+/**
+ * \brief Replaces the interference trace at runtime
+ * \param trace The trace entries, sorted by start slot, must remain valid
+ * \param count The number of entries
+ * \param period The trace period in slots, 0 to play the trace once
+ */
+void channel_model_trace_set(const struct channel_model_trace_entry *trace,
+                             uint16_t count, uint32_t period);
+
+/**
+ * \brief Returns the channel model statistics
+ */
+const struct channel_model_stats *channel_model_get_stats(void);
+
+#endif /* CHANNEL_MODEL_H_ */
@@ -42,6 +42,7 @@
 
 #include "dev/radio.h"
 #include "dev/cooja-radio.h"
+#include "dev/channel-model.h"
 
 /*
  * The maximum number of bytes this driver can accept from the MAC layer for
@@ -90,6 +91,11 @@ int simRadioChannel = MAX_CHANNEL;
 int simLQI      = LQI_NO_SIGNAL;
 int simLastLQI  = LQI_NO_SIGNAL;
 
+#if CHANNEL_MODEL_ENABLED
+/* Whether the frame in simInDataBuffer has been passed to the channel model */
+static uint8_t sim_in_modelled;
+#endif /* CHANNEL_MODEL_ENABLED */
+
 
 
 static const void *pending_data;
@@ -190,9 +196,24 @@ doInterfaceActionsBeforeTick(void)
   if(simReceiving) {
     simLastSignalStrength = simSignalStrength;
     simLastLQI              = simLQI;
+#if CHANNEL_MODEL_ENABLED
+    sim_in_modelled = 0;
+#endif /* CHANNEL_MODEL_ENABLED */
     return;
   }
 
+#if CHANNEL_MODEL_ENABLED
+  if(simInSize == 0) {
+    sim_in_modelled = 0;
+  } else if(!sim_in_modelled) {
+    sim_in_modelled = 1;
+    if(channel_model_drop(simRadioChannel)) {
+      /* Lost on the simulated channel: discard before the MAC sees it */
+      simInSize = 0;
+    }
+  }
+#endif /* CHANNEL_MODEL_ENABLED */
+
   if(simInSize > 0) {
     process_poll(&cooja_radio_process);
   }
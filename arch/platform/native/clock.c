@@ -43,6 +43,21 @@
 #include <stdlib.h>
 #include <err.h>
 
+#if NATIVE_SIM
+#include "native-sim.h"
+/*---------------------------------------------------------------------------*/
+clock_time_t
+clock_time(void)
+{
+  return native_sim_now() / (1000000 / CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+clock_seconds(void)
+{
+  return native_sim_now() / 1000000;
+}
+#else /* NATIVE_SIM */
 /*---------------------------------------------------------------------------*/
 typedef struct clock_timespec_s {
   time_t  tv_sec;
@@ -92,6 +107,7 @@ clock_seconds(void)
 
   return ts.tv_sec;
 }
+#endif /* NATIVE_SIM */
 /*---------------------------------------------------------------------------*/
 void
 clock_delay(unsigned int d)
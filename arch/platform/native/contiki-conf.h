@@ -61,11 +61,42 @@ typedef unsigned int uip_stats_t;
 #define UIP_CONF_BYTE_ORDER      UIP_LITTLE_ENDIAN
 #endif
 
+#if NATIVE_SIM
+/* Nodes talk over the emulated 802.15.4 medium instead of a tun device */
+#ifndef NETSTACK_CONF_RADIO
+#define NETSTACK_CONF_RADIO   native_sim_radio_driver
+#endif /* NETSTACK_CONF_RADIO */
+
+/* The emulated radio has no hardware ACKs */
+#ifndef CSMA_CONF_SEND_SOFT_ACK
+#define CSMA_CONF_SEND_SOFT_ACK 1
+#endif /* CSMA_CONF_SEND_SOFT_ACK */
+#ifndef CSMA_CONF_ACK_WAIT_TIME
+#define CSMA_CONF_ACK_WAIT_TIME                RTIMER_SECOND / 500
+#endif /* CSMA_CONF_ACK_WAIT_TIME */
+#ifndef CSMA_CONF_AFTER_ACK_DETECTED_WAIT_TIME
+#define CSMA_CONF_AFTER_ACK_DETECTED_WAIT_TIME 0
+#endif /* CSMA_CONF_AFTER_ACK_DETECTED_WAIT_TIME */
+
+/* Use 64-bit rtimer, microsecond ticks on the virtual clock */
+#define RTIMER_CONF_CLOCK_SIZE 8
+
+/* 1 len byte, 2 bytes CRC */
+#define RADIO_PHY_OVERHEAD         3
+/* 250kbps data rate. One byte = 32us */
+#define RADIO_BYTE_AIR_TIME       32
+#define RADIO_DELAY_BEFORE_TX 0
+#define RADIO_DELAY_BEFORE_RX 0
+#define RADIO_DELAY_BEFORE_DETECT 0
+#endif /* NATIVE_SIM */
+
 #if NETSTACK_CONF_WITH_IPV6
 
+#if !NATIVE_SIM
 #ifndef NETSTACK_CONF_NETWORK
 #define NETSTACK_CONF_NETWORK    tun6_net_driver
 #endif
+#endif /* !NATIVE_SIM */
 
 #ifndef NETSTACK_CONF_RADIO
 #define NETSTACK_CONF_RADIO   nullradio_driver
@@ -66,6 +66,11 @@
 
 #include "lib/assert.h"
 #include "lib/csprng.h"
+
+#if NATIVE_SIM
+#include "native-sim.h"
+#include "lib/random.h"
+#endif /* NATIVE_SIM */
 #ifdef __APPLE__
 #include <Security/Security.h>
 #include <Security/SecRandom.h>
@@ -119,11 +124,13 @@
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if !NATIVE_SIM
 #ifdef PLATFORM_CONF_MAC_ADDR
 static uint8_t mac_addr[] = PLATFORM_CONF_MAC_ADDR;
 #else /* PLATFORM_CONF_MAC_ADDR */
 static uint8_t mac_addr[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
 #endif /* PLATFORM_CONF_MAC_ADDR */
+#endif /* !NATIVE_SIM */
 
 /*---------------------------------------------------------------------------*/
 int
@@ -193,7 +200,13 @@ set_lladdr(void)
   linkaddr_t addr;
 
   memset(&addr, 0, sizeof(linkaddr_t));
-#if NETSTACK_CONF_WITH_IPV6
+#if NATIVE_SIM
+  /* Same addressing as Cooja motes, derived from the node ID */
+  for(size_t i = 0; i + 1 < sizeof(addr.u8); i += 2) {
+    addr.u8[i + 1] = native_sim_node_id() & 0xff;
+    addr.u8[i + 0] = native_sim_node_id() >> 8;
+  }
+#elif NETSTACK_CONF_WITH_IPV6
   memcpy(addr.u8, mac_addr, sizeof(addr.u8));
 #else
   int i;
@@ -204,7 +217,7 @@ set_lladdr(void)
   linkaddr_set_node_addr(&addr);
 }
 /*---------------------------------------------------------------------------*/
-#if NETSTACK_CONF_WITH_IPV6
+#if NETSTACK_CONF_WITH_IPV6 && !NATIVE_SIM
 static void
 set_global_address(void)
 {
@@ -237,6 +250,17 @@ platform_init_stage_one()
   button_hal_init();
   leds_init();
   struct csprng_seed seed;
+#if NATIVE_SIM
+  native_sim_init();
+  /* Runs must be reproducible: derive all randomness from the seed */
+  uint32_t x = native_sim_seed() * 2654435761u + native_sim_node_id();
+  for(size_t i = 0; i < CSPRNG_SEED_LEN; i++) {
+    x = x * 1103515245 + 12345;
+    seed.u8[i] = x >> 16;
+  }
+  csprng_feed(&seed);
+  random_init(x >> 16);
+#else /* NATIVE_SIM */
 #ifdef __APPLE__
   if(SecRandomCopyBytes(kSecRandomDefault, CSPRNG_SEED_LEN, seed.u8)
       == errSecSuccess) {
@@ -245,6 +269,7 @@ platform_init_stage_one()
 #endif /* __APPLE__ */
     csprng_feed(&seed);
   }
+#endif /* NATIVE_SIM */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -263,9 +288,10 @@ platform_init_stage_two()
 void
 platform_init_stage_three()
 {
-#if NETSTACK_CONF_WITH_IPV6
+#if NETSTACK_CONF_WITH_IPV6 && !NATIVE_SIM
+  /* Simulated nodes get their addresses from the routing protocol */
   set_global_address();
-#endif /* NETSTACK_CONF_WITH_IPV6 */
+#endif /* NETSTACK_CONF_WITH_IPV6 && !NATIVE_SIM */
 
   /* Make standard output unbuffered. */
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
@@ -277,6 +303,33 @@ platform_main_loop()
 #if SELECT_STDIN
   select_set_callback(STDIN_FILENO, &stdin_fd);
 #endif /* SELECT_STDIN */
+#if NATIVE_SIM
+  while(1) {
+    native_sim_time_t deadline = NATIVE_SIM_TIME_NONE;
+    native_sim_time_t t;
+
+    while(process_run() > 0);
+
+    if(rtimer_arch_check()) {
+      continue;
+    }
+
+    /* Idle: skip virtual time to the next timer or radio event */
+    if(rtimer_arch_pending()) {
+      deadline = rtimer_arch_next();
+    }
+    if(etimer_pending()) {
+      t = (native_sim_time_t)etimer_next_expiration_time()
+        * (1000000 / CLOCK_SECOND);
+      if(t < deadline) {
+        deadline = t;
+      }
+    }
+    native_sim_wait(deadline);
+
+    etimer_request_poll();
+  }
+#else /* NATIVE_SIM */
   while(1) {
     fd_set fdr;
     fd_set fdw;
@@ -315,6 +368,7 @@ platform_main_loop()
 
     etimer_request_poll();
   }
+#endif /* NATIVE_SIM */
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -413,7 +413,7 @@ delete_req_handler(const linkaddr_t *peer_addr,
 
   if((slotframe = tsch_schedule_get_slotframe_by_handle(0)) == NULL ||
      (link = tsch_schedule_get_link_by_offsets(slotframe, timeslot, channel_offset)) == NULL ||
-     memcmp(peer_addr, &link->addr, sizeof(linkaddr_t)) != 0) {
+     memcmp(peer_addr, tsch_schedule_get_link_addr(link), sizeof(linkaddr_t)) != 0) {
     LOG_ERR("Failed to delete a cell [slot:%u]\n", timeslot);
     sixp_output(SIXP_PKT_TYPE_RESPONSE,
                 (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_ERR_BUSY,
@@ -464,7 +464,7 @@ delete_res_handler(const linkaddr_t *peer_addr, sixp_pkt_rc_t rc,
 
   if((slotframe = tsch_schedule_get_slotframe_by_handle(0)) == NULL ||
      (link = tsch_schedule_get_link_by_offsets(slotframe, timeslot, channel_offset)) == NULL ||
-     memcmp(peer_addr, &link->addr, sizeof(linkaddr_t)) != 0 ||
+     memcmp(peer_addr, tsch_schedule_get_link_addr(link), sizeof(linkaddr_t)) != 0 ||
      delete_cell(peer_addr, cell) < 0) {
     LOG_ERR("Failed to delete a cell [slot:%u]\n", timeslot);
   }
@@ -605,7 +605,7 @@ list_req_handler(const linkaddr_t *peer_addr,
   cell_nums = 0;
   for(link = (struct tsch_link *)list_head(slotframe->links_list);
       link != NULL; link = (struct tsch_link *)list_item_next(link)) {
-    if(memcmp(&link->addr, peer_addr, sizeof(linkaddr_t)) == 0 &&
+    if(memcmp(tsch_schedule_get_link_addr(link), peer_addr, sizeof(linkaddr_t)) == 0 &&
        link->link_options == LINK_OPTION_RX) {
       if(cell_list_offset == cell_nums) {
         cell.slot_offset[0] = link->timeslot & 0xff;
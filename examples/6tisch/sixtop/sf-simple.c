@@ -57,7 +57,10 @@ typedef struct {
   uint16_t channel_offset;
 } sf_simple_cell_t;
 
-static const uint16_t slotframe_handle = 0;
+/* Owner of the SF slotframe in the TSCH schedule registry */
+#define SF_SIMPLE_OWNER "sf-simple"
+/* Slotframe handle, allocated from the TSCH schedule registry on first use */
+static uint16_t slotframe_handle = 0xffff;
 static uint8_t res_storage[4 + SF_SIMPLE_MAX_LINKS * 4];
 static uint8_t req_storage[4 + SF_SIMPLE_MAX_LINKS * 4];
 
@@ -89,6 +92,25 @@ static void response_input(sixp_pkt_rc_t rc,
                            const uint8_t *body, uint16_t body_len,
                            const linkaddr_t *peer_addr);
 
+static struct tsch_slotframe *
+get_slotframe(void)
+{
+  struct tsch_slotframe *sf;
+
+  if(slotframe_handle == 0xffff &&
+     !tsch_schedule_allocate_slotframe_handle(SF_SIMPLE_OWNER, &slotframe_handle)) {
+    return NULL;
+  }
+  sf = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  if(sf == NULL) {
+    /* Not created yet, or removed with the rest of the schedule when
+     * associating. Same length as the minimal slotframe, so that the
+     * minimal cell is excluded from the cells this SF negotiates */
+    sf = tsch_schedule_add_slotframe(slotframe_handle, TSCH_SCHEDULE_DEFAULT_LENGTH);
+  }
+  return sf;
+}
+
 /*
  * scheduling policy:
  * add: if and only if all the requested cells are available, accept the request
@@ -126,7 +148,7 @@ add_links_to_schedule(const linkaddr_t *peer_addr, uint8_t link_option,
 
   assert(cell_list != NULL);
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = get_slotframe();
 
   if(slotframe == NULL) {
     return;
@@ -161,7 +183,7 @@ remove_links_to_schedule(const uint8_t *cell_list, uint16_t cell_list_len)
 
   assert(cell_list != NULL);
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = get_slotframe();
 
   if(slotframe == NULL) {
     return;
@@ -259,7 +281,7 @@ add_req_input(const uint8_t *body, uint16_t body_len, const linkaddr_t *peer_add
   print_cell_list(cell_list, cell_list_len);
   PRINTF("\n");
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = get_slotframe();
   if(slotframe == NULL) {
     return;
   }
@@ -273,9 +295,8 @@ add_req_input(const uint8_t *body, uint16_t body_len, const linkaddr_t *peer_add
         i < cell_list_len && feasible_link < num_cells;
         i += sizeof(cell)) {
       read_cell(&cell_list[i], &cell);
-      if(tsch_schedule_get_link_by_offsets(slotframe,
-                                           cell.timeslot_offset,
-                                           cell.channel_offset) == NULL) {
+      if(tsch_schedule_is_cell_free(SF_SIMPLE_OWNER, slotframe,
+                                    cell.timeslot_offset)) {
         sixp_pkt_set_cell_list(SIXP_PKT_TYPE_RESPONSE,
                                (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
                                (uint8_t *)&cell, sizeof(cell),
@@ -335,7 +356,7 @@ delete_req_input(const uint8_t *body, uint16_t body_len,
   print_cell_list(cell_list, cell_list_len);
   PRINTF("\n");
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = get_slotframe();
   if(slotframe == NULL) {
     return;
   }
@@ -469,8 +490,7 @@ int
 sf_simple_add_links(linkaddr_t *peer_addr, uint8_t num_links)
 {
   uint8_t i = 0, index = 0;
-  struct tsch_slotframe *sf =
-    tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  struct tsch_slotframe *sf = get_slotframe();
 
   uint8_t req_len;
   sf_simple_cell_t cell_list[SF_SIMPLE_MAX_LINKS];
@@ -485,7 +505,7 @@ sf_simple_add_links(linkaddr_t *peer_addr, uint8_t num_links)
     /* Randomly select a slot offset within TSCH_SCHEDULE_DEFAULT_LENGTH */
     random_slot = ((random_rand() & 0xFF)) % TSCH_SCHEDULE_DEFAULT_LENGTH;
 
-    if(tsch_schedule_get_link_by_offsets(sf, random_slot, 0) == NULL) {
+    if(tsch_schedule_is_cell_free(SF_SIMPLE_OWNER, sf, random_slot)) {
 
       /* To prevent repeated slots */
       for(i = 0; i < index; i++) {
@@ -565,8 +585,7 @@ int
 sf_simple_remove_links(linkaddr_t *peer_addr)
 {
   uint8_t i = 0, index = 0;
-  struct tsch_slotframe *sf =
-    tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  struct tsch_slotframe *sf = get_slotframe();
   struct tsch_link *l;
 
   uint16_t req_len;
@@ -579,7 +598,7 @@ sf_simple_remove_links(linkaddr_t *peer_addr)
 
     if(l) {
       /* Non-zero value indicates a scheduled link */
-      if((linkaddr_cmp(&l->addr, peer_addr)) && (l->link_options == LINK_OPTION_TX)) {
+      if((linkaddr_cmp(tsch_schedule_get_link_addr(l), peer_addr)) && (l->link_options == LINK_OPTION_TX)) {
         /* This link is scheduled as a TX link to the specified neighbor */
         cell.timeslot_offset = i;
         cell.channel_offset = l->channel_offset;
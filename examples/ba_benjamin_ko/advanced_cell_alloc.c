@@ -13,15 +13,15 @@
 #include "network_interference_cells.h"
 
 #include "advanced_cell_alloc.h"
+#include "services/tsch-cs/tsch-cs.h"
 
 
 static sf_simple_cell_t candidate_cell_list[CAND_CELL_LIST_LEN];
-static CircularBuffer blacklist;
 
 
 void init_advanced_cell_alloc(){
     init_cand_cell_list(candidate_cell_list);
-    init_buffer(&blacklist);
+    tsch_cs_cell_blacklist_clear();
 }
 
 void init_cand_cell_list(sf_simple_cell_t *cell_list){
@@ -80,7 +80,10 @@ void get_candidate_add(sf_simple_cell_t *cell_list){
 
 /* Delete a candidate cell and replace it immediately with a valid cell */
 void replace_candidate_cell(uint16_t timeslot_offset){
-    struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(0);
+    struct tsch_slotframe *sf = sf_simple_get_slotframe();
+    if(sf == NULL) {
+        return;
+    }
     for(int i = 0; i<CAND_CELL_LIST_LEN; i++){
         if(candidate_cell_list[i].timeslot_offset == timeslot_offset){
             uint8_t found_valid_slot = 0;
@@ -94,8 +97,9 @@ void replace_candidate_cell(uint16_t timeslot_offset){
                 if(random_timeslot_offset == 0){
                     random_timeslot_offset++;
                 }
-                if(tsch_schedule_get_link_by_timeslot(sf, random_timeslot_offset) != NULL) {
-                    continue;  
+                /* Skip our own cells and those overlapping other slotframes */
+                if(!tsch_schedule_is_cell_free(SF_SIMPLE_OWNER, sf, random_timeslot_offset)) {
+                    continue;
                 }
                 for(int j = 0; j < CAND_CELL_LIST_LEN; j++) {
                     if(candidate_cell_list[j].timeslot_offset != random_timeslot_offset) {
@@ -109,23 +113,23 @@ void replace_candidate_cell(uint16_t timeslot_offset){
                         break;
                     }
                 }
-                for(int a=0; a<blacklist.count; a++){ /* Check whether cell is in blacklist */
-                    if(random_timeslot_offset == blacklist.buffer[blacklist.head + a].timeslot_offset
-                        && random_channel_offset== blacklist.buffer[blacklist.head + a].channel_offset
-                    ){
-                        break;
-                    }else if(a == blacklist.count -1){ /* Reached the end of the list */
-                        candidate_cell_list[i].timeslot_offset = random_timeslot_offset;
-                        candidate_cell_list[i].channel_offset = random_channel_offset;
-                        found_valid_slot++;
-                    }
-                } 
+                /* An empty blacklist must not stall the search */
+                if(!tsch_cs_cell_is_blacklisted(random_timeslot_offset, random_channel_offset)){
+                    candidate_cell_list[i].timeslot_offset = random_timeslot_offset;
+                    candidate_cell_list[i].channel_offset = random_channel_offset;
+                    found_valid_slot++;
+                }
             }
             return;
         }
     }
 }
 
+uint8_t get_cand_cell_list(const sf_simple_cell_t **cell_list){
+    *cell_list = candidate_cell_list;
+    return CAND_CELL_LIST_LEN;
+}
+
 /* Check cand_cell_list with the cells that are interfered with, emulate the sensing being evaluated */
 uint8_t update_cand_cell_list(){
     uint8_t ret = 0;
@@ -134,7 +138,8 @@ uint8_t update_cand_cell_list(){
             if(candidate_cell_list[i].timeslot_offset == network_interfere_cells[j].timeslot_offset
                 && candidate_cell_list[i].channel_offset == network_interfere_cells[j].channel_offset
             ){
-                push(&blacklist, &(candidate_cell_list[i]));
+                tsch_cs_cell_blacklist_add(candidate_cell_list[i].timeslot_offset,
+                                           candidate_cell_list[i].channel_offset);
                 replace_candidate_cell(candidate_cell_list[i].timeslot_offset);
                 replace_candidate_cell(candidate_cell_list[i + 1].timeslot_offset);
                 ret = 1;
@@ -143,23 +148,3 @@ uint8_t update_cand_cell_list(){
     }
     return ret;
 }
-
-// Initialize the blacklist
-void init_buffer(CircularBuffer *cb) {
-    cb->head = 0;
-    cb->tail = 0;
-    cb->count = 0;
-}
-
-// Add an element to the buffer
-void push(CircularBuffer *cb, sf_simple_cell_t *cell) {
-    if (cb->count == BLACKLIST_MAX_SIZE) {
-        cb->head = (cb->head + 1) % BLACKLIST_MAX_SIZE;
-    } else {
-        cb->count++;
-    }
-    
-    cb->buffer[cb->tail].timeslot_offset = cell->timeslot_offset;
-    cb->buffer[cb->tail].channel_offset = cell->channel_offset;
-    cb->tail = (cb->tail + 1) % BLACKLIST_MAX_SIZE;
-}
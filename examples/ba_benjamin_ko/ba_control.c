@@ -0,0 +1,247 @@
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/sixtop/sixtop.h"
+#include "services/tsch-cs/tsch-cs.h"
+#include "advanced_cell_alloc.h"
+#include "ba_control.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if BUILD_WITH_SHELL
+#include "shell.h"
+#include "shell-commands.h"
+#endif
+#if BUILD_WITH_COAP
+#include "coap-engine.h"
+#endif
+
+#define STATE_MAX_LEN (32 + MAX_ALLOCATE_CELLS * 20 + \
+                       (CAND_CELL_LIST_LEN + TSCH_CS_CELL_BLACKLIST_SIZE) * 8)
+
+clock_time_t ba_housekeeping_period_min = HOUSEKEEPING_PERIOD_MIN;
+clock_time_t ba_housekeeping_period_max = HOUSEKEEPING_PERIOD_MAX;
+
+/* Compact state: one line per section, entries separated by spaces,
+ * fields of a cell separated by ':'
+ *   t=<threshold permille> h=<hk min s>,<hk max s>
+ *   c=<slot>:<channel>:<tx total>:<tx success>:<relevant> ...
+ *   k=<slot>:<channel> ...   (candidate cells)
+ *   b=<slot>:<channel> ...   (blacklist, oldest first) */
+static int
+format_state(char *buf, int size)
+{
+  const tsch_schedule_cell_stats *c;
+  const sf_simple_cell_t *cand;
+  uint8_t cand_len = get_cand_cell_list(&cand);
+  int len;
+  int i;
+
+#define APPEND(...) do { \
+    if(len < size) { \
+      len += snprintf(buf + len, size - len, __VA_ARGS__); \
+    } \
+  } while(0)
+
+  len = 0;
+  APPEND("t=%u h=%lu,%lu\nc=", tsch_stats_get_relocate_thres(),
+         (unsigned long)(ba_housekeeping_period_min / CLOCK_SECOND),
+         (unsigned long)(ba_housekeeping_period_max / CLOCK_SECOND));
+  for(i = 0; (c = tsch_stats_cell_at(i)) != NULL; i++) {
+    APPEND("%s%u:%u:%u:%u:%u", i ? " " : "", c->slotOffset, c->channelOffset,
+           c->tx_total, c->tx_success, c->isStatisticallyRelevant);
+  }
+  APPEND("\nk=");
+  for(i = 0; i < cand_len; i++) {
+    APPEND("%s%u:%u", i ? " " : "", cand[i].timeslot_offset, cand[i].channel_offset);
+  }
+  APPEND("\nb=");
+  for(i = 0; i < tsch_cs_cell_blacklist_count(); i++) {
+    const struct tsch_cs_cell *b = tsch_cs_cell_blacklist_get(i);
+    APPEND("%s%u:%u", i ? " " : "", b->timeslot, b->channel_offset);
+  }
+  APPEND("\n");
+#undef APPEND
+
+  return MIN(len, size - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Sets a knob by name: "thres" (per mille), "hk-min" or "hk-max" (seconds).
+ * Returns 0 on success */
+static int
+set_knob(const char *name, const char *value)
+{
+  char *end;
+  long v = strtol(value, &end, 10);
+
+  if(*end != '\0' || v < 0) {
+    return -1;
+  }
+  /* Bounded before scaling to clock ticks, which would overflow */
+  if(strcmp(name, "thres") && v > HOUSEKEEPING_PERIOD_LIMIT / CLOCK_SECOND) {
+    return -1;
+  }
+  if(!strcmp(name, "thres") && v <= 1000) {
+    tsch_stats_set_relocate_thres(v);
+  } else if(!strcmp(name, "hk-min") && v > 0
+            && (clock_time_t)v * CLOCK_SECOND < ba_housekeeping_period_max) {
+    ba_housekeeping_period_min = (clock_time_t)v * CLOCK_SECOND;
+  } else if(!strcmp(name, "hk-max")
+            && (clock_time_t)v * CLOCK_SECOND > ba_housekeeping_period_min) {
+    ba_housekeeping_period_max = (clock_time_t)v * CLOCK_SECOND;
+  } else {
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+#if BUILD_WITH_SHELL
+static
+PT_THREAD(cmd_ba_state(struct pt *pt, shell_output_func output, char *args))
+{
+  static char buf[STATE_MAX_LEN];
+  int len;
+  int pos;
+
+  PT_BEGIN(pt);
+
+  /* Shell output is formatted in a small buffer, write in chunks */
+  len = format_state(buf, sizeof(buf));
+  for(pos = 0; pos < len; pos += 100) {
+    SHELL_OUTPUT(output, "%.*s", MIN(len - pos, 100), buf + pos);
+  }
+
+  PT_END(pt);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_ba_set(struct pt *pt, shell_output_func output, char *args))
+{
+  char *name;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  name = args;
+  SHELL_ARGS_NEXT(args, next_args);
+  if(name == NULL || args == NULL || set_knob(name, args) != 0) {
+    SHELL_OUTPUT(output, "Usage: ba-set thres|hk-min|hk-max <value>\n");
+    PT_EXIT(pt);
+  }
+  SHELL_OUTPUT(output, "%s set to %s\n", name, args);
+
+  PT_END(pt);
+}
+/*---------------------------------------------------------------------------*/
+static const struct shell_command_t ba_shell_commands[] = {
+  { "ba-state", cmd_ba_state, "'> ba-state': Shows threshold, housekeeping periods, cell stats (t:c:tx:ok:rel), candidates and blacklist" },
+  { "ba-set",   cmd_ba_set,   "'> ba-set thres|hk-min|hk-max <value>': Sets the relocation threshold (per mille) or a housekeeping period (s)" },
+  { NULL, NULL, NULL },
+};
+
+static struct shell_command_set_t ba_shell_command_set = {
+  .next = NULL,
+  .commands = ba_shell_commands,
+};
+#endif /* BUILD_WITH_SHELL */
+/*---------------------------------------------------------------------------*/
+#if BUILD_WITH_COAP
+static void res_get_handler(coap_message_t *request, coap_message_t *response,
+                            uint8_t *buffer, uint16_t preferred_size, int32_t *offset);
+static void res_post_handler(coap_message_t *request, coap_message_t *response,
+                             uint8_t *buffer, uint16_t preferred_size, int32_t *offset);
+static void res_event_handler(void);
+
+EVENT_RESOURCE(res_ba_cells,
+               "title=\"BA cell state\";obs",
+               res_get_handler,
+               res_post_handler,
+               res_post_handler,
+               NULL,
+               res_event_handler);
+
+/* Snapshot taken at offset 0, served block-wise */
+static char state[STATE_MAX_LEN];
+static int state_len;
+
+static void
+res_get_handler(coap_message_t *request, coap_message_t *response,
+                uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  int32_t len;
+
+  if(*offset == 0) {
+    state_len = format_state(state, sizeof(state));
+  }
+  if(*offset >= state_len) {
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+  len = MIN(state_len - *offset, preferred_size);
+  memcpy(buffer, state + *offset, len);
+  coap_set_header_content_format(response, TEXT_PLAIN);
+  coap_set_payload(response, buffer, len);
+  *offset += len;
+  if(*offset >= state_len) {
+    *offset = -1;
+  }
+}
+
+/* POST/PUT thres=<permille>&hk-min=<s>&hk-max=<s>, any subset */
+static void
+res_post_handler(coap_message_t *request, coap_message_t *response,
+                 uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  static const char *knobs[] = { "thres", "hk-min", "hk-max" };
+  char value[8];
+  const char *v;
+  int len;
+  int i;
+
+  for(i = 0; i < sizeof(knobs) / sizeof(knobs[0]); i++) {
+    len = coap_get_post_variable(request, knobs[i], &v);
+    if(len <= 0) {
+      continue;
+    }
+    if(len >= sizeof(value)) {
+      coap_set_status_code(response, BAD_REQUEST_4_00);
+      return;
+    }
+    memcpy(value, v, len);
+    value[len] = '\0';
+    if(set_knob(knobs[i], value) != 0) {
+      coap_set_status_code(response, BAD_REQUEST_4_00);
+      return;
+    }
+  }
+  coap_set_status_code(response, CHANGED_2_04);
+}
+
+static void
+res_event_handler(void)
+{
+  coap_notify_observers(&res_ba_cells);
+}
+#endif /* BUILD_WITH_COAP */
+/*---------------------------------------------------------------------------*/
+void
+ba_control_init(void)
+{
+#if BUILD_WITH_SHELL
+  shell_command_set_register(&ba_shell_command_set);
+#endif
+#if BUILD_WITH_COAP
+  coap_activate_resource(&res_ba_cells, "ba/cells");
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
+ba_control_notify(void)
+{
+#if BUILD_WITH_COAP
+  res_ba_cells.trigger();
+#endif
+}
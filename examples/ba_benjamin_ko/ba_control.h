@@ -0,0 +1,32 @@
+#ifndef BA_CONTROL_H_
+#define BA_CONTROL_H_
+
+#include "contiki.h"
+
+/* Housekeeping runs when slot operation reports enough new transmissions
+ * or a cell turning bad, at least the minimum period apart. Without such
+ * a report, it runs every housekeeping period, which doubles up to the
+ * maximum while nothing gets relocated. Both can be changed at runtime. */
+#ifndef HOUSEKEEPING_PERIOD_MIN
+#define HOUSEKEEPING_PERIOD_MIN (CLOCK_SECOND * 15)
+#endif
+#ifndef HOUSEKEEPING_PERIOD_MAX
+#define HOUSEKEEPING_PERIOD_MAX (CLOCK_SECOND * 240)
+#endif
+
+/* Upper bound of the housekeeping periods, which leaves room to double
+ * them without overflowing clock_time_t */
+#define HOUSEKEEPING_PERIOD_LIMIT ((clock_time_t)-1 / 2)
+
+extern clock_time_t ba_housekeeping_period_min;
+extern clock_time_t ba_housekeeping_period_max;
+
+/* Registers the "ba-*" shell commands and, in builds with CoAP, the
+ * observable "ba/cells" resource: per-cell statistics, candidate cells,
+ * blacklist, relocation threshold and housekeeping periods */
+void ba_control_init(void);
+
+/* Notifies observers of "ba/cells", called after each housekeeping round */
+void ba_control_notify(void);
+
+#endif /* BA_CONTROL_H_ */
@@ -1,6 +1,7 @@
 #include "contiki.h"
 #include "sys/node-id.h"
 #include "sys/log.h"
+#include "sys/metrics.h"
 #include "net/ipv6/uip-ds6-route.h"
 #include "net/mac/tsch/tsch.h"
 #include "net/mac/tsch/sixtop/sixtop.h"
@@ -11,6 +12,7 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include "sf-simple.h"
+#include "network_interference_cells.h"
 #include "project-conf.h"
 #include "net/ipv6/uip-debug.h"
 #include "net/mac/tsch/sixtop/sixp.h"
@@ -22,6 +24,7 @@
 #include "dev/leds.h"
 #include "button-hal.h"
 #include "advanced_cell_alloc.h"
+#include "ba_control.h"
 
 
 #define DEBUG DEBUG_PRINT
@@ -37,7 +40,7 @@
 
 
 #define MAX_NUM_CELLS 100
-#define HOUSEKEEPINGCOLLISION_PERIOD (CLOCK_SECOND * 60)
+#define HOUSEKEEPING_PERIOD_INITIAL (CLOCK_SECOND * 60)
 #define VARIANCE_FACTOR 0.1
 #define SFSIMPLE 
 
@@ -47,6 +50,14 @@ static clock_time_t start_time;
 static int added_num_of_tx_cells = 0;
 static int sixp_add_finished = 0;
 
+/* Experiment results, see tools/metrics */
+METRICS_TIMESTAMP(m_start, "start");
+METRICS_TIMESTAMP(m_cell_added, "cell_added");
+METRICS_COUNTER(m_relocations, "relocations");
+METRICS_GAUGE(m_cells_evaluated, "cells_evaluated");
+METRICS_TIMESTAMP(m_stable, "stable");
+METRICS_GAUGE(m_relocation_time, "relocation_time");
+
 PROCESS(udp_client_process, "UDP server");
 PROCESS(sixp_add_cells_process, "sixp message processor");
 PROCESS(sixp_relocate_cells_process, "sixp message processor");
@@ -114,6 +125,7 @@ PROCESS_THREAD(sixp_add_cells_process, ev, data)
   PROCESS_BEGIN();
   PROCESS_WAIT_EVENT_UNTIL(ev == button_hal_press_event);
   leds_on(LEDS_RED);
+  network_interference_init_channel_model();
   NETSTACK_MAC.on();
   sixtop_add_sf(&sf_simple_driver);
   init_advanced_cell_alloc();
@@ -142,7 +154,10 @@ PROCESS_THREAD(sixp_add_cells_process, ev, data)
   tsch_queue_free_packets_to(tsch_queue_get_nbr_address(n));
 
   start_time = clock_time();
+  metrics_timestamp(&m_start);
+#if BA_PYTHON_LOG
   LOG_INFO("Python: Start time %lus\n", start_time / CLOCK_SECOND);
+#endif
   while(added_num_of_tx_cells < TARGET_CELLS_PER_SLOTFRAME) {
     n = tsch_queue_get_time_source();
     /* Estimate time it would take for cells to elapse to MAX_NUM_CELLS */
@@ -168,6 +183,7 @@ PROCESS_THREAD(sixp_add_cells_process, ev, data)
     tsch_queue_free_packets_to(tsch_queue_get_nbr_address(n));
     sf_simple_add_links(tsch_queue_get_nbr_address(n), 1);
     LOG_INFO("Added the %u cell at %lus\n", added_num_of_tx_cells + 1, clock_time()/CLOCK_SECOND);
+    metrics_timestamp_at(&m_cell_added, added_num_of_tx_cells + 1);
     added_num_of_tx_cells++;
   }
   leds_on(LEDS_GREEN);
@@ -184,8 +200,10 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
   static uint8_t cells_evaluated_static;
   static clock_time_t time_no_relocation[TARGET_CELLS_PER_SLOTFRAME] = { 0 };
   static uint8_t curr_smallest = 0;
+  static clock_time_t housekeeping_period = HOUSEKEEPING_PERIOD_INITIAL;
 
   PROCESS_BEGIN();
+  ba_control_init();
   PROCESS_WAIT_EVENT_UNTIL(ev == button_hal_press_event);
   /* Wait the startup time */
   etimer_set(&et, STARTUP_TIME);
@@ -197,9 +215,16 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
     PROCESS_YIELD_UNTIL(etimer_expired(&et));
   }
 
+  tsch_stats_set_housekeeping_process(PROCESS_CURRENT());
+
   while(1) {
-    etimer_set(&et, HOUSEKEEPINGCOLLISION_PERIOD);
+    /* Leave time for the statistics to build up after the last round */
+    etimer_set(&et, ba_housekeeping_period_min);
     PROCESS_YIELD_UNTIL(etimer_expired(&et));
+    if(!tsch_stats_housekeeping_pending() && housekeeping_period > ba_housekeeping_period_min) {
+      etimer_set(&et, housekeeping_period - ba_housekeeping_period_min);
+      PROCESS_YIELD_UNTIL(etimer_expired(&et) || ev == PROCESS_EVENT_POLL);
+    }
     LOG_INFO("Relocation_process: Relocation process starting\n");
 
     /* Get time-source neighbor */
@@ -209,7 +234,7 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
     uint8_t cand_cells_interfered = 1;
     while(cand_cells_interfered){
       cand_cells_interfered = update_cand_cell_list();
-      printf("SENSING THE CELLS");
+      printf("SENSING THE CELLS\n");
     }
 
     /* Reset rel cell list */
@@ -219,6 +244,7 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
     uint8_t cells_evaluated = tsch_stats_evaluate_cells_for_relocation(cell_rel_list, &cell_rel_list_length);
     /* Workaround to have the value as static */
     cells_evaluated_static = cells_evaluated;
+    metrics_gauge_set(&m_cells_evaluated, cells_evaluated);
 
     etimer_set(&et, CLOCK_SECOND / 50);
     PROCESS_YIELD_UNTIL(etimer_expired(&et));
@@ -256,20 +282,37 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
       LOG_INFO("Relocation_process: Relocating cell with timeslot: %u channel: %u\n", cell_rel_list[i].slotOffset, cell_rel_list[i].channelOffset);
       sf_simple_cell_t cell_to_rel = {cell_rel_list[i].slotOffset, cell_rel_list[i].channelOffset};
       sf_simple_relocate_links(tsch_queue_get_nbr_address(n), 1, &cell_to_rel);
+      metrics_counter_add(&m_relocations, 1);
+    }
+
+    /* Back off while the schedule is stable, react quickly after relocations */
+    if(cell_rel_list_length == 0) {
+      housekeeping_period = housekeeping_period >= ba_housekeeping_period_max / 2
+        ? ba_housekeeping_period_max : housekeeping_period * 2;
+    } else {
+      housekeeping_period = MIN(ba_housekeeping_period_min * 2,
+                                ba_housekeeping_period_max);
     }
+    ba_control_notify();
 
     /* If all cells were evaluated and non are relocated the network is considered stable and the experiment ends */
     if(cells_evaluated_static >= (TARGET_CELLS_PER_SLOTFRAME - 5) && sixp_add_finished == 1 && cell_rel_list_length == 0){
       clock_time_t stop_time = clock_time();
+      metrics_timestamp(&m_stable);
+      time_no_relocation[cells_evaluated_static-1] = stop_time /CLOCK_SECOND;
+      for(int i=0; i<TARGET_CELLS_PER_SLOTFRAME; i++){
+        metrics_gauge_set_at(&m_relocation_time, i, time_no_relocation[i]);
+      }
+#if BA_PYTHON_LOG
       LOG_INFO("Python: All cells %u evaluated and no reloaction to be done anymore time %lus\n", cells_evaluated_static, stop_time / CLOCK_SECOND);
       print_cell_pdr_list();
 
-      time_no_relocation[cells_evaluated_static-1] = stop_time /CLOCK_SECOND;
       printf("Python: relocation times ");
       for(int i=0; i<TARGET_CELLS_PER_SLOTFRAME; i++){
         printf("%ld, ", time_no_relocation[i]);
       }
       printf("\n");
+#endif
       break; 
     }
 
@@ -282,8 +325,9 @@ PROCESS_THREAD(sixp_relocate_cells_process, ev, data)
     PROCESS_YIELD_UNTIL(etimer_expired(&et));
     tsch_stats_delete_cells_pdr_list();
 
-    LOG_INFO("Relocation_process: Relocated %u links with %u added cells and %u evaluated\n", cell_rel_list_length, added_num_of_tx_cells, cells_evaluated_static);
+    LOG_INFO("Relocation_process: Relocated %u links with %u added cells and %u evaluated, next in %lus\n", cell_rel_list_length, added_num_of_tx_cells, cells_evaluated_static, (unsigned long)(housekeeping_period / CLOCK_SECOND));
   }
+  tsch_stats_set_housekeeping_process(NULL);
   leds_on(LEDS_ALL);
 
   PROCESS_END();
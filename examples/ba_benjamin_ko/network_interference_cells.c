@@ -2,6 +2,9 @@
 #include "network_interference_cells.h"
 #include "contiki.h"
 #include "sf-simple.h"
+#if CONTIKI_TARGET_COOJA
+#include "dev/channel-model.h"
+#endif
 
 sf_simple_cell_t network_interfere_cells[40] = {
     {2, 3},
@@ -46,3 +49,18 @@ sf_simple_cell_t network_interfere_cells[40] = {
     {101, 0},
 };
 
+void
+network_interference_init_channel_model(void)
+{
+#if CONTIKI_TARGET_COOJA && CHANNEL_MODEL_ENABLED
+  static struct channel_model_cell cells[INTERFERED_CELLS];
+  int i;
+
+  for(i = 0; i < INTERFERED_CELLS; i++) {
+    cells[i].timeslot = network_interfere_cells[i].timeslot_offset;
+    cells[i].channel = network_interfere_cells[i].channel_offset;
+    cells[i].loss = BA_INTERFERENCE_LOSS;
+  }
+  channel_model_cells_set(cells, INTERFERED_CELLS);
+#endif
+}
@@ -3,4 +3,7 @@
 
 #define INTERFERED_CELLS 40
 
-extern sf_simple_cell_t network_interfere_cells[INTERFERED_CELLS];
\ No newline at end of file
+extern sf_simple_cell_t network_interfere_cells[INTERFERED_CELLS];
+
+/* Installs the interfered cells as loss cells of the Cooja channel model */
+void network_interference_init_channel_model(void);
@@ -15,6 +15,7 @@
 #include "net/linkaddr.h"
 
 #include "sf-simple.h"
+#include "network_interference_cells.h"
 #include "tsch-const.h"
 #include "net/ipv6/uip.h"
 
@@ -111,6 +112,7 @@ PROCESS_THREAD(sixp_process, ev, data)
   if(is_coordinator) {
     NETSTACK_ROUTING.root_start();
   }
+  network_interference_init_channel_model();
   NETSTACK_MAC.on();
   sixtop_add_sf(&sf_simple_driver);
 
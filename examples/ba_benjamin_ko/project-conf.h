@@ -29,6 +29,9 @@
 /* Do not start TSCH at init, wait for NETSTACK_MAC.on() */
 #define TSCH_CONF_AUTOSTART 0
 
+/* Try the channels EBs were last heard on first when re-associating */
+#define TSCH_CONF_SCAN_LEARNED 1
+
 /* 6TiSCH schedule length */
 #define TSCH_SCHEDULE_CONF_DEFAULT_LENGTH 101
 
@@ -44,9 +47,41 @@
 // #define TSCH_CONF_MAX_EB_PERIOD (8 * CLOCK_SECOND)
 
 #define TSCH_SCHEDULE_CONF_MAX_LINKS 90
+/* Compact links: neighbor index instead of full address, packed fields */
+#define TSCH_SCHEDULE_CONF_COMPACT_LINKS 1
+/* Hash-indexed link lookup, 6P add/delete/relocate hit it constantly */
+#define TSCH_SCHEDULE_CONF_WITH_LINK_INDEX 1
 
 #define QUEUEBUF_CONF_NUM 32
 
+/* tsch-cs keeps the cell blacklist of the allocator. The hopping sequence
+ * is not adapted: bad cells are relocated instead */
+#ifndef TSCH_CS_CONF_WITH_CHANNEL_ADAPTATION
+#define TSCH_CS_CONF_WITH_CHANNEL_ADAPTATION 0
+#endif
+
+/* Emulate the interferer node with the Cooja channel model instead:
+ * build with DEFINES=BA_WITH_CHANNEL_MODEL=1 and leave out the network node */
+#if BA_WITH_CHANNEL_MODEL
+#ifndef CHANNEL_MODEL_CONF_DRIVER
+#define CHANNEL_MODEL_CONF_DRIVER channel_model_cells
+#endif
+/* Loss probability of an interfered cell, in per mille */
+#define BA_INTERFERENCE_LOSS 900
+#endif /* BA_WITH_CHANNEL_MODEL */
+
+/* Results are reported with sys/metrics.h, decoded by
+ * tools/metrics/metrics-collector.py */
+#ifndef METRICS_CONF_ENABLED
+#define METRICS_CONF_ENABLED 1
+#endif
+
+/* Set to 1 for the "Python:" lines read by the scripts in logs/ */
+#ifndef BA_PYTHON_LOG
+#define BA_PYTHON_LOG 0
+#endif
+#define TSCH_CONF_LOG_CELL_EVALUATION BA_PYTHON_LOG
+
 #define NETWORK_IDENTIFIER 2
 #define CHILD_IDENTIFIER 1
 #endif /* PROJECT_CONF_H_ */
\ No newline at end of file
@@ -20,7 +20,8 @@
 #define DEBUG DEBUG_PRINT
 #include "net/net-debug.h"
 
-static const uint16_t slotframe_handle = 0;
+/* Slotframe handle, allocated from the TSCH schedule registry on first use */
+static uint16_t slotframe_handle = 0xffff;
 static uint8_t res_storage[4 + SF_SIMPLE_MAX_LINKS * 4];
 static uint8_t req_storage[4 + SF_SIMPLE_MAX_LINKS * 4];
 static sf_simple_cell_t current_cell_to_be_relocated;
@@ -57,6 +58,25 @@ static void sixp_add_request_sent_callback(void *arg, uint16_t arg_len, const li
 static void sixp_relocate_request_sent_callback(void *arg, uint16_t arg_len, const linkaddr_t *dest_addr, sixp_output_status_t status);
 static void timeout(sixp_pkt_cmd_t cmd, const linkaddr_t *peer_addr);
 
+struct tsch_slotframe *
+sf_simple_get_slotframe(void)
+{
+  struct tsch_slotframe *sf;
+
+  if(slotframe_handle == 0xffff &&
+     !tsch_schedule_allocate_slotframe_handle(SF_SIMPLE_OWNER, &slotframe_handle)) {
+    return NULL;
+  }
+  sf = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  if(sf == NULL) {
+    /* Not created yet, or removed with the rest of the schedule when
+     * associating. Same length as the minimal slotframe, so that the
+     * minimal cell is excluded from the cells this SF negotiates */
+    sf = tsch_schedule_add_slotframe(slotframe_handle, TSCH_SCHEDULE_DEFAULT_LENGTH);
+  }
+  return sf;
+}
+
 
 
 static void
@@ -96,7 +116,7 @@ add_links_to_schedule(const linkaddr_t *peer_addr, uint8_t link_option,
 
   assert(cell_list != NULL);
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = sf_simple_get_slotframe();
 
   if(slotframe == NULL) {
     return;
@@ -132,7 +152,7 @@ remove_links_to_schedule(const uint8_t *cell_list, uint16_t cell_list_len)
 
   assert(cell_list != NULL);
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = sf_simple_get_slotframe();
 
   if(slotframe == NULL) {
     return;
@@ -258,7 +278,7 @@ static void add_req_input(const uint8_t *body, uint16_t body_len, const linkaddr
   print_cell_list(cell_list, cell_list_len);
   LOG_INFO("\n");
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = sf_simple_get_slotframe();
   if(slotframe == NULL) {
     return;
   }
@@ -272,9 +292,8 @@ static void add_req_input(const uint8_t *body, uint16_t body_len, const linkaddr
         i < cell_list_len && feasible_link < num_cells;
         i += sizeof(cell)) {
       read_cell(&cell_list[i], &cell);
-      // check whether there is a cell in the timeslot since a node can only have one cell per timeslot
-      if(tsch_schedule_get_link_by_timeslot(slotframe,
-                                           cell.timeslot_offset) == NULL) {
+      // a node can only have one cell per timeslot, and cells of other slotframes (minimal, Orchestra) are excluded
+      if(tsch_schedule_is_cell_free(SF_SIMPLE_OWNER, slotframe, cell.timeslot_offset)) {
         sixp_pkt_set_cell_list(SIXP_PKT_TYPE_RESPONSE,
                                (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
                                (uint8_t *)&cell, sizeof(cell),
@@ -336,7 +355,7 @@ static void delete_req_input(const uint8_t *body, uint16_t body_len,
   print_cell_list(cell_list, cell_list_len);
   PRINTF("\n");
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = sf_simple_get_slotframe();
   if(slotframe == NULL) {
     return;
   }
@@ -411,7 +430,7 @@ static void relocate_req_input(const uint8_t *body, uint16_t body_len, const lin
   print_cell_list(cand_cell_list, cand_cell_list_len);
   PRINTF("\n");
 
-  slotframe = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  slotframe = sf_simple_get_slotframe();
   if(slotframe == NULL) {
     return;
   }
@@ -426,8 +445,8 @@ static void relocate_req_input(const uint8_t *body, uint16_t body_len, const lin
         i < cand_cell_list_len && feasible_link < num_cells;
         i += sizeof(cell)) {
       read_cell(&cand_cell_list[i], &cell);
-      // check whether there is a cell in the timeslot since a node can only have one cell per timeslot
-      if(tsch_schedule_get_link_by_timeslot(slotframe, cell.timeslot_offset) == NULL) {
+      // a node can only have one cell per timeslot, and cells of other slotframes (minimal, Orchestra) are excluded
+      if(tsch_schedule_is_cell_free(SF_SIMPLE_OWNER, slotframe, cell.timeslot_offset)) {
         sixp_pkt_set_cell_list(SIXP_PKT_TYPE_RESPONSE,
                                (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
                                (uint8_t *)&cell, sizeof(cell),
@@ -585,7 +604,7 @@ static void response_input(sixp_pkt_rc_t rc,
 int sf_simple_add_links(linkaddr_t *peer_addr, uint8_t num_links){
   // uint8_t i = 0;
   uint8_t index = 0;
-  struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  struct tsch_slotframe *sf = sf_simple_get_slotframe();
   uint8_t req_len;
   sf_simple_cell_t cell_list[SF_SIMPLE_MAX_LINKS];
 
@@ -702,7 +721,7 @@ int
 sf_simple_remove_links(linkaddr_t *peer_addr)
 {
   uint8_t i = 0, index = 0;
-  struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  struct tsch_slotframe *sf = sf_simple_get_slotframe();
   struct tsch_link *l;
 
   uint16_t req_len;
@@ -715,7 +734,7 @@ sf_simple_remove_links(linkaddr_t *peer_addr)
 
     if(l) {
       /* Non-zero value indicates a scheduled link */
-      if((linkaddr_cmp(&l->addr, peer_addr)) && (l->link_options == LINK_OPTION_TX)) {
+      if((linkaddr_cmp(tsch_schedule_get_link_addr(l), peer_addr)) && (l->link_options == LINK_OPTION_TX)) {
         /* This link is scheduled as a TX link to the specified neighbor */
         cell.timeslot_offset = i;
         cell.channel_offset = l->channel_offset;
@@ -765,7 +784,7 @@ int sf_simple_relocate_links(linkaddr_t *peer_addr, uint8_t num_links, sf_simple
 {
   // uint8_t i = 0;
   uint8_t index = 0;
-  struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(slotframe_handle);
+  struct tsch_slotframe *sf = sf_simple_get_slotframe();
   uint8_t req_len;
   sf_simple_cell_t cand_cell_list[SF_SIMPLE_MAX_LINKS];
   /* Flag to prevent repeated slots */
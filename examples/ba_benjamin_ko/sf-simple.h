@@ -20,10 +20,14 @@ void add_links_to_schedule(const linkaddr_t *peer_addr, uint8_t link_option, con
 int sf_simple_add_links(linkaddr_t *peer_addr, uint8_t num_links);
 int sf_simple_remove_links(linkaddr_t *peer_addr);
 int sf_simple_relocate_links(linkaddr_t *peer_addr, uint8_t num_links, sf_simple_cell_t *cell_to_relocate);
+/* The SF slotframe, created on first use with a handle from the TSCH schedule registry */
+struct tsch_slotframe *sf_simple_get_slotframe(void);
 
 #define SF_SIMPLE_MAX_LINKS  4
 #define SF_SIMPLE_SFID       0xf0
 #define NUMBER_OF_CHANNELS 4
+/* Owner of the SF slotframe in the TSCH schedule registry */
+#define SF_SIMPLE_OWNER      "sf-simple"
 
 extern const sixtop_sf_t sf_simple_driver;
 
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+
+# Runs seeded repetitions of the ba_benjamin_ko experiment in parallel on
+# the native simulator (tools/native-sim) and reports confidence intervals.
+#
+# Every combination of the swept parameters is built once, into its own
+# build directory, with the parameters passed as DEFINES. The runs of all
+# combinations are then spread over the host cores. Metrics are decoded
+# from the child's metric records (tools/metrics) while the runs progress,
+# one CSV row is appended per finished run, and the running aggregates are
+# printed as runs finish.
+
+import argparse
+import csv
+import hashlib
+import importlib.util
+import itertools
+import math
+import os
+import subprocess
+import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+# get the path of this example
+SELF_PATH = os.path.dirname(os.path.abspath(__file__))
+# move three levels up
+CONTIKI_PATH = os.path.dirname(os.path.dirname(os.path.dirname(SELF_PATH)))
+
+BA_PATH = os.path.join(CONTIKI_PATH, "examples", "ba_benjamin_ko")
+SIM_PATH = os.path.join(CONTIKI_PATH, "tools", "native-sim")
+SIM_BINARY = os.path.join(SIM_PATH, "native-sim")
+
+# Node binaries in node ID order: coordinator, child, interferer
+NODES = ["parent", "child", "network"]
+CHILD_ID = 2
+
+METRICS = ["time_to_stable", "relocations", "pdr"]
+
+###########################################
+# Metric records (os/sys/metrics.h)
+
+def load_decoder():
+    path = os.path.join(CONTIKI_PATH, "tools", "metrics", "metrics-collector.py")
+    spec = importlib.util.spec_from_file_location("metrics_collector", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module.Decoder
+
+Decoder = load_decoder()
+
+class RunParser:
+    """Extracts the metrics of one run from the child's records, line by line"""
+
+    def __init__(self):
+        self.decoder = Decoder()
+        self.start_ms = None
+        self.stable_ms = None
+        self.relocations = 0
+        # Latest transmission counters of every evaluated cell
+        self.tx_total = {}
+        self.tx_success = {}
+
+    def feed(self, line):
+        sample = self.decoder.feed(line)
+        if sample is None or sample["node"] != CHILD_ID:
+            return
+        metric = sample["metric"]
+        if metric == "start":
+            self.start_ms = sample["value"]
+        elif metric == "stable":
+            self.stable_ms = sample["value"]
+        elif metric == "relocations":
+            self.relocations = sample["value"]
+        elif metric == "cell_tx_total":
+            self.tx_total[sample["index"]] = sample["value"]
+        elif metric == "cell_tx_success":
+            self.tx_success[sample["index"]] = sample["value"]
+
+    @property
+    def is_stable(self):
+        return self.start_ms is not None and self.stable_ms is not None
+
+    def metrics(self):
+        total = sum(self.tx_total.values())
+        success = sum(self.tx_success.values())
+        return {
+            "time_to_stable": (self.stable_ms - self.start_ms) / 1000 if self.is_stable else None,
+            "relocations": self.relocations,
+            "pdr": success / total if total else None,
+        }
+
+###########################################
+# Streaming aggregation
+
+# Two-sided 95% quantiles of Student's t distribution, by degrees of freedom
+T_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042]
+
+class Aggregate:
+    """Running mean and variance (Welford), no samples kept"""
+
+    def __init__(self):
+        self.n = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+
+    def add(self, x):
+        self.n += 1
+        delta = x - self.mean
+        self.mean += delta / self.n
+        self.m2 += delta * (x - self.mean)
+
+    def ci95(self):
+        if self.n < 2:
+            return float("nan")
+        t = T_95[self.n - 2] if self.n - 2 < len(T_95) else 1.960
+        return t * math.sqrt(self.m2 / (self.n - 1) / self.n)
+
+    def __str__(self):
+        if self.n == 0:
+            return "-"
+        return "{:.3f} +- {:.3f} (n={})".format(self.mean, self.ci95(), self.n)
+
+###########################################
+# Build and run
+
+def config_name(config):
+    if not config:
+        return "default"
+    return ",".join("{}={}".format(k, v) for (k, v) in config)
+
+def build(config, build_dir):
+    args = ["make", "-C", BA_PATH, "-j{}".format(os.cpu_count() or 1),
+            "TARGET=native", "NATIVE_SIM=1", "BUILD_DIR=" + build_dir]
+    if config:
+        args.append("DEFINES=" + ",".join("{}={}".format(k, v) for (k, v) in config))
+    proc = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout)
+        sys.exit("Build failed for {}".format(config_name(config)))
+
+def run(build_dir, seed, args):
+    cmd = [SIM_BINARY, "-t", str(args.duration), "-s", str(seed),
+           "-b", "{}@{}".format(CHILD_ID, args.button)]
+    cmd += [os.path.join(build_dir, "native", n + ".native") for n in NODES]
+    parser = RunParser()
+    log = None
+    if args.logdir:
+        log = open(os.path.join(args.logdir, "{}-seed{}.log".format(
+            os.path.basename(build_dir), seed)), "w")
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                            universal_newlines=True, errors="replace")
+    timer = threading.Timer(args.timeout, proc.kill)
+    timer.start()
+    try:
+        for line in proc.stdout:
+            parser.feed(line.rstrip("\n"))
+            if log:
+                log.write(line)
+        proc.wait()
+    finally:
+        timer.cancel()
+        if log:
+            log.close()
+    return (proc.returncode, parser)
+
+###########################################
+# Run the application
+
+def parse_sweep(sweeps):
+    axes = []
+    for s in sweeps:
+        name, sep, values = s.partition("=")
+        if not sep or not values:
+            sys.exit("Invalid sweep '{}', expected NAME=v1,v2,...".format(s))
+        axes.append([(name, v) for v in values.split(",")])
+    return [tuple(c) for c in itertools.product(*axes)]
+
+def main():
+    ap = argparse.ArgumentParser(description="Seeded parallel runs of the ba_benjamin_ko experiment")
+    ap.add_argument("-n", "--runs", type=int, default=10, help="seeded runs per configuration (default 10)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1, help="parallel runs (default: all cores)")
+    ap.add_argument("-t", "--duration", type=int, default=1200, help="simulated seconds per run (default 1200)")
+    ap.add_argument("-s", "--seed", type=int, default=1, help="seed of the first run (default 1)")
+    ap.add_argument("-b", "--button", type=int, default=10, help="second at which the experiment starts (default 10)")
+    ap.add_argument("--sweep", action="append", default=[], metavar="NAME=v1,v2",
+                    help="parameter to sweep, e.g. RELOCATE_PDRTHRES=0.3,0.5; may be repeated")
+    ap.add_argument("--timeout", type=int, default=3600, help="wall-clock limit per run in seconds")
+    ap.add_argument("--logdir", help="keep the log of every run in this directory")
+    ap.add_argument("-o", "--output", default="results.csv", help="per-run CSV (default results.csv)")
+    args = ap.parse_args()
+
+    configs = parse_sweep(args.sweep)
+
+    subprocess.run(["make", "-C", SIM_PATH], stdout=subprocess.DEVNULL, check=True)
+    if args.logdir:
+        os.makedirs(args.logdir, exist_ok=True)
+
+    build_dirs = {}
+    for config in configs:
+        tag = hashlib.sha1(config_name(config).encode()).hexdigest()[:8]
+        build_dirs[config] = os.path.join(BA_PATH, "build", "sweep-" + tag)
+        print("Building {} in {}".format(config_name(config), build_dirs[config]))
+        build(config, build_dirs[config])
+
+    aggregates = {c: {m: Aggregate() for m in METRICS} for c in configs}
+    unstable = {c: 0 for c in configs}
+
+    with open(args.output, "w", newline="") as f, ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        writer = csv.DictWriter(f, fieldnames=["config", "seed", "exit", "stable"] + METRICS)
+        writer.writeheader()
+
+        futures = {}
+        for config in configs:
+            for seed in range(args.seed, args.seed + args.runs):
+                futures[pool.submit(run, build_dirs[config], seed, args)] = (config, seed)
+
+        for future in as_completed(futures):
+            config, seed = futures[future]
+            retcode, parser = future.result()
+            values = parser.metrics()
+            writer.writerow(dict(config=config_name(config), seed=seed, exit=retcode,
+                                 stable=int(parser.is_stable), **values))
+            f.flush()
+            for m in METRICS:
+                if values[m] is not None:
+                    aggregates[config][m].add(values[m])
+            if not parser.is_stable:
+                unstable[config] += 1
+            print("{} seed {}: {} | time_to_stable so far {}".format(
+                config_name(config), seed,
+                ", ".join("{}={}".format(m, values[m]) for m in METRICS),
+                aggregates[config]["time_to_stable"]))
+
+    print("\nMean +- 95% confidence interval")
+    for config in configs:
+        print(config_name(config))
+        for m in METRICS:
+            print("  {:16} {}".format(m, aggregates[config][m]))
+        if unstable[config]:
+            print("  {} of {} runs did not become stable".format(unstable[config], args.runs))
+
+#######################################################
+
+if __name__ == '__main__':
+    main()
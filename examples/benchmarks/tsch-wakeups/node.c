@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark: wake-ups per second of the TSCH slot operation on a
+ *         sparse 101-slot schedule, with and without lookahead
+ *         (TSCH_SCHEDULE_CONF_LOOKAHEAD).
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/nullnet/nullnet.h"
+#include "net/mac/tsch/tsch.h"
+#include "sys/node-id.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "App"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+#define COORDINATOR_ID 1
+
+PROCESS(node_process, "TSCH wake-ups benchmark");
+AUTOSTART_PROCESSES(&node_process);
+
+/*---------------------------------------------------------------------------*/
+static void
+set_cooja_addr(linkaddr_t *addr, uint16_t id)
+{
+  int j;
+
+  for(j = 0; j < sizeof(*addr); j += 2) {
+    addr->u8[j + 1] = id & 0xff;
+    addr->u8[j + 0] = id >> 8;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+initialize_tsch_schedule(void)
+{
+  struct tsch_slotframe *sf_common = tsch_schedule_add_slotframe(0, BENCH_SLOTFRAME_SIZE);
+  struct tsch_slotframe *sf_unicast = tsch_schedule_add_slotframe(1, BENCH_SLOTFRAME_SIZE);
+  linkaddr_t coordinator;
+  uint16_t i;
+
+  /* Shared cell for EBs and broadcast, that everybody wakes up for */
+  tsch_schedule_add_link(sf_common,
+      LINK_OPTION_RX | LINK_OPTION_TX | LINK_OPTION_SHARED,
+      LINK_TYPE_ADVERTISING, &tsch_broadcast_address, 0, 0, 1);
+
+  /* Dedicated cells towards the coordinator, mostly unused */
+  set_cooja_addr(&coordinator, COORDINATOR_ID);
+  for(i = 1; i <= BENCH_TX_CELLS; i++) {
+    uint16_t timeslot = i * (BENCH_SLOTFRAME_SIZE - 1) / BENCH_TX_CELLS;
+    if(node_id == COORDINATOR_ID) {
+      tsch_schedule_add_link(sf_unicast, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &tsch_broadcast_address, timeslot, 1, 1);
+    } else {
+      tsch_schedule_add_link(sf_unicast, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                             &coordinator, timeslot, 1, 1);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(const void *data, uint16_t len,
+               const linkaddr_t *src, const linkaddr_t *dest)
+{
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(node_process, ev, data)
+{
+  static struct etimer send_timer;
+  static struct etimer report_timer;
+  static uint32_t last_wakeups;
+  static uint32_t last_skipped;
+  static uint32_t seqnum;
+  linkaddr_t coordinator;
+  uint32_t wakeups;
+  uint32_t skipped;
+
+  PROCESS_BEGIN();
+
+  initialize_tsch_schedule();
+  nullnet_set_input_callback(input_callback);
+  if(node_id == COORDINATOR_ID) {
+    tsch_set_coordinator(1);
+  }
+
+  etimer_set(&send_timer, BENCH_SEND_INTERVAL);
+  etimer_set(&report_timer, BENCH_REPORT_INTERVAL);
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&send_timer) || etimer_expired(&report_timer));
+
+    if(etimer_expired(&send_timer)) {
+      if(node_id != COORDINATOR_ID && tsch_is_associated) {
+        seqnum++;
+        nullnet_buf = (uint8_t *)&seqnum;
+        nullnet_len = sizeof(seqnum);
+        set_cooja_addr(&coordinator, COORDINATOR_ID);
+        NETSTACK_NETWORK.output(&coordinator);
+      }
+      etimer_reset(&send_timer);
+    }
+
+    if(etimer_expired(&report_timer)) {
+      /* In hundredths of events per second */
+      wakeups = (tsch_slot_operation_wakeups - last_wakeups)
+        * 100 * CLOCK_SECOND / BENCH_REPORT_INTERVAL;
+      skipped = (tsch_slot_operation_skipped - last_skipped)
+        * 100 * CLOCK_SECOND / BENCH_REPORT_INTERVAL;
+      LOG_INFO("Wake-ups: %lu.%02lu/s, skipped links: %lu.%02lu/s, lookahead %u\n",
+               (unsigned long)(wakeups / 100), (unsigned long)(wakeups % 100),
+               (unsigned long)(skipped / 100), (unsigned long)(skipped % 100),
+               TSCH_SCHEDULE_LOOKAHEAD);
+      last_wakeups = tsch_slot_operation_wakeups;
+      last_skipped = tsch_slot_operation_skipped;
+      etimer_reset(&report_timer);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Microbenchmark of the memory block allocator: scanning pools
+ *         declared with MEMB() against free-list pools declared with
+ *         MEMB_FREE_LIST(). Every pool is filled, then random blocks are
+ *         freed and allocated again, which makes a scan walk half of
+ *         the pool on average. Rounds of free/alloc pairs are repeated
+ *         for at least MEMB_BENCHMARK_DURATION, to suit the resolution
+ *         of the rtimer of the platform.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#ifdef MEMB_BENCHMARK_CONF_ROUNDS
+#define MEMB_BENCHMARK_ROUNDS MEMB_BENCHMARK_CONF_ROUNDS
+#else
+#define MEMB_BENCHMARK_ROUNDS 1000
+#endif
+
+/* Minimum duration of the measurement of a pool, in rtimer ticks */
+#ifdef MEMB_BENCHMARK_CONF_DURATION
+#define MEMB_BENCHMARK_DURATION MEMB_BENCHMARK_CONF_DURATION
+#else
+#define MEMB_BENCHMARK_DURATION (RTIMER_SECOND / 4)
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(memb_benchmark_process, "MEMB benchmark process");
+AUTOSTART_PROCESSES(&memb_benchmark_process);
+/*---------------------------------------------------------------------------*/
+typedef struct {
+  uint8_t payload[24];
+} bench_block_t;
+
+#define BENCH_MAX_BLOCKS 128
+
+MEMB(scan_8, bench_block_t, 8);
+MEMB(scan_32, bench_block_t, 32);
+MEMB(scan_128, bench_block_t, 128);
+MEMB_FREE_LIST(free_list_8, bench_block_t, 8);
+MEMB_FREE_LIST(free_list_32, bench_block_t, 32);
+MEMB_FREE_LIST(free_list_128, bench_block_t, 128);
+
+static struct memb *const pools[] = {
+  &scan_8, &free_list_8, &scan_32, &free_list_32, &scan_128, &free_list_128
+};
+
+static bench_block_t *blocks[BENCH_MAX_BLOCKS];
+/*---------------------------------------------------------------------------*/
+/* Runs free/alloc pairs for at least MEMB_BENCHMARK_DURATION. Returns
+ * the number of rtimer ticks taken and sets the number of pairs, or
+ * returns -1 on an allocator error */
+static long
+run(struct memb *m, unsigned long *pairs)
+{
+  rtimer_clock_t start;
+  unsigned long elapsed;
+  unsigned i;
+  unsigned slot;
+
+  memb_init(m);
+  for(i = 0; i < m->num; i++) {
+    blocks[i] = memb_alloc(m);
+    if(blocks[i] == NULL) {
+      return -1;
+    }
+  }
+  if(memb_alloc(m) != NULL) {
+    return -1;
+  }
+
+  *pairs = 0;
+  start = RTIMER_NOW();
+  do {
+    for(i = 0; i < MEMB_BENCHMARK_ROUNDS; i++) {
+      slot = random_rand() % m->num;
+      if(memb_free(m, blocks[slot]) != 0) {
+        return -1;
+      }
+      blocks[slot] = memb_alloc(m);
+      if(blocks[slot] == NULL) {
+        return -1;
+      }
+    }
+    *pairs += MEMB_BENCHMARK_ROUNDS;
+    elapsed = RTIMER_NOW() - start;
+  } while(elapsed < MEMB_BENCHMARK_DURATION);
+  return (long)elapsed;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_benchmark_process, ev, data)
+{
+  unsigned i;
+  long ticks;
+  unsigned long pairs;
+
+  PROCESS_BEGIN();
+
+  printf("MEMB benchmark: random free/alloc pairs in full pools, %lu rtimer ticks/s\n",
+         (unsigned long)RTIMER_SECOND);
+
+  for(i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+    random_init(0);
+    ticks = run(pools[i], &pairs);
+    if(ticks < 0) {
+      printf("%-9s %3u blocks: FAILED\n",
+             pools[i]->with_free_list ? "free-list" : "scan", pools[i]->num);
+    } else {
+      printf("%-9s %3u blocks: %8lu pairs in %6ld ticks, %lu ns per pair\n",
+             pools[i]->with_free_list ? "free-list" : "scan", pools[i]->num,
+             pairs, ticks,
+             (unsigned long)((unsigned long long)ticks * 1000000000ull
+                             / RTIMER_SECOND / pairs));
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -198,6 +198,9 @@ main(void)
   rtimer_init();
   process_init();
   process_start(&etimer_process, NULL);
+#if LOG_DEFERRED
+  log_deferred_init();
+#endif /* LOG_DEFERRED */
   ctimer_init();
   watchdog_init();
 
@@ -257,8 +260,9 @@ main(void)
 #endif /* BUILD_WITH_RPL_BORDER_ROUTER */
 
 #if BUILD_WITH_ORCHESTRA
-  orchestra_init();
-  LOG_DBG("With Orchestra\n");
+  if(orchestra_init()) {
+    LOG_DBG("With Orchestra\n");
+  }
 #endif /* BUILD_WITH_ORCHESTRA */
 
 #if BUILD_WITH_SHELL
@@ -66,9 +66,9 @@
 
 /*
  * The HEAPMEM_CONF_SEARCH_MAX parameter limits the time spent on
- * chunk allocation and defragmentation. The lower this number is, the
- * faster the operations become. The cost of this speedup, however, is
- * that the space overhead might increase.
+ * searching the best fitting chunk in a size class. The lower this
+ * number is, the faster the operations become. The cost of this
+ * speedup, however, is that the space overhead might increase.
  */
 #ifdef HEAPMEM_CONF_SEARCH_MAX
 #define CHUNK_SEARCH_MAX HEAPMEM_CONF_SEARCH_MAX
@@ -104,6 +104,22 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+/*
+ * The HEAPMEM_CONF_SIZE_CLASSES parameter determines the number of
+ * free lists. Free chunks are binned by size in power-of-two classes:
+ * class i holds the chunks of HEAPMEM_ALIGNMENT * 2^i bytes up to
+ * twice that size, and the last class holds all larger chunks.
+ */
+#ifdef HEAPMEM_CONF_SIZE_CLASSES
+#define HEAPMEM_SIZE_CLASSES HEAPMEM_CONF_SIZE_CLASSES
+#else
+#define HEAPMEM_SIZE_CLASSES 12
+#endif /* HEAPMEM_CONF_SIZE_CLASSES */
+
+/* Free chunks end with a copy of their size, the boundary tag through
+   which the next chunk finds them, so chunks cannot be smaller. */
+#define MIN_CHUNK_SIZE ALIGN(sizeof(size_t))
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
@@ -119,6 +135,8 @@
 
 /* Macros for determining the status of a chunk. */
 #define CHUNK_FLAG_ALLOCATED            0x1
+/* The preceding chunk is free, and ends with a boundary tag. */
+#define CHUNK_FLAG_PREV_FREE            0x2
 
 #define CHUNK_ALLOCATED(chunk)			\
   ((chunk)->flags & CHUNK_FLAG_ALLOCATED)
@@ -141,12 +159,6 @@ struct heapmem_zone {
   size_t allocated;
 };
 
-#ifdef HEAPMEM_CONF_MAX_ZONES
-#define HEAPMEM_MAX_ZONES HEAPMEM_CONF_MAX_ZONES
-#else
-#define HEAPMEM_MAX_ZONES 1
-#endif
-
 #if HEAPMEM_MAX_ZONES < 1
 #error At least one HeapMem zone must be configured.
 #endif
@@ -156,9 +168,9 @@ static struct heapmem_zone zones[HEAPMEM_MAX_ZONES] = {
 };
 
 /*
- * We use a double-linked list of chunks, with a slight space overhead
- * compared to a single-linked list, but with the advantage of having
- * much faster list removals.
+ * We use double-linked lists of free chunks, with a slight space
+ * overhead compared to single-linked lists, but with the advantage of
+ * having much faster list removals.
  */
 typedef struct chunk {
   struct chunk *prev;
@@ -178,11 +190,13 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 static size_t max_heap_usage;
 
-static chunk_t *free_list;
+/* Free chunks, by size class. Adjacent free chunks are always
+   coalesced, and the last chunk of the heap is never free. */
+static chunk_t *free_lists[HEAPMEM_SIZE_CLASSES];
 
 #define IN_HEAP(ptr) ((ptr) != NULL && \
-                     (char *)(ptr) >= (char *)heap_base) && \
-                     ((char *)(ptr) < (char *)heap_base + heap_usage)
+                      (char *)(ptr) >= (char *)heap_base && \
+                      (char *)(ptr) < (char *)heap_base + heap_usage)
 
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
@@ -202,35 +216,78 @@ extend_space(size_t size)
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
-static void
-free_chunk(chunk_t * const chunk)
+/* size_class: Returns the index of the free list of chunks of a
+   given size. */
+static unsigned
+size_class(size_t size)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+  unsigned i = 0;
 
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
-  } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
+  size /= HEAPMEM_ALIGNMENT;
+  while(size > 1 && i < HEAPMEM_SIZE_CLASSES - 1) {
+    size >>= 1;
+    i++;
+  }
+  return i;
+}
+
+/* set_prev_free: Update the flag of the chunk following a chunk that
+   has been freed or allocated, if any. */
+static void
+set_prev_free(chunk_t * const chunk, bool prev_free)
+{
+  if(!IS_LAST_CHUNK(chunk)) {
+    chunk_t *next = NEXT_CHUNK(chunk);
+    if(prev_free) {
+      next->flags |= CHUNK_FLAG_PREV_FREE;
+    } else {
+      next->flags &= ~CHUNK_FLAG_PREV_FREE;
     }
-    free_list = chunk;
   }
 }
 
-/* remove_chunk_from_free_list: Mark a chunk as being allocated, and
-   remove it from the free list. */
+/* prev_chunk: Returns the free chunk that precedes a chunk, found
+   through its boundary tag. */
+static chunk_t *
+prev_chunk(chunk_t * const chunk)
+{
+  size_t prev_size;
+
+  memcpy(&prev_size, (char *)chunk - sizeof(size_t), sizeof(size_t));
+  return (chunk_t *)((char *)chunk - prev_size - sizeof(chunk_t));
+}
+
+/* add_chunk_to_free_list: Mark a chunk as being free, and put it on
+   the free list of its size class. */
+static void
+add_chunk_to_free_list(chunk_t * const chunk)
+{
+  chunk_t **free_list = &free_lists[size_class(chunk->size)];
+
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+  memcpy(GET_PTR(chunk) + chunk->size - sizeof(size_t),
+         &chunk->size, sizeof(size_t));
+  set_prev_free(chunk, true);
+
+  chunk->prev = NULL;
+  chunk->next = *free_list;
+  if(*free_list != NULL) {
+    (*free_list)->prev = chunk;
+  }
+  *free_list = chunk;
+}
+
+/* remove_chunk_from_free_list: Remove a chunk from the free list of
+   its size class, before it is allocated or coalesced. */
 static void
 remove_chunk_from_free_list(chunk_t * const chunk)
 {
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
+  chunk_t **free_list = &free_lists[size_class(chunk->size)];
+
+  if(chunk == *free_list) {
+    *free_list = chunk->next;
+    if(*free_list != NULL) {
+      (*free_list)->prev = NULL;
     }
   } else {
     chunk->prev->next = chunk->next;
@@ -239,6 +296,51 @@ remove_chunk_from_free_list(chunk_t * const chunk)
   if(chunk->next != NULL) {
     chunk->next->prev = chunk->prev;
   }
+
+  set_prev_free(chunk, false);
+}
+
+/* coalesce_next_chunk: Coalesce a chunk with the following chunk, if
+   it is free. */
+static void
+coalesce_next_chunk(chunk_t * const chunk)
+{
+  if(!IS_LAST_CHUNK(chunk)) {
+    chunk_t *next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next)) {
+      LOG_DBG("Coalesce chunk of %zu bytes\n", next->size);
+      remove_chunk_from_free_list(next);
+      chunk->size += sizeof(chunk_t) + next->size;
+    }
+  }
+}
+
+/*
+ * free_chunk: Mark a chunk as being free, coalesce it with the
+ * adjacent free chunks, and put the result on a free list. The chunk
+ * preceding the end of the heap footprint is released instead.
+ */
+static void
+free_chunk(chunk_t *chunk)
+{
+  coalesce_next_chunk(chunk);
+
+  if(chunk->flags & CHUNK_FLAG_PREV_FREE) {
+    chunk_t *prev = prev_chunk(chunk);
+    LOG_DBG("Coalesce chunk of %zu bytes\n", prev->size);
+    remove_chunk_from_free_list(prev);
+    prev->size += sizeof(chunk_t) + chunk->size;
+    /* Keep detecting double frees of the merged chunk. */
+    chunk->flags = 0;
+    chunk = prev;
+  }
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+  } else {
+    add_chunk_to_free_list(chunk);
+  }
 }
 
 /*
@@ -251,58 +353,31 @@ split_chunk(chunk_t * const chunk, size_t offset)
 {
   offset = ALIGN(offset);
 
-  if(offset + sizeof(chunk_t) < chunk->size) {
+  if(offset + sizeof(chunk_t) + MIN_CHUNK_SIZE <= chunk->size) {
     chunk_t *new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
     new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
     new_chunk->flags = 0;
-    free_chunk(new_chunk);
-
     chunk->size = offset;
-    chunk->next = chunk->prev = NULL;
-  }
-}
-
-/* coalesce_chunks: Coalesce a specific free chunk with as many
-   adjacent free chunks as possible. */
-static void
-coalesce_chunks(chunk_t *chunk)
-{
-  for(chunk_t *next = NEXT_CHUNK(chunk);
-      (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
-      next = NEXT_CHUNK(next)) {
-    chunk->size += sizeof(chunk_t) + next->size;
-    LOG_DBG("Coalesce chunk of %zu bytes\n", next->size);
-    remove_chunk_from_free_list(next);
-  }
-}
-
-/* defrag_chunks: Scan the free list for chunks that can be coalesced,
-   and stop within a bounded time. */
-static void
-defrag_chunks(void)
-{
-  /* Limit the time we spend on searching the free list. */
-  int i = CHUNK_SEARCH_MAX;
-  for(chunk_t *chunk = free_list; chunk != NULL; chunk = chunk->next) {
-    if(i-- == 0) {
-      break;
-    }
-    coalesce_chunks(chunk);
+    free_chunk(new_chunk);
   }
 }
 
-/* get_free_chunk: Search the free list for the most suitable chunk,
-   as determined by its size, to satisfy an allocation request. */
+/*
+ * get_free_chunk: Search the free lists for the most suitable chunk,
+ * as determined by its size, to satisfy an allocation request.
+ *
+ * The size class of the request is searched for the smallest chunk
+ * that is large enough, within CHUNK_SEARCH_MAX chunks. Otherwise,
+ * any chunk of the next non-empty class will do.
+ */
 static chunk_t *
 get_free_chunk(const size_t size)
 {
-  /* Defragment chunks only right before they are needed for allocation. */
-  defrag_chunks();
-
+  unsigned bin = size_class(size);
   chunk_t *best = NULL;
   /* Limit the time we spend on searching the free list. */
   int i = CHUNK_SEARCH_MAX;
-  for(chunk_t *chunk = free_list; chunk != NULL; chunk = chunk->next) {
+  for(chunk_t *chunk = free_lists[bin]; chunk != NULL; chunk = chunk->next) {
     if(i-- == 0) {
       break;
     }
@@ -320,6 +395,11 @@ get_free_chunk(const size_t size)
     }
   }
 
+  /* All chunks of the larger classes are large enough. */
+  while(best == NULL && ++bin < HEAPMEM_SIZE_CLASSES) {
+    best = free_lists[bin];
+  }
+
   if(best != NULL) {
     /* We found a chunk that can hold an object of the requested
        allocation size. Split it if possible. */
@@ -373,11 +453,12 @@ heapmem_zone_register(const char *name, size_t zone_size)
  * a pointer to it in case of success, and NULL in case of failure.
  *
  * When allocating memory, heapmem_alloc() will first try to find a
- * free chunk of the same size as the requested one. If none can be
- * found, we pick a larger chunk that is as close in size as possible,
- * and possibly split it so that the remaining part becomes a chunk
- * available for allocation. At most CHUNK_SEARCH_MAX chunks on the
- * free list will be examined.
+ * free chunk of the same size as the requested one in the free list
+ * of its size class. If none can be found, we pick a larger chunk
+ * that is as close in size as possible, or else the first chunk of a
+ * larger size class, and possibly split it so that the remaining part
+ * becomes a chunk available for allocation. At most CHUNK_SEARCH_MAX
+ * chunks of the size class will be examined.
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
@@ -400,6 +481,9 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
   }
 
   size = ALIGN(size);
+  if(size < MIN_CHUNK_SIZE) {
+    size = MIN_CHUNK_SIZE;
+  }
 
   if(sizeof(chunk_t) + size >
      zones[zone].zone_size - zones[zone].allocated) {
@@ -414,9 +498,10 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
       return NULL;
     }
     chunk->size = size;
+    chunk->flags = 0;
   }
 
-  chunk->flags = CHUNK_FLAG_ALLOCATED;
+  chunk->flags |= CHUNK_FLAG_ALLOCATED;
 
 #if HEAPMEM_DEBUG
   chunk->file = file;
@@ -438,9 +523,10 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
  * from heapmem_alloc or heapmem_realloc, without any call to
  * heapmem_free in between.
  *
- * When deallocating a chunk, the chunk will be inserted into the free
- * list. Moreover, all free chunks that are adjacent in memory will be
- * merged into a single chunk in order to mitigate fragmentation.
+ * When deallocating a chunk, the chunk will be merged with the free
+ * chunks that are adjacent in memory in order to mitigate
+ * fragmentation, and the result will be inserted into the free list
+ * of its size class.
  */
 bool
 #if HEAPMEM_DEBUG
@@ -535,42 +621,46 @@ heapmem_realloc(void *ptr, size_t size)
 #endif
 
   size = ALIGN(size);
-  int size_adj = size - chunk->size;
+  if(size < MIN_CHUNK_SIZE) {
+    size = MIN_CHUNK_SIZE;
+  }
+  size_t old_size = chunk->size;
 
-  if(size_adj <= 0) {
+  if(size <= old_size) {
     /* Request to make the object smaller or to keep its size.
        In the former case, the chunk will be split if possible. */
     split_chunk(chunk, size);
-    zones[chunk->zone].allocated += size_adj;
+    zones[chunk->zone].allocated -= old_size - chunk->size;
     return ptr;
   }
 
-  /* Request to make the object larger. (size_adj > 0) */
+  /* Request to make the object larger. */
   if(IS_LAST_CHUNK(chunk)) {
     /*
      * If the object belongs to the last allocated chunk (i.e., the
      * one before the end of the heap footprint, we just attempt to
      * extend the heap.
      */
-    if(extend_space(size_adj) != NULL) {
+    if(extend_space(size - old_size) != NULL) {
       chunk->size = size;
-      zones[chunk->zone].allocated += size_adj;
+      zones[chunk->zone].allocated += size - old_size;
       return ptr;
     }
   } else {
     /*
      * Here we attempt to enlarge an allocated object, whose
      * adjacent space may already be allocated. We attempt to
-     * coalesce chunks in order to make as much room as possible.
+     * coalesce it with the following chunk in order to make room.
      */
-    coalesce_chunks(chunk);
+    coalesce_next_chunk(chunk);
     if(chunk->size >= size) {
       /* There was enough free adjacent space to extend the chunk in
 	 its current place. */
       split_chunk(chunk, size);
-      zones[chunk->zone].allocated += size_adj;
+      zones[chunk->zone].allocated += chunk->size - old_size;
       return ptr;
     }
+    zones[chunk->zone].allocated += chunk->size - old_size;
   }
 
   /*
@@ -585,6 +675,7 @@ heapmem_realloc(void *ptr, size_t size)
   }
 
   memcpy(newptr, ptr, chunk->size);
+  zones[chunk->zone].allocated -= sizeof(chunk_t) + chunk->size;
   free_chunk(chunk);
 
   return newptr;
@@ -614,6 +705,17 @@ heapmem_calloc(size_t nmemb, size_t size)
   return ptr;
 }
 
+/* fragmentation: Returns the percentage of the available memory that
+   is not in the largest chunk that can be allocated. */
+static uint8_t
+fragmentation(size_t available, size_t largest)
+{
+  if(largest >= available) {
+    return 0;
+  }
+  return (uint8_t)((uint32_t)(available - largest) * 100 / available);
+}
+
 /* heapmem_stats: Provides statistics regarding heap memory usage. */
 void
 heapmem_stats(heapmem_stats_t *stats)
@@ -626,15 +728,48 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
       stats->overhead += sizeof(chunk_t);
+      stats->zones[chunk->zone].chunks++;
     } else {
-      coalesce_chunks(chunk);
       stats->available += chunk->size;
+      stats->free_chunks++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
   }
-  stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+
+  /* The space beyond the heap footprint can hold one more chunk. */
+  size_t wilderness = HEAPMEM_ARENA_SIZE - heap_usage;
+  stats->available += wilderness;
+  if(wilderness > sizeof(chunk_t) &&
+     wilderness - sizeof(chunk_t) > stats->largest_free) {
+    stats->largest_free = wilderness - sizeof(chunk_t);
+  }
+
   stats->footprint = heap_usage;
   stats->max_footprint = max_heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
+  stats->fragmentation = fragmentation(stats->available, stats->largest_free);
+
+  /* A zone is limited both by its remaining allocation space and by
+     the free chunks of the heap. */
+  for(heapmem_zone_t i = 0; i < HEAPMEM_MAX_ZONES; i++) {
+    heapmem_zone_stats_t *zone_stats = &stats->zones[i];
+    if(zones[i].name == NULL) {
+      continue;
+    }
+    zone_stats->name = zones[i].name;
+    zone_stats->zone_size = zones[i].zone_size;
+    zone_stats->allocated = zones[i].allocated;
+
+    size_t remaining = 0;
+    if(zones[i].zone_size > zones[i].allocated + sizeof(chunk_t)) {
+      remaining = zones[i].zone_size - zones[i].allocated - sizeof(chunk_t);
+    }
+    zone_stats->largest_free = MIN(remaining, stats->largest_free);
+    zone_stats->fragmentation = fragmentation(remaining,
+                                              zone_stats->largest_free);
+  }
 }
 
 /* heapmem_print_stats: Print all the statistics collected through the
@@ -653,6 +788,20 @@ heapmem_print_debug_info(bool print_chunks)
   HEAPMEM_PRINTF("* Allocated chunks: %zu\n", stats.chunks);
   HEAPMEM_PRINTF("* Chunk size: %zu\n", sizeof(chunk_t));
   HEAPMEM_PRINTF("* Total chunk overhead: %zu\n", stats.overhead);
+  HEAPMEM_PRINTF("* Free chunks: %zu\n", stats.free_chunks);
+  HEAPMEM_PRINTF("* Largest free chunk: %zu\n", stats.largest_free);
+  HEAPMEM_PRINTF("* Fragmentation: %u%%\n", stats.fragmentation);
+
+  for(heapmem_zone_t i = 0; i < HEAPMEM_MAX_ZONES; i++) {
+    if(stats.zones[i].name != NULL) {
+      HEAPMEM_PRINTF("* Zone \"%s\": allocated %zu of %zu in %zu chunks, "
+                     "largest free %zu, fragmentation %u%%\n",
+                     stats.zones[i].name, stats.zones[i].allocated,
+                     stats.zones[i].zone_size, stats.zones[i].chunks,
+                     stats.zones[i].largest_free,
+                     stats.zones[i].fragmentation);
+    }
+  }
 
   if(print_chunks) {
     HEAPMEM_PRINTF("* Allocated chunks:\n");
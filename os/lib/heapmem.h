@@ -41,9 +41,13 @@
  * the HEAPMEM_CONF_ARENA_SIZE parameter.
  *
  * Each allocated memory object is referred to as a "chunk". The
- * allocator manages free chunks in a double-linked list. While this
- * adds some memory overhead compared to a single-linked list, it
- * improves the performance of list management.
+ * allocator manages free chunks in double-linked lists, one per
+ * power-of-two size class, so that a suitable chunk is found without
+ * walking all free chunks. While this adds some memory overhead
+ * compared to a single-linked list, it improves the performance of
+ * list management. Free chunks end with a copy of their size (a
+ * boundary tag), so that a chunk is coalesced with both adjacent free
+ * chunks as soon as it is deallocated.
  *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
@@ -84,6 +88,22 @@
 #define HEAPMEM_DEBUG 0
 #endif
 /*****************************************************************************/
+#ifdef HEAPMEM_CONF_MAX_ZONES
+#define HEAPMEM_MAX_ZONES HEAPMEM_CONF_MAX_ZONES
+#else
+#define HEAPMEM_MAX_ZONES 1
+#endif
+/*****************************************************************************/
+typedef struct heapmem_zone_stats {
+  const char *name;     /* NULL for zones that are not registered. */
+  size_t zone_size;     /* Allocation limit of the zone. */
+  size_t allocated;     /* Allocated bytes, including chunk overhead. */
+  size_t chunks;        /* Allocated chunks. */
+  size_t largest_free;  /* Largest chunk that the zone can allocate. */
+  uint8_t fragmentation; /* Percentage of the remaining space of the
+                            zone that is not in its largest chunk. */
+} heapmem_zone_stats_t;
+
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
@@ -91,6 +111,11 @@ typedef struct heapmem_stats {
   size_t footprint;
   size_t max_footprint;
   size_t chunks;
+  size_t free_chunks;   /* Free chunks within the heap footprint. */
+  size_t largest_free;  /* Largest chunk that can be allocated. */
+  uint8_t fragmentation; /* Percentage of the available memory that
+                            is not in the largest free chunk. */
+  heapmem_zone_stats_t zones[HEAPMEM_MAX_ZONES];
 } heapmem_stats_t;
 /*****************************************************************************/
 typedef uint8_t heapmem_zone_t;
@@ -216,6 +241,11 @@ bool heapmem_free(void *ptr);
  * the amount of memory allocated, overhead used for memory management,
  * and the number of chunks allocated. By using this information, developers
  * can tune their software to use the heapmem allocator more efficiently.
+ *
+ * The fragmentation of the heap, and of every zone, is given as the
+ * share of the available memory that cannot be obtained in a single
+ * allocation: 0 when all of it is contiguous, and close to 100 when it
+ * is scattered over many small free chunks.
  */
 void heapmem_stats(heapmem_stats_t *stats);
 
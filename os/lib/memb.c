@@ -47,12 +47,21 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+/* Get a block from its index */
+static void *
+block_from_index(struct memb *m, int i)
+{
+  return (char *)m->mem + (i * m->size);
+}
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
   memset(m->used, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+  m->free_head = 0;
+  m->num_fresh = 0;
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -60,12 +69,28 @@ memb_alloc(struct memb *m)
 {
   int i;
 
+  if(m->with_free_list) {
+    if(m->free_head != 0) {
+      /* Pop the most recently freed block */
+      i = m->free_head - 1;
+      memcpy(&m->free_head, block_from_index(m, i), sizeof(m->free_head));
+    } else if(m->num_fresh < m->num) {
+      /* Hand out blocks that were never allocated in order, so that
+         they keep their initial contents and no list needs building */
+      i = m->num_fresh++;
+    } else {
+      return NULL;
+    }
+    m->used[i] = true;
+    return block_from_index(m, i);
+  }
+
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       /* If this block was unused, we set the used flag on
 	 and return a pointer to the memory block. */
       m->used[i] = true;
-      return (void *)((char *)m->mem + (i * m->size));
+      return block_from_index(m, i);
     }
   }
 
@@ -78,23 +103,32 @@ int
 memb_free(struct memb *m, void *ptr)
 {
   int i;
-  char *ptr2;
+  size_t offset;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  /* Find the block to which "ptr" points from its offset. It must
+     point to the start of a block. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  i = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  if(m->used[i] == false) {
+    return -1;
+  }
+  m->used[i] = false;
+
+  if(m->with_free_list) {
+    /* Push the block on the free list */
+    memcpy(ptr, &m->free_head, sizeof(m->free_head));
+    m->free_head = i + 1;
   }
-  return -1;
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
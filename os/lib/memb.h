@@ -48,6 +48,12 @@
  * memory by the memb_alloc() function, and are deallocated with the
  * memb_free() function.
  *
+ * Blocks declared with MEMB() are allocated by scanning the pool for
+ * the first unused block. Blocks declared with MEMB_FREE_LIST() are
+ * allocated and deallocated in constant time: never-allocated blocks
+ * are handed out in order, deallocated ones are kept in a free list
+ * threaded through the blocks themselves.
+ *
  * @{
  */
 
@@ -95,11 +101,38 @@ MEMB(connections, struct connection, 16);
                                           CC_CONCAT(name,_memb_used), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
 
+/**
+ * Declare a memory block with constant-time allocation.
+ *
+ * Same as MEMB(), except that memb_alloc() pops the block from a free
+ * list instead of scanning the pool. The free list is threaded through
+ * the first bytes of the deallocated blocks, which are thus overwritten
+ * on memb_free(), and blocks are reused most recently freed first.
+ *
+ * \param name The name of the memory block
+ * \param structure The name of the struct that the memory block holds,
+ * at least as large as an unsigned short
+ * \param num The total number of memory chunks in the block.
+ */
+#define MEMB_FREE_LIST(name, structure, num) \
+        static_assert(sizeof(structure) >= sizeof(unsigned short), \
+                      "MEMB_FREE_LIST blocks must hold an unsigned short"); \
+        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          true, 0, 0}
+
 struct memb {
   unsigned short size;
   unsigned short num;
   bool *used;
   void *mem;
+  /* Free-list state, for pools declared with MEMB_FREE_LIST() */
+  bool with_free_list;
+  unsigned short free_head; /* 1 + index of the first free block, 0 if none */
+  unsigned short num_fresh; /* Number of blocks ever allocated */
 };
 
 /**
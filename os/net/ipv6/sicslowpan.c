@@ -63,6 +63,8 @@
 
 #include "contiki.h"
 #include "dev/watchdog.h"
+#include "lib/list.h"
+#include "lib/memb.h"
 #include "net/link-stats.h"
 #include "net/ipv6/uipopt.h"
 #include "net/ipv6/tcpip.h"
@@ -206,16 +208,17 @@ static uint16_t my_tag;
 
 /* This needs to be defined in NBR / Nodes depending on available RAM   */
 /*   and expected reassembly requirements                               */
+/* The buffers are shared by all reassemblies. A first fragment, which
+ * is stored uncompressed, may take two of them. */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #else
-#define SICSLOWPAN_FRAGMENT_BUFFERS 12
+#define SICSLOWPAN_FRAGMENT_BUFFERS 15
 #endif
 
 /* REASS_CONTEXTS corresponds to the number of simultaneous
- * reassemblies that can be made. NOTE: the first buffer for each
- * reassembly is stored in the context since it can be larger than the
- * rest of the fragments due to header compression.
+ * reassemblies that can be made. A context only holds the state of a
+ * reassembly, the fragments are stored in the shared buffers.
  **/
 #ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
 #define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
@@ -223,6 +226,19 @@ static uint16_t my_tag;
 #define SICSLOWPAN_REASS_CONTEXTS 2
 #endif
 
+/* The number of buckets of the index of the reassembly contexts by
+ * sender and tag. Must be a power of two, larger than 0. */
+#ifdef SICSLOWPAN_CONF_REASS_HASH_SIZE
+#define SICSLOWPAN_REASS_HASH_SIZE SICSLOWPAN_CONF_REASS_HASH_SIZE
+#else
+#define SICSLOWPAN_REASS_HASH_SIZE 8
+#endif
+
+#if SICSLOWPAN_REASS_HASH_SIZE <= 0 || \
+    (SICSLOWPAN_REASS_HASH_SIZE & (SICSLOWPAN_REASS_HASH_SIZE - 1)) != 0
+#error SICSLOWPAN_CONF_REASS_HASH_SIZE must be a power of two, larger than 0
+#endif
+
 /* The size of each fragment (IP payload) for the 6lowpan fragmentation */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_SIZE
 #define SICSLOWPAN_FRAGMENT_SIZE SICSLOWPAN_CONF_FRAGMENT_SIZE
@@ -236,215 +252,304 @@ static uint16_t my_tag;
 #error Too large SICSLOWPAN_FRAGMENT_SIZE set.
 #endif
 
-/* Assuming that the worst growth for uncompression is 38 bytes */
-#define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
+/* One bit per 8-byte unit of a datagram, which fits uip_buf */
+#define SICSLOWPAN_REASS_BITMAP_LEN ((UIP_BUFSIZE + 63) / 64)
+
+struct sicslowpan_frag_buf {
+  struct sicslowpan_frag_buf *next;
+  /* Offset of the data in the datagram, in bytes */
+  uint16_t offset;
+  /* Length of the data */
+  uint8_t len;
+  uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
+};
+
+MEMB_FREE_LIST(frag_bufs, struct sicslowpan_frag_buf, SICSLOWPAN_FRAGMENT_BUFFERS);
 
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
+  /** Next context in the list, ordered by creation, hence by expiration */
+  struct sicslowpan_frag_info *next;
+  /** Next context in the same bucket of the index */
+  struct sicslowpan_frag_info *hash_next;
+  /** The fragments received so far */
+  struct sicslowpan_frag_buf *bufs;
   /** When reassembling, the source address of the fragments being merged */
   linkaddr_t sender;
   /** When reassembling, the tag in the fragments being merged. */
   uint16_t tag;
   /** Total length of the fragmented packet */
   uint16_t len;
-  /** Current length of reassembled fragments */
+  /** Current length of reassembled fragments, without duplicates */
   uint16_t reassembled_len;
-  /** Reassembly %process %timer. */
-  struct timer reass_timer;
-
-  /** Fragment size of first fragment */
-  uint16_t first_frag_len;
-  /** First fragment - needs a larger buffer since the size is uncompressed size
-   and we need to know total size to know when we have received last fragment. */
-  uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+  /** Creation time, the context expires SICSLOWPAN_REASS_MAXAGE / 16 s later */
+  clock_time_t start;
+  /** The 8-byte units of the datagram received so far */
+  uint8_t received[SICSLOWPAN_REASS_BITMAP_LEN];
 };
 
-static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
+MEMB_FREE_LIST(frag_infos, struct sicslowpan_frag_info, SICSLOWPAN_REASS_CONTEXTS);
+LIST(frag_info_list);
+static struct sicslowpan_frag_info *frag_info_hash[SICSLOWPAN_REASS_HASH_SIZE];
+
+/* Fragment forwarding (RFC 8930): a router relays the fragments of
+ * datagrams that are not for itself as they arrive, instead of
+ * reassembling and fragmenting them again. The first fragment is
+ * decompressed and routed, which requires IPHC, and the next hop and
+ * outgoing tag are recorded in a Virtual Reassembly Buffer (VRB) entry
+ * for the fragments that follow. */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING
+#define SICSLOWPAN_FRAG_FORWARDING (SICSLOWPAN_CONF_FRAG_FORWARDING && UIP_CONF_ROUTER \
+                                    && SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC)
+#else
+#define SICSLOWPAN_FRAG_FORWARDING 0
+#endif
 
-struct sicslowpan_frag_buf {
-  /* the index of the frag_info */
-  uint8_t index;
-  /* Fragment offset */
-  uint8_t offset;
-  /* Length of this fragment (if zero this buffer is not allocated) */
-  uint8_t len;
-  uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
+#if SICSLOWPAN_FRAG_FORWARDING
+#if UIP_ND6_SEND_NS && UIP_CONF_IPV6_QUEUE_PKT
+/* A first fragment queued during address resolution would later be sent
+   as a whole datagram */
+#error SICSLOWPAN_CONF_FRAG_FORWARDING does not support UIP_CONF_IPV6_QUEUE_PKT with UIP_CONF_ND6_SEND_NS
+#endif
+
+/* The number of datagrams that can be forwarded simultaneously */
+#ifdef SICSLOWPAN_CONF_VRB_ENTRIES
+#define SICSLOWPAN_VRB_ENTRIES SICSLOWPAN_CONF_VRB_ENTRIES
+#else
+#define SICSLOWPAN_VRB_ENTRIES 4
+#endif
+
+struct sicslowpan_vrb {
+  /** The previous hop of the fragments, and their tag on its link */
+  linkaddr_t sender;
+  uint16_t tag;
+  /** The next hop, linkaddr_null when the fragments are to be discarded */
+  linkaddr_t next_hop;
+  /** The tag of the fragments on the link to the next hop */
+  uint16_t out_tag;
+  /** Datagram size (if zero this entry is not allocated) */
+  uint16_t len;
+  /** Bytes of the datagram forwarded so far */
+  uint16_t forwarded_len;
+  /** Restarted at every fragment. Once expired, the entry can be reused
+      for another datagram, as reassembly contexts. */
+  struct timer timer;
 };
 
-static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
+static struct sicslowpan_vrb vrb[SICSLOWPAN_VRB_ENTRIES];
+
+/** The entry of the first fragment being routed through tcpip_ipv6_output() */
+static struct sicslowpan_vrb *vrb_pending;
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
 /*---------------------------------------------------------------------------*/
-static int
-clear_fragments(uint8_t frag_info_index)
+static struct sicslowpan_frag_info **
+frag_info_bucket(const linkaddr_t *sender, uint16_t tag)
+{
+  return &frag_info_hash[(tag ^ sender->u8[LINKADDR_SIZE - 1]) &
+                         (SICSLOWPAN_REASS_HASH_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static struct sicslowpan_frag_info *
+lookup_fragments(const linkaddr_t *sender, uint16_t tag)
 {
-  int i, clear_count;
-  clear_count = 0;
-  frag_info[frag_info_index].len = 0;
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
-      clear_count++;
+  struct sicslowpan_frag_info *info;
+
+  for(info = *frag_info_bucket(sender, tag); info != NULL; info = info->hash_next) {
+    if(info->tag == tag && linkaddr_cmp(&info->sender, sender)) {
+      return info;
     }
   }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+clear_fragments(struct sicslowpan_frag_info *info)
+{
+  struct sicslowpan_frag_info **prev;
+  struct sicslowpan_frag_buf *buf;
+  int clear_count = 0;
+
+  for(prev = frag_info_bucket(&info->sender, info->tag); *prev != info;
+      prev = &(*prev)->hash_next);
+  *prev = info->hash_next;
+  list_remove(frag_info_list, info);
+
+  while(info->bufs != NULL) {
+    /* deallocate the buffer */
+    buf = info->bufs;
+    info->bufs = buf->next;
+    memb_free(&frag_bufs, buf);
+    clear_count++;
+  }
+  memb_free(&frag_infos, info);
   return clear_count;
 }
 /*---------------------------------------------------------------------------*/
 static int
-timeout_fragments(int not_context)
+timeout_fragments(struct sicslowpan_frag_info *not_context)
 {
-  int i;
+  struct sicslowpan_frag_info *info;
+  struct sicslowpan_frag_info *next;
   int count = 0;
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].len > 0 && i != not_context &&
-       timer_expired(&frag_info[i].reass_timer)) {
+
+  /* Contexts are in order of expiration */
+  for(info = list_head(frag_info_list); info != NULL; info = next) {
+    next = list_item_next(info);
+    if(clock_time() - info->start < SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16) {
+      break;
+    }
+    if(info != not_context) {
       /* This context can be freed */
-      count += clear_fragments(i);
+      count += clear_fragments(info);
     }
   }
   return count;
 }
 /*---------------------------------------------------------------------------*/
-static int
-store_fragment(uint8_t index, uint8_t offset)
+/* Count the units of [first, first + n) already received */
+static unsigned
+count_received(const struct sicslowpan_frag_info *info, unsigned first, unsigned n)
 {
-  int i;
-  int len;
+  unsigned i;
+  unsigned count = 0;
 
-  len = packetbuf_datalen() - packetbuf_hdr_len;
-
-  if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
-    /* Unacceptable fragment size. */
-    return -1;
+  for(i = first; i < first + n; i++) {
+    count += (info->received[i >> 3] >> (i & 7)) & 1;
   }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_received(struct sicslowpan_frag_info *info, unsigned first, unsigned n)
+{
+  unsigned i;
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
-    }
+  for(i = first; i < first + n; i++) {
+    info->received[i >> 3] |= 1 << (i & 7);
   }
-  /* failed */
-  return -1;
 }
 /*---------------------------------------------------------------------------*/
-/* add a new fragment to the buffer */
-static int8_t
-add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+/* Find the reassembly context of a fragment, or start one. Fragments can
+   arrive in any order. Returns NULL if no context is available. */
+static struct sicslowpan_frag_info *
+add_fragment(uint16_t tag, uint16_t frag_size)
 {
-  int i;
-  int len;
-  int8_t found = -1;
-
-  if(offset == 0) {
-    /* This is a first fragment - check if we can add this */
-    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
-
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
-        found = i;
-      }
+  struct sicslowpan_frag_info *info;
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+
+  info = lookup_fragments(sender, tag);
+  if(info != NULL) {
+    if(info->len != frag_size) {
+      LOG_WARN("reassembly: datagram size changed (tag %d: %d -> %d)\n",
+               tag, info->len, frag_size);
+      return NULL;
     }
+    return info;
+  }
 
-    if(found < 0) {
-      LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
-      return -1;
-    }
+  if(frag_size > sizeof(uip_buf)) {
+    LOG_WARN("reassembly: datagram too large (tag %d, len %d)\n", tag, frag_size);
+    return NULL;
+  }
 
-    /* Found a free fragment info to store data in */
-    frag_info[found].len = frag_size;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
-    /* first fragment can not be stored immediately but is moved into
-       the buffer while uncompressing */
-    return found;
-  }
-
-  /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
-    }
+  /* clear all fragment info with expired timer to free all fragment buffers */
+  timeout_fragments(NULL);
+  info = memb_alloc(&frag_infos);
+  if(info == NULL) {
+    LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+    return NULL;
   }
 
-  if(found < 0) {
-    /* no entry found for storing the new fragment */
-    LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+  memset(info, 0, sizeof(*info));
+  info->len = frag_size;
+  info->tag = tag;
+  linkaddr_copy(&info->sender, sender);
+  info->start = clock_time();
+  list_add(frag_info_list, info);
+  info->hash_next = *frag_info_bucket(sender, tag);
+  *frag_info_bucket(sender, tag) = info;
+  return info;
+}
+/*---------------------------------------------------------------------------*/
+/* Store a fragment of the datagram, at offset bytes. The first fragment
+ * is stored from uip_buf, after decompression, and can take two buffers.
+ * Returns the number of bytes stored, 0 for a duplicate fragment, and -1
+ * on error, after which the reassembly is abandoned. */
+static int
+store_fragment(struct sicslowpan_frag_info *info, uint16_t offset,
+               const uint8_t *data, uint16_t len)
+{
+  struct sicslowpan_frag_buf *bufs[2];
+  unsigned first_unit = offset >> 3;
+  unsigned units = (len + 7) >> 3;
+  unsigned received;
+  unsigned count;
+  unsigned i;
+
+  if(len == 0 || (offset & 7) != 0 || offset + len > info->len ||
+     len > sizeof(bufs) / sizeof(bufs[0]) * SICSLOWPAN_FRAGMENT_SIZE) {
+    /* Unacceptable fragment size. */
+    LOG_WARN("reassembly: invalid fragment (tag %d, offset %d, len %d)\n",
+             info->tag, offset, len);
     return -1;
   }
 
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
-    len = store_fragment(i, offset);
+  received = count_received(info, first_unit, units);
+  if(received == units) {
+    LOG_INFO("reassembly: duplicate fragment (tag %d, offset %d)\n", info->tag, offset);
+    return 0;
   }
-  if(len > 0) {
-    frag_info[i].reassembled_len += len;
-    return i;
-  } else {
-    /* should we also clear all fragments since we failed to store
-       this fragment? */
-    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+  if(received > 0) {
+    /* RFC 4944: overlapping fragments discard the datagram */
+    LOG_WARN("reassembly: overlapping fragment (tag %d, offset %d)\n", info->tag, offset);
     return -1;
   }
+
+  count = (len + SICSLOWPAN_FRAGMENT_SIZE - 1) / SICSLOWPAN_FRAGMENT_SIZE;
+  for(i = 0; i < count; i++) {
+    bufs[i] = memb_alloc(&frag_bufs);
+    if(bufs[i] == NULL && timeout_fragments(info) > 0) {
+      bufs[i] = memb_alloc(&frag_bufs);
+    }
+    if(bufs[i] == NULL) {
+      while(i-- > 0) {
+        memb_free(&frag_bufs, bufs[i]);
+      }
+      LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d\n",
+               info->tag);
+      return -1;
+    }
+  }
+
+  for(i = 0; i < count; i++) {
+    /* copy over the data into the fragment buffer,
+       and store offset and len */
+    bufs[i]->offset = offset + i * SICSLOWPAN_FRAGMENT_SIZE;
+    bufs[i]->len = MIN(len - i * SICSLOWPAN_FRAGMENT_SIZE, SICSLOWPAN_FRAGMENT_SIZE);
+    memcpy(bufs[i]->data, data + i * SICSLOWPAN_FRAGMENT_SIZE, bufs[i]->len);
+    bufs[i]->next = info->bufs;
+    info->bufs = bufs[i];
+  }
+  set_received(info, first_unit, units);
+  info->reassembled_len += len;
+  return len;
 }
 /*---------------------------------------------------------------------------*/
 /* Copy all the fragments that are associated with a specific context
    into uip */
-static bool
-copy_frags2uip(int context)
+static void
+copy_frags2uip(struct sicslowpan_frag_info *info)
 {
-  int i;
+  struct sicslowpan_frag_buf *buf;
 
-  /* Check length fields before proceeding. */
-  if(frag_info[context].len < frag_info[context].first_frag_len ||
-     frag_info[context].len > sizeof(uip_buf)) {
-    LOG_WARN("input: invalid total size of fragments\n");
-    clear_fragments(context);
-    return false;
-  }
-
-  /* Copy from the fragment context info buffer first */
-  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].first_frag,
-         frag_info[context].first_frag_len);
-
-  /* Ensure that no previous data is used for reassembly in case of missing fragments. */
-  memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
-         frag_info[context].len - frag_info[context].first_frag_len);
-
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if(((size_t)frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
-        LOG_WARN("input: invalid fragment offset\n");
-        clear_fragments(context);
-        return false;
-      }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
-    }
+  /* Fragments are stored within the datagram without overlap, so all of
+     it is received once the length is reached */
+  for(buf = info->bufs; buf != NULL; buf = buf->next) {
+    memcpy((uint8_t *)UIP_IP_BUF + buf->offset, buf->data, buf->len);
   }
   /* deallocate all the fragments for this context */
-  clear_fragments(context);
-
-  return true;
+  clear_fragments(info);
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
 
@@ -510,6 +615,38 @@ static struct sicslowpan_addr_context
 addr_contexts[SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS];
 #endif
 
+/* The number of entries of the cache of address compression modes,
+ * which saves the context lookups and the comparisons with link-layer
+ * addresses of recent flows. Must be a power of two, 0 disables it. */
+#ifdef SICSLOWPAN_CONF_IPHC_CACHE_SIZE
+#define SICSLOWPAN_IPHC_CACHE_SIZE SICSLOWPAN_CONF_IPHC_CACHE_SIZE
+#else
+#define SICSLOWPAN_IPHC_CACHE_SIZE 0
+#endif
+
+#if SICSLOWPAN_IPHC_CACHE_SIZE < 0 || \
+    (SICSLOWPAN_IPHC_CACHE_SIZE & (SICSLOWPAN_IPHC_CACHE_SIZE - 1)) != 0
+#error SICSLOWPAN_CONF_IPHC_CACHE_SIZE must be 0 or a power of two
+#endif
+
+#if SICSLOWPAN_IPHC_CACHE_SIZE > 0
+/** Address compression of a recent (source, destination, link-layer
+ * receiver) tuple. Flushed when the address contexts are set. */
+struct sicslowpan_iphc_cache_entry {
+  uip_ipaddr_t src;
+  uip_ipaddr_t dst;
+  linkaddr_t receiver;
+  /** The address bits of the second IPHC byte */
+  uint8_t iphc1;
+  /** The context identifier extension */
+  uint8_t cid;
+  uint8_t used;
+};
+
+static struct sicslowpan_iphc_cache_entry
+iphc_cache[SICSLOWPAN_IPHC_CACHE_SIZE];
+#endif /* SICSLOWPAN_IPHC_CACHE_SIZE > 0 */
+
 /** pointer to the byte where to write next inline field. */
 static uint8_t *iphc_ptr;
 
@@ -582,23 +719,178 @@ addr_context_lookup_by_number(uint8_t number)
 }
 /*--------------------------------------------------------------------*/
 static uint8_t
-compress_addr_64(uint8_t bitpos, uip_ipaddr_t *ipaddr,
-    const uip_lladdr_t *lladdr)
+addr_64_mode(const uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr)
 {
   if(uip_is_addr_mac_addr_based(ipaddr, lladdr)) {
-    return 3 << bitpos; /* 0-bits */
+    return 3; /* 0-bits */
   } else if(sicslowpan_is_iid_16_bit_compressable(ipaddr)) {
     /* compress IID to 16 bits xxxx::0000:00ff:fe00:XXXX */
-    memcpy(iphc_ptr, &ipaddr->u16[7], 2);
-    iphc_ptr += 2;
-    return 2 << bitpos; /* 16-bits */
+    return 2; /* 16-bits */
   } else {
     /* do not compress IID => xxxx::IID */
-    memcpy(iphc_ptr, &ipaddr->u16[4], 8);
-    iphc_ptr += 8;
-    return 1 << bitpos; /* 64-bits */
+    return 1; /* 64-bits */
   }
 }
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Select the compression of the addresses of the IPv6 packet in
+ * uip_buf, sent to the link-layer receiver set in packetbuf
+ * \param iphc1 Set to the address bits of the second IPHC byte
+ * \param cid Set to the context identifier extension
+ */
+static void
+compress_addr_modes(uint8_t *iphc1, uint8_t *cid)
+{
+  const linkaddr_t *receiver = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  struct sicslowpan_addr_context *source_context;
+  struct sicslowpan_addr_context *destination_context;
+  uint8_t modes;
+  uint8_t contexts;
+#if SICSLOWPAN_IPHC_CACHE_SIZE > 0
+  struct sicslowpan_iphc_cache_entry *e;
+
+  /* Indexed by destination, which usually determines the receiver */
+  e = &iphc_cache[UIP_IP_BUF->destipaddr.u8[15] &
+                  (SICSLOWPAN_IPHC_CACHE_SIZE - 1)];
+  if(e->used &&
+     uip_ipaddr_cmp(&e->dst, &UIP_IP_BUF->destipaddr) &&
+     uip_ipaddr_cmp(&e->src, &UIP_IP_BUF->srcipaddr) &&
+     linkaddr_cmp(&e->receiver, receiver)) {
+    *iphc1 = e->iphc1;
+    *cid = e->cid;
+    return;
+  }
+#endif /* SICSLOWPAN_IPHC_CACHE_SIZE > 0 */
+
+  modes = 0;
+  contexts = 0;
+
+  /* check if dest context exists (for allocating third byte) */
+  source_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr);
+  destination_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
+  if(source_context || destination_context) {
+    /* set context flag */
+    LOG_DBG("compression: dest or src ipaddr - setting CID\n");
+    modes |= SICSLOWPAN_IPHC_CID;
+  }
+
+  /* source address - cannot be multicast */
+  if(uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr)) {
+    LOG_DBG("compression: addr unspecified - setting SAC\n");
+    modes |= SICSLOWPAN_IPHC_SAC;
+    modes |= SICSLOWPAN_IPHC_SAM_00;
+  } else if(source_context) {
+    /* elide the prefix - indicate by CID and set context + SAC */
+    LOG_DBG("compression: src with context - setting CID & SAC ctx: %d\n",
+           source_context->number);
+    modes |= SICSLOWPAN_IPHC_CID | SICSLOWPAN_IPHC_SAC;
+    contexts |= source_context->number << 4;
+    /* compession compare with this nodes address (source) */
+    modes |= addr_64_mode(&UIP_IP_BUF->srcipaddr, &uip_lladdr)
+      << SICSLOWPAN_IPHC_SAM_BIT;
+    /* No context found for this address */
+  } else if(uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) &&
+            UIP_IP_BUF->destipaddr.u16[1] == 0 &&
+            UIP_IP_BUF->destipaddr.u16[2] == 0 &&
+            UIP_IP_BUF->destipaddr.u16[3] == 0) {
+    modes |= addr_64_mode(&UIP_IP_BUF->srcipaddr, &uip_lladdr)
+      << SICSLOWPAN_IPHC_SAM_BIT;
+  } else {
+    /* send the full address => SAC = 0, SAM = 00 */
+    modes |= SICSLOWPAN_IPHC_SAM_00; /* 128-bits */
+  }
+
+  /* dest address*/
+  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
+    /* Address is multicast, try to compress */
+    modes |= SICSLOWPAN_IPHC_M;
+    if(sicslowpan_is_mcast_addr_compressable8(&UIP_IP_BUF->destipaddr)) {
+      modes |= SICSLOWPAN_IPHC_DAM_11;
+    } else if(sicslowpan_is_mcast_addr_compressable32(&UIP_IP_BUF->destipaddr)) {
+      modes |= SICSLOWPAN_IPHC_DAM_10;
+    } else if(sicslowpan_is_mcast_addr_compressable48(&UIP_IP_BUF->destipaddr)) {
+      modes |= SICSLOWPAN_IPHC_DAM_01;
+    } else {
+      modes |= SICSLOWPAN_IPHC_DAM_00;
+    }
+  } else if(destination_context) {
+    /* elide the prefix */
+    modes |= SICSLOWPAN_IPHC_DAC;
+    contexts |= destination_context->number;
+    /* compession compare with link adress (destination) */
+    modes |= addr_64_mode(&UIP_IP_BUF->destipaddr,
+                           (const uip_lladdr_t *)receiver)
+      << SICSLOWPAN_IPHC_DAM_BIT;
+    /* No context found for this address */
+  } else if(uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) &&
+            UIP_IP_BUF->destipaddr.u16[1] == 0 &&
+            UIP_IP_BUF->destipaddr.u16[2] == 0 &&
+            UIP_IP_BUF->destipaddr.u16[3] == 0) {
+    modes |= addr_64_mode(&UIP_IP_BUF->destipaddr,
+                           (const uip_lladdr_t *)receiver)
+      << SICSLOWPAN_IPHC_DAM_BIT;
+  } else {
+    /* send the full address */
+    modes |= SICSLOWPAN_IPHC_DAM_00; /* 128-bits */
+  }
+
+#if SICSLOWPAN_IPHC_CACHE_SIZE > 0
+  uip_ipaddr_copy(&e->src, &UIP_IP_BUF->srcipaddr);
+  uip_ipaddr_copy(&e->dst, &UIP_IP_BUF->destipaddr);
+  linkaddr_copy(&e->receiver, receiver);
+  e->iphc1 = modes;
+  e->cid = contexts;
+  e->used = 1;
+#endif /* SICSLOWPAN_IPHC_CACHE_SIZE > 0 */
+
+  *iphc1 = modes;
+  *cid = contexts;
+}
+/*--------------------------------------------------------------------*/
+/** \brief write the inline part of an address compressed with the
+ * given SAM or DAM value (in the two lowest bits) */
+static void
+compress_addr_inline(const uip_ipaddr_t *ipaddr, uint8_t mode, int mcast)
+{
+  if(mcast) {
+    switch(mode) {
+    case 3:
+      /* use last byte */
+      *iphc_ptr = ipaddr->u8[15];
+      iphc_ptr += 1;
+      return;
+    case 2:
+      /* second byte + the last three */
+      *iphc_ptr = ipaddr->u8[1];
+      memcpy(iphc_ptr + 1, &ipaddr->u8[13], 3);
+      iphc_ptr += 4;
+      return;
+    case 1:
+      /* second byte + the last five */
+      *iphc_ptr = ipaddr->u8[1];
+      memcpy(iphc_ptr + 1, &ipaddr->u8[11], 5);
+      iphc_ptr += 6;
+      return;
+    }
+  } else {
+    switch(mode) {
+    case 3:
+      /* derived from the link-layer address */
+      return;
+    case 2:
+      memcpy(iphc_ptr, &ipaddr->u16[7], 2);
+      iphc_ptr += 2;
+      return;
+    case 1:
+      memcpy(iphc_ptr, &ipaddr->u16[4], 8);
+      iphc_ptr += 8;
+      return;
+    }
+  }
+  /* full address */
+  memcpy(iphc_ptr, &ipaddr->u8[0], 16);
+  iphc_ptr += 16;
+}
 
 /*-------------------------------------------------------------------- */
 /* Uncompress addresses based on a prefix and a postfix with zeroes in
@@ -724,25 +1016,15 @@ compress_hdr_iphc(void)
    */
 
   iphc0 = SICSLOWPAN_DISPATCH_IPHC;
-  iphc1 = 0;
-  PACKETBUF_IPHC_BUF[2] = 0; /* might not be used - but needs to be cleared */
 
   /*
    * Address handling needs to be made first since it might
-   * cause an extra byte with [ SCI | DCI ]
-   *
+   * cause an extra byte with [ SCI | DCI ]. This sets iphc1 and the
+   * extension byte, which might not be used.
    */
-
-
-  /* check if dest context exists (for allocating third byte) */
-  struct sicslowpan_addr_context *source_context =
-      addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr);
-  struct sicslowpan_addr_context *destination_context =
-      addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
-  if(source_context || destination_context) {
-    /* set context flag and increase iphc_ptr */
-    LOG_DBG("compression: dest or src ipaddr - setting CID\n");
-    iphc1 |= SICSLOWPAN_IPHC_CID;
+  compress_addr_modes(&iphc1, &PACKETBUF_IPHC_BUF[2]);
+  if(iphc1 & SICSLOWPAN_IPHC_CID) {
+    /* increase iphc_ptr for the context identifier extension */
     iphc_ptr++;
   }
 
@@ -826,88 +1108,18 @@ compress_hdr_iphc(void)
       break;
   }
 
-  /* source address - cannot be multicast */
-  if(uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr)) {
-    LOG_DBG("compression: addr unspecified - setting SAC\n");
-    iphc1 |= SICSLOWPAN_IPHC_SAC;
-    iphc1 |= SICSLOWPAN_IPHC_SAM_00;
-  } else if(source_context) {
-    /* elide the prefix - indicate by CID and set context + SAC */
-    LOG_DBG("compression: src with context - setting CID & SAC ctx: %d\n",
-           source_context->number);
-    iphc1 |= SICSLOWPAN_IPHC_CID | SICSLOWPAN_IPHC_SAC;
-    PACKETBUF_IPHC_BUF[2] |= source_context->number << 4;
-    /* compession compare with this nodes address (source) */
-
-    iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_SAM_BIT,
-                              &UIP_IP_BUF->srcipaddr, &uip_lladdr);
-    /* No context found for this address */
-  } else if(uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) &&
-            UIP_IP_BUF->destipaddr.u16[1] == 0 &&
-            UIP_IP_BUF->destipaddr.u16[2] == 0 &&
-            UIP_IP_BUF->destipaddr.u16[3] == 0) {
-    iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_SAM_BIT,
-                              &UIP_IP_BUF->srcipaddr, &uip_lladdr);
-  } else {
-    /* send the full address => SAC = 0, SAM = 00 */
-    iphc1 |= SICSLOWPAN_IPHC_SAM_00; /* 128-bits */
-    memcpy(iphc_ptr, &UIP_IP_BUF->srcipaddr.u16[0], 16);
-    iphc_ptr += 16;
+  /* source address - unless unspecified (SAC = 1, SAM = 00) */
+  if((iphc1 & (SICSLOWPAN_IPHC_SAC | SICSLOWPAN_IPHC_SAM_11)) !=
+     SICSLOWPAN_IPHC_SAC) {
+    compress_addr_inline(&UIP_IP_BUF->srcipaddr,
+                         (iphc1 & SICSLOWPAN_IPHC_SAM_11) >> SICSLOWPAN_IPHC_SAM_BIT,
+                         0);
   }
 
   /* dest address*/
-  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
-    /* Address is multicast, try to compress */
-    iphc1 |= SICSLOWPAN_IPHC_M;
-    if(sicslowpan_is_mcast_addr_compressable8(&UIP_IP_BUF->destipaddr)) {
-      iphc1 |= SICSLOWPAN_IPHC_DAM_11;
-      /* use last byte */
-      *iphc_ptr = UIP_IP_BUF->destipaddr.u8[15];
-      iphc_ptr += 1;
-    } else if(sicslowpan_is_mcast_addr_compressable32(&UIP_IP_BUF->destipaddr)) {
-      iphc1 |= SICSLOWPAN_IPHC_DAM_10;
-      /* second byte + the last three */
-      *iphc_ptr = UIP_IP_BUF->destipaddr.u8[1];
-      memcpy(iphc_ptr + 1, &UIP_IP_BUF->destipaddr.u8[13], 3);
-      iphc_ptr += 4;
-    } else if(sicslowpan_is_mcast_addr_compressable48(&UIP_IP_BUF->destipaddr)) {
-      iphc1 |= SICSLOWPAN_IPHC_DAM_01;
-      /* second byte + the last five */
-      *iphc_ptr = UIP_IP_BUF->destipaddr.u8[1];
-      memcpy(iphc_ptr + 1, &UIP_IP_BUF->destipaddr.u8[11], 5);
-      iphc_ptr += 6;
-    } else {
-      iphc1 |= SICSLOWPAN_IPHC_DAM_00;
-      /* full address */
-      memcpy(iphc_ptr, &UIP_IP_BUF->destipaddr.u8[0], 16);
-      iphc_ptr += 16;
-    }
-  } else {
-    /* Address is unicast, try to compress */
-    if(destination_context) {
-      /* elide the prefix */
-      iphc1 |= SICSLOWPAN_IPHC_DAC;
-      PACKETBUF_IPHC_BUF[2] |= destination_context->number;
-      /* compession compare with link adress (destination) */
-
-      iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_DAM_BIT,
-          &UIP_IP_BUF->destipaddr,
-          (const uip_lladdr_t *)packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
-      /* No context found for this address */
-    } else if(uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) &&
-              UIP_IP_BUF->destipaddr.u16[1] == 0 &&
-              UIP_IP_BUF->destipaddr.u16[2] == 0 &&
-              UIP_IP_BUF->destipaddr.u16[3] == 0) {
-      iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_DAM_BIT,
-          &UIP_IP_BUF->destipaddr,
-          (const uip_lladdr_t *)packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
-    } else {
-      /* send the full address */
-      iphc1 |= SICSLOWPAN_IPHC_DAM_00; /* 128-bits */
-      memcpy(iphc_ptr, &UIP_IP_BUF->destipaddr.u16[0], 16);
-      iphc_ptr += 16;
-    }
-  }
+  compress_addr_inline(&UIP_IP_BUF->destipaddr,
+                       (iphc1 & SICSLOWPAN_IPHC_DAM_11) >> SICSLOWPAN_IPHC_DAM_BIT,
+                       iphc1 & SICSLOWPAN_IPHC_M);
 
   uncomp_hdr_len = UIP_IPH_LEN;
 
@@ -1612,6 +1824,344 @@ fragment_copy_payload_and_send(uint16_t uip_offset)
   return 1;
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
+#if SICSLOWPAN_FRAG_FORWARDING
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Find the forwarding entry of the fragments of a datagram
+ * \param sender The previous hop of the fragments
+ * \param tag The tag of the fragments on the link from the previous hop
+ * \return The entry, or NULL if the datagram is not being forwarded
+ */
+static struct sicslowpan_vrb *
+vrb_lookup(const linkaddr_t *sender, uint16_t tag)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len > 0 && vrb[i].tag == tag &&
+       linkaddr_cmp(&vrb[i].sender, sender)) {
+      return &vrb[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Check, and if update is set process, the options of a Hop-by-Hop
+ * header before forwarding from the first fragment. Only padding and RPL
+ * options are supported, as others may require the whole datagram.
+ * \return false if the options are not supported, or if the routing
+ * protocol rejects the datagram
+ */
+static bool
+vrb_hbh_options(uint8_t *ext_buf, bool update)
+{
+  uint16_t opt_offset = 2; /* 2 first bytes in ext header */
+  struct uip_hbho_hdr *ext_hdr = (struct uip_hbho_hdr *)ext_buf;
+  uint16_t ext_hdr_len = (ext_hdr->len << 3) + 8;
+
+  while(opt_offset + 2 <= ext_hdr_len) { /* + 2 for opt header */
+    struct uip_ext_hdr_opt *opt_hdr = (struct uip_ext_hdr_opt *)(ext_buf + opt_offset);
+    uint16_t opt_len = opt_hdr->len + 2;
+
+    if(opt_hdr->type == UIP_EXT_HDR_OPT_PAD1) {
+      opt_offset += 1;
+      continue;
+    }
+    if(opt_offset + opt_len > ext_hdr_len) {
+      return false;
+    }
+    if(opt_hdr->type == UIP_EXT_HDR_OPT_RPL) {
+      if(update && !NETSTACK_ROUTING.ext_header_hbh_update(ext_buf, opt_offset)) {
+        return false;
+      }
+    } else if(opt_hdr->type != UIP_EXT_HDR_OPT_PADN) {
+      return false;
+    }
+    opt_offset += opt_len;
+  }
+  return true;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Route a datagram from its first fragment, received in packetbuf
+ * with the FRAG1 header already parsed. The headers are decompressed
+ * into uip_buf with the payload of the fragment, updated as uip6.c does
+ * when forwarding, and sent through tcpip_ipv6_output(), which calls
+ * output() where the FRAG1 header is put back.
+ *
+ * Datagrams for this node, and those that uip6.c would not forward as
+ * is (e.g. at the root, which inserts and removes routing headers, or
+ * with other hop-by-hop options than RPL's), are left to reassembly.
+ *
+ * \param tag The tag of the fragment
+ * \param size The size of the datagram
+ * \return true if the fragment was forwarded or discarded, false if
+ * the datagram is to be reassembled
+ */
+static bool
+vrb_forward_first_fragment(uint16_t tag, uint16_t size)
+{
+  struct sicslowpan_vrb *e = NULL;
+  struct uip_routing_hdr *rh;
+  uint8_t *hbh = NULL;
+  uint8_t *next_header;
+  uint8_t protocol;
+  uint8_t hdr_len = packetbuf_hdr_len;
+  int i;
+
+  if(NETSTACK_ROUTING.node_is_root() || size > UIP_LINK_MTU ||
+     lookup_fragments(packetbuf_addr(PACKETBUF_ADDR_SENDER), tag) != NULL) {
+    /* Also when fragments arrived before the first one */
+    return false;
+  }
+
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len > 0 && vrb[i].tag == tag &&
+       linkaddr_cmp(&vrb[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      /* The first fragment was sent again: start over */
+      vrb[i].len = 0;
+    }
+    if(e == NULL && (vrb[i].len == 0 || timer_expired(&vrb[i].timer))) {
+      e = &vrb[i];
+    }
+  }
+  if(e == NULL) {
+    LOG_WARN("forwarding: no free entry, reassembling (tag %d)\n", tag);
+    return false;
+  }
+
+  curr_page = 0;
+  digest_paging_dispatch();
+  if(curr_page == 1) {
+    digest_6lorh_hdr();
+  }
+  if(curr_page > 1 ||
+     (PACKETBUF_6LO_PTR[PACKETBUF_6LO_DISPATCH] & SICSLOWPAN_DISPATCH_IPHC_MASK) != SICSLOWPAN_DISPATCH_IPHC ||
+     uncompress_hdr_iphc((uint8_t *)UIP_IP_BUF, UIP_BUFSIZE, size) == false ||
+     packetbuf_datalen() < packetbuf_hdr_len) {
+    goto reassemble;
+  }
+  packetbuf_payload_len = packetbuf_datalen() - packetbuf_hdr_len;
+  if(uncomp_hdr_len + packetbuf_payload_len >= size ||
+     uncomp_hdr_len + packetbuf_payload_len > sizeof(uip_buf)) {
+    goto reassemble;
+  }
+  memcpy((uint8_t *)UIP_IP_BUF + uncomp_hdr_len, packetbuf_ptr + packetbuf_hdr_len,
+         packetbuf_payload_len);
+  uip_len = uncomp_hdr_len + packetbuf_payload_len;
+
+  /* The same conditions as in uip6.c for forwarding, except that errors
+     are left to reassembly, which reports them */
+  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_loopback(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr) ||
+     UIP_IP_BUF->ttl <= 1) {
+    goto reassemble;
+  }
+
+  next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
+  if(next_header != NULL && protocol == UIP_PROTO_HBHO) {
+    if(!vrb_hbh_options(next_header, false)) {
+      goto reassemble;
+    }
+    hbh = next_header;
+  }
+
+  if(uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr)) {
+    /* Forward only as an intermediate hop of a source route */
+    rh = (struct uip_routing_hdr *)uipbuf_search_header(uip_buf, uip_len, UIP_PROTO_ROUTING);
+    if(rh == NULL || rh->seg_left == 0 ||
+       !NETSTACK_ROUTING.ext_header_srh_update() ||
+       uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr) ||
+       uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+       uip_is_addr_unspecified(&UIP_IP_BUF->destipaddr) ||
+       uip_is_addr_loopback(&UIP_IP_BUF->destipaddr)) {
+      goto reassemble;
+    }
+  }
+
+  /* The datagram is forwarded from here on */
+  linkaddr_copy(&e->sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  linkaddr_copy(&e->next_hop, &linkaddr_null);
+  e->tag = tag;
+  e->out_tag = my_tag++;
+  e->len = size;
+  e->forwarded_len = uip_len;
+  timer_set(&e->timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+  if(hbh != NULL && !vrb_hbh_options(hbh, true)) {
+    /* Discard the fragments, the next hop is left null */
+    LOG_ERR("forwarding: RPL option error, dropping datagram (tag %d)\n", tag);
+    uipbuf_clear();
+    return true;
+  }
+  UIP_IP_BUF->ttl--;
+  UIP_STAT(++uip_stat.ip.forwarded);
+
+  LOG_INFO("forwarding: datagram (tag %d -> %d, len %d) to ", tag, e->out_tag, size);
+  LOG_INFO_6ADDR(&UIP_IP_BUF->destipaddr);
+  LOG_INFO_("\n");
+
+#if LLSEC802154_USES_AUX_HEADER
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_LEVEL,
+    packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL));
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_KEY_ID,
+    packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX));
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /*  LLSEC802154_USES_AUX_HEADER */
+
+  /* output() sends the first fragment and sets the next hop of the entry.
+     If it is not called, e.g. without route, the fragments are discarded. */
+  vrb_pending = e;
+  tcpip_ipv6_output();
+  vrb_pending = NULL;
+  return true;
+
+ reassemble:
+  packetbuf_hdr_len = hdr_len;
+  uncomp_hdr_len = 0;
+  uip_len = 0;
+  return false;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Send the first fragment of a forwarded datagram, from output(),
+ * once its headers are compressed in packetbuf. The fragments keep the
+ * size of the datagram and the offsets of the received ones, so that
+ * the following fragments can be relayed as is. When the headers compress
+ * less than at the previous hop, e.g. addresses that were elided because
+ * derived from its link-layer address, the payload that does not fit is
+ * sent in an additional FRAGN fragment.
+ * \param e The entry of the datagram
+ * \param localdest The link-layer address of the next hop
+ * \return 1 if success, 0 otherwise
+ */
+static uint8_t
+vrb_output_first_fragment(struct sicslowpan_vrb *e, const linkaddr_t *localdest)
+{
+  int frag1_payload;
+  uint16_t processed_ip_out_len;
+
+  if(uip_len != e->forwarded_len || uip_len < uncomp_hdr_len) {
+    LOG_WARN("forwarding: headers changed size, dropping datagram (tag %d)\n", e->tag);
+    return 0;
+  }
+
+  /* The first fragment must end at a multiple of 8 bytes */
+  frag1_payload = ((mac_max_payload - packetbuf_hdr_len - SICSLOWPAN_FRAG1_HDR_LEN
+                    + uncomp_hdr_len) & 0xfffffff8) - uncomp_hdr_len;
+  if(frag1_payload < 0) {
+    LOG_WARN("forwarding: compressed header does not fit first fragment (tag %d)\n", e->tag);
+    return 0;
+  }
+  packetbuf_payload_len = MIN(uip_len - uncomp_hdr_len, frag1_payload);
+
+  /* Move IPHC header to make room for FRAG1 header */
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | e->len));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, e->out_tag);
+
+  last_tx_status = MAC_TX_OK;
+  if(fragment_copy_payload_and_send(uncomp_hdr_len) == 0) {
+    return 0;
+  }
+
+  processed_ip_out_len = uncomp_hdr_len + packetbuf_payload_len;
+  if(processed_ip_out_len < uip_len) {
+    packetbuf_hdr_len = SICSLOWPAN_FRAGN_HDR_LEN;
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+          ((SICSLOWPAN_DISPATCH_FRAGN << 8) | e->len));
+    PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = processed_ip_out_len >> 3;
+    packetbuf_payload_len = uip_len - processed_ip_out_len;
+    LOG_INFO("forwarding: additional fragment (tag %d, payload %d, offset %d)\n",
+             e->out_tag, packetbuf_payload_len, processed_ip_out_len);
+    if(fragment_copy_payload_and_send(processed_ip_out_len) == 0) {
+      return 0;
+    }
+  }
+
+  linkaddr_copy(&e->next_hop, localdest);
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Relay a subsequent fragment, received in packetbuf with the
+ * FRAGN header already parsed, to the next hop of its datagram, with the
+ * tag of the datagram on that link.
+ * \param tag The tag of the fragment
+ * \param size The size of the datagram
+ * \param offset The offset of the fragment, in units of 8 bytes
+ * \return true if the fragment belongs to a forwarded datagram
+ */
+static bool
+vrb_forward_next_fragment(uint16_t tag, uint16_t size, uint8_t offset)
+{
+  struct sicslowpan_vrb *e;
+  uint8_t frame[PACKETBUF_SIZE];
+  uint16_t frame_len;
+  uint16_t len;
+  bool last;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /*  LLSEC802154_USES_AUX_HEADER */
+
+  e = vrb_lookup(packetbuf_addr(PACKETBUF_ADDR_SENDER), tag);
+  if(e == NULL) {
+    return false;
+  }
+  if(size != e->len || packetbuf_datalen() <= packetbuf_hdr_len) {
+    LOG_WARN("forwarding: invalid fragment, dropping (tag %d)\n", tag);
+    return true;
+  }
+
+  len = packetbuf_datalen() - packetbuf_hdr_len;
+  e->forwarded_len += len;
+  timer_restart(&e->timer);
+  last = e->forwarded_len >= e->len || ((uint16_t)offset << 3) + len >= e->len;
+  if(last) {
+    /* Release the entry after the last fragment */
+    e->len = 0;
+  }
+
+  if(linkaddr_cmp(&e->next_hop, &linkaddr_null)) {
+    LOG_DBG("forwarding: discarding fragment (tag %d, offset %d)\n", tag, offset << 3);
+    return true;
+  }
+
+  /* Resend the frame from a clean packetbuf, with the tag of the next link */
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, e->out_tag);
+  frame_len = packetbuf_datalen();
+  memcpy(frame, packetbuf_dataptr(), frame_len);
+  packetbuf_copyfrom(frame, frame_len);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &e->next_hop);
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, security_level);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, key_index);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /*  LLSEC802154_USES_AUX_HEADER */
+
+  if((int)frame_len > NETSTACK_MAC.max_payload()) {
+    LOG_WARN("forwarding: fragment too large for the next hop, dropping datagram (tag %d)\n", tag);
+    linkaddr_copy(&e->next_hop, &linkaddr_null);
+    return true;
+  }
+
+  LOG_INFO("forwarding: fragment (tag %d -> %d, offset %d, len %d)%s\n",
+           tag, e->out_tag, offset << 3, len, last ? ", last" : "");
+  send_packet();
+  return true;
+}
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 /*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
  *  network using 6lowpan.
@@ -1689,6 +2239,16 @@ output(const linkaddr_t *localdest)
   }
 #endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
 
+#if SICSLOWPAN_FRAG_FORWARDING
+  if(vrb_pending != NULL && localdest != NULL) {
+    /* First fragment of a forwarded datagram. Other packets, such as a
+       neighbor solicitation sent instead, go through as usual. */
+    struct sicslowpan_vrb *e = vrb_pending;
+    vrb_pending = NULL;
+    return vrb_output_first_fragment(e, localdest);
+  }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
   /* Use the mac_max_payload to understand what is the max payload in a MAC
    * packet. We calculate it here only to make a better decision of whether
    * the outgoing packet needs to be fragmented or not. */
@@ -1861,7 +2421,8 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   uint8_t is_fragment = 0;
-  int8_t frag_context = 0;
+  struct sicslowpan_frag_info *frag_context = NULL;
+  int frag_len;
 
   /* tag of the fragment */
   uint16_t frag_tag = 0;
@@ -1914,16 +2475,20 @@ input(void)
       LOG_INFO("input: received first element of a fragmented packet (tag %d, len %d)\n",
              frag_tag, frag_size);
 
-      /* Add the fragment to the fragmentation context */
-      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(vrb_forward_first_fragment(frag_tag, frag_size)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
+      /* Add the fragment to the fragmentation context. It is
+         uncompressed into uip_buf, then stored with the others. */
+      frag_context = add_fragment(frag_tag, frag_size);
 
-      if(frag_context == -1) {
+      if(frag_context == NULL) {
         LOG_ERR("input: failed to allocate new reassembly context\n");
         return;
       }
-
-      buffer = frag_info[frag_context].first_frag;
-      buffer_size = SICSLOWPAN_FIRST_FRAGMENT_SIZE;
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
       /*
@@ -1935,22 +2500,23 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
-      /* Add the fragment to the fragmentation context (this will also
-         copy the payload) */
-      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
-
-      if(frag_context == -1) {
-        LOG_ERR("input: reassembly context not found (tag %d)\n", frag_tag);
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(vrb_forward_next_fragment(frag_tag, frag_size, frag_offset)) {
         return;
       }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
-      /* Ok - add_fragment will store the fragment automatically - so
-         we should not store more */
-      buffer = NULL;
+      /* Add the fragment to the fragmentation context, which is
+         created if the first fragment was not received yet */
+      frag_context = add_fragment(frag_tag, frag_size);
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
-        last_fragment = 1;
+      if(frag_context == NULL) {
+        LOG_ERR("input: failed to allocate reassembly context (tag %d)\n", frag_tag);
+        return;
       }
+
+      /* The payload is stored from packetbuf with the fragment */
+      buffer = NULL;
       is_fragment = 1;
       break;
     default:
@@ -2028,13 +2594,15 @@ input(void)
     if(req_size > sizeof(uip_buf)) {
 #if SICSLOWPAN_CONF_FRAG
       LOG_ERR(
-          "input: packet and fragment context %u dropped, minimum required IP_BUF size: %d+%d+%d=%u (current size: %u)\n",
-          frag_context,
+          "input: packet and fragment context (tag %d) dropped, minimum required IP_BUF size: %d+%d+%d=%u (current size: %u)\n",
+          frag_tag,
           uncomp_hdr_len, (uint16_t)(frag_offset << 3),
           packetbuf_payload_len, req_size, (unsigned)sizeof(uip_buf));
       /* Discard all fragments for this contex, as reassembling this particular fragment would
        * cause an overflow in uipbuf */
-      clear_fragments(frag_context);
+      if(frag_context != NULL) {
+        clear_fragments(frag_context);
+      }
 #endif /* SICSLOWPAN_CONF_FRAG */
       return;
     }
@@ -2054,20 +2622,25 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   if(frag_size > 0) {
-    /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
-      frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+      /* Store the uncompressed headers and the payload */
+      frag_len = store_fragment(frag_context, 0, (uint8_t *)UIP_IP_BUF,
+                                uncomp_hdr_len + packetbuf_payload_len);
+    } else {
+      frag_len = store_fragment(frag_context, (uint16_t)frag_offset << 3,
+                                packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
     }
-    /* For the last fragment, we are OK if there is extrenous bytes at
-       the end of the packet. */
-    if(last_fragment != 0) {
-      frag_info[frag_context].reassembled_len = frag_size;
-      /* copy to uip */
-      if(!copy_frags2uip(frag_context)) {
-        return;
-      }
+    if(frag_len < 0) {
+      clear_fragments(frag_context);
+      return;
+    }
+    if(frag_len == 0 || frag_context->reassembled_len < frag_context->len) {
+      /* Duplicate, or more fragments to come */
+      return;
     }
+    last_fragment = 1;
+    /* copy to uip */
+    copy_frags2uip(frag_context);
   }
 
   /*
@@ -2173,6 +2746,12 @@ sicslowpan_init(void)
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 1 */
 
 #endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPHC */
+
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC && \
+  SICSLOWPAN_IPHC_CACHE_SIZE > 0
+  /* The cached compression modes depend on the contexts */
+  memset(iphc_cache, 0, sizeof(iphc_cache));
+#endif
 }
 /*--------------------------------------------------------------------*/
 const struct network_driver sicslowpan_driver = {
@@ -799,6 +799,8 @@ PROCESS_THREAD(tcpip_process, ev, data)
 {
   PROCESS_BEGIN();
 
+  process_set_priority(&tcpip_process, PROCESS_PRIORITY_HIGH);
+
 #if UIP_TCP
   memset(s.listenports, 0, UIP_LISTENPORTS*sizeof(*(s.listenports)));
   s.p = PROCESS_CURRENT();
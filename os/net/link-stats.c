@@ -37,6 +37,7 @@
 #include "net/nbr-table.h"
 #include "net/link-stats.h"
 #include <stdio.h>
+#include <string.h>
 
 /* Log configuration */
 #include "sys/log.h"
@@ -82,6 +83,11 @@
 /* Per-neighbor link statistics table */
 NBR_TABLE(struct link_stats, link_stats);
 
+#if LINK_STATS_PER_CELL_ETX
+/* Per-cell statistics, shared by all neighbors */
+static struct link_stats_cell cells[LINK_STATS_MAX_CELLS];
+#endif /* LINK_STATS_PER_CELL_ETX */
+
 /* Called at a period of FRESHNESS_HALF_LIFE */
 struct ctimer periodic_timer;
 
@@ -135,6 +141,74 @@ guess_etx_from_rssi(const struct link_stats *stats)
   return 0xffff;
 }
 #endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
+#if LINK_STATS_PER_CELL_ETX
+/*---------------------------------------------------------------------------*/
+/* Returns the entry of a cell, replacing the least used one if needed */
+static struct link_stats_cell *
+get_cell(const struct link_stats *stats, uint16_t cell)
+{
+  struct link_stats_cell *least_used = &cells[0];
+  int i;
+
+  for(i = 0; i < LINK_STATS_MAX_CELLS; i++) {
+    struct link_stats_cell *c = &cells[i];
+    if(c->stats != NULL && c->id == cell) {
+      if(c->stats != stats) {
+        /* The MAC reuses the identifier for another neighbor */
+        least_used = c;
+        break;
+      }
+      return c;
+    }
+    if(least_used->stats != NULL
+       && (c->stats == NULL || c->tx_count < least_used->tx_count)) {
+      least_used = c;
+    }
+  }
+  least_used->stats = stats;
+  least_used->id = cell;
+  least_used->tx_count = 0;
+  least_used->ack_count = 0;
+  return least_used;
+}
+/*---------------------------------------------------------------------------*/
+/* Forgets all cells of a neighbor, called when the neighbor table removes it */
+static void
+remove_cells(const struct link_stats *stats)
+{
+  int i;
+  for(i = 0; i < LINK_STATS_MAX_CELLS; i++) {
+    if(cells[i].stats == stats) {
+      memset(&cells[i], 0, sizeof(cells[i]));
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Sets the ETX from the Tx and ACK counts of the tracked cells, if there
+ * are enough of them. Every cell is weighted by its number of attempts. */
+static void
+update_etx_from_cells(struct link_stats *stats)
+{
+  uint16_t tx_count = 0;
+  uint16_t ack_count = 0;
+  int i;
+
+  for(i = 0; i < LINK_STATS_MAX_CELLS; i++) {
+    if(cells[i].stats == stats) {
+      tx_count += cells[i].tx_count;
+      ack_count += cells[i].ack_count;
+    }
+  }
+  if(tx_count < LINK_STATS_CELL_MIN_TX) {
+    return;
+  }
+  if(ack_count > 0) {
+    stats->etx = MIN(((uint32_t)tx_count * ETX_DIVISOR) / ack_count, 0xffff);
+  } else {
+    stats->etx = MIN((uint32_t)MAX(ETX_NOACK_PENALTY, tx_count) * ETX_DIVISOR, 0xffff);
+  }
+}
+#endif /* LINK_STATS_PER_CELL_ETX */
 /*---------------------------------------------------------------------------*/
 /* Packet sent callback. Updates stats for transmissions to lladdr */
 void
@@ -226,7 +300,84 @@ link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
         (uint32_t)packet_etx * ewma_alpha) / EWMA_SCALE;
   }
 #endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
+
+#if LINK_STATS_PER_CELL_ETX
+  update_etx_from_cells(stats);
+#endif /* LINK_STATS_PER_CELL_ETX */
+}
+#if LINK_STATS_PER_CELL_ETX
+/*---------------------------------------------------------------------------*/
+/* Updates the statistics of a cell after one transmission attempt */
+void
+link_stats_cell_packet_sent(const linkaddr_t *lladdr, uint16_t cell, int status)
+{
+  struct link_stats *stats;
+  struct link_stats_cell *c;
+
+  if(status != MAC_TX_OK && status != MAC_TX_NOACK) {
+    return;
+  }
+
+  stats = nbr_table_get_from_lladdr(link_stats, lladdr);
+  if(stats == NULL) {
+    /* The neighbor is added by link_stats_packet_sent, at the end of the packet */
+    return;
+  }
+
+  c = get_cell(stats, cell);
+  /* Halve both counters after TX_COUNT_MAX */
+  if(c->tx_count >= TX_COUNT_MAX) {
+    c->tx_count /= 2;
+    c->ack_count /= 2;
+  }
+  c->tx_count++;
+  if(status == MAC_TX_OK) {
+    c->ack_count++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Forgets a cell that no longer exists, e.g. after a relocation */
+void
+link_stats_cell_removed(const linkaddr_t *lladdr, uint16_t cell)
+{
+  struct link_stats *stats;
+  int i;
+
+  stats = nbr_table_get_from_lladdr(link_stats, lladdr);
+  if(stats == NULL) {
+    return;
+  }
+
+  for(i = 0; i < LINK_STATS_MAX_CELLS; i++) {
+    if(cells[i].stats == stats && cells[i].id == cell) {
+      memset(&cells[i], 0, sizeof(cells[i]));
+      /* The ETX no longer includes the attempts on the removed cell */
+      update_etx_from_cells(stats);
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the statistics of a cell to a neighbor, NULL if not tracked */
+const struct link_stats_cell *
+link_stats_get_cell(const linkaddr_t *lladdr, uint16_t cell)
+{
+  const struct link_stats *stats;
+  int i;
+
+  stats = nbr_table_get_from_lladdr(link_stats, lladdr);
+  if(stats == NULL) {
+    return NULL;
+  }
+
+  for(i = 0; i < LINK_STATS_MAX_CELLS; i++) {
+    if(cells[i].stats == stats && cells[i].id == cell) {
+      return &cells[i];
+    }
+  }
+  return NULL;
 }
+#endif /* LINK_STATS_PER_CELL_ETX */
 /*---------------------------------------------------------------------------*/
 /* Packet input callback. Updates statistics for receptions on a given link */
 void
@@ -322,12 +473,19 @@ link_stats_reset(void)
     nbr_table_remove(link_stats, stats);
     stats = nbr_table_next(link_stats, stats);
   }
+#if LINK_STATS_PER_CELL_ETX
+  memset(cells, 0, sizeof(cells));
+#endif /* LINK_STATS_PER_CELL_ETX */
 }
 /*---------------------------------------------------------------------------*/
 /* Initializes link-stats module */
 void
 link_stats_init(void)
 {
+#if LINK_STATS_PER_CELL_ETX
+  nbr_table_register(link_stats, (nbr_table_callback *)remove_cells);
+#else /* LINK_STATS_PER_CELL_ETX */
   nbr_table_register(link_stats, NULL);
+#endif /* LINK_STATS_PER_CELL_ETX */
   ctimer_set(&periodic_timer, FRESHNESS_HALF_LIFE, periodic, NULL);
 }
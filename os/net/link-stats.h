@@ -84,6 +84,36 @@
 #define LINK_STATS_RSSI_LOW                -90
 #endif /* LINK_STATS_RSSI_LOW */
 
+/* Compute the ETX of a neighbor from the cells (e.g. TSCH links) that are
+ * currently used to reach it, rather than from all past transmissions.
+ * The MAC reports every attempt with link_stats_cell_packet_sent and
+ * cells that are removed with link_stats_cell_removed */
+#ifdef LINK_STATS_CONF_PER_CELL_ETX
+#define LINK_STATS_PER_CELL_ETX LINK_STATS_CONF_PER_CELL_ETX
+#else /* LINK_STATS_CONF_PER_CELL_ETX */
+#define LINK_STATS_PER_CELL_ETX              0
+#endif /* LINK_STATS_CONF_PER_CELL_ETX */
+
+/* Number of cells tracked, over all neighbors. With TSCH, one per link of
+ * the schedule, so that no cell in use is ever replaced. When full, the
+ * least used cell is replaced */
+#ifdef LINK_STATS_CONF_MAX_CELLS
+#define LINK_STATS_MAX_CELLS LINK_STATS_CONF_MAX_CELLS
+#elif MAC_CONF_WITH_TSCH
+#include "net/mac/tsch/tsch-conf.h"
+#define LINK_STATS_MAX_CELLS TSCH_SCHEDULE_MAX_LINKS
+#else /* LINK_STATS_CONF_MAX_CELLS */
+#define LINK_STATS_MAX_CELLS                 8
+#endif /* LINK_STATS_CONF_MAX_CELLS */
+
+/* Minimum number of attempts over the tracked cells before their ETX
+ * replaces the packet-based ETX */
+#ifdef LINK_STATS_CONF_CELL_MIN_TX
+#define LINK_STATS_CELL_MIN_TX LINK_STATS_CONF_CELL_MIN_TX
+#else /* LINK_STATS_CONF_CELL_MIN_TX */
+#define LINK_STATS_CELL_MIN_TX               4
+#endif /* LINK_STATS_CONF_CELL_MIN_TX */
+
 /* Special value that signal the RSSI is not initialized */
 #define LINK_STATS_RSSI_UNKNOWN 0x7fff
 
@@ -118,6 +148,16 @@ struct link_stats {
 #endif
 };
 
+#if LINK_STATS_PER_CELL_ETX
+/* Statistics of a cell used to reach a neighbor */
+struct link_stats_cell {
+  const struct link_stats *stats; /* The neighbor's statistics. NULL if unused. */
+  uint16_t id;                /* Cell identifier, chosen by the MAC */
+  uint8_t tx_count;           /* Tx attempts on this cell */
+  uint8_t ack_count;          /* ACKs received on this cell */
+};
+#endif /* LINK_STATS_PER_CELL_ETX */
+
 /* Returns the neighbor's link statistics */
 const struct link_stats *link_stats_from_lladdr(const linkaddr_t *lladdr);
 /* Returns the address of the neighbor */
@@ -132,5 +172,13 @@ void link_stats_init(void);
 void link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx);
 /* Packet input callback. Updates statistics for receptions on a given link */
 void link_stats_input_callback(const linkaddr_t *lladdr);
+#if LINK_STATS_PER_CELL_ETX
+/* Updates the statistics of a cell after one transmission attempt */
+void link_stats_cell_packet_sent(const linkaddr_t *lladdr, uint16_t cell, int status);
+/* Forgets a cell that no longer exists, e.g. after a relocation */
+void link_stats_cell_removed(const linkaddr_t *lladdr, uint16_t cell);
+/* Returns the statistics of a cell to a neighbor, NULL if not tracked */
+const struct link_stats_cell *link_stats_get_cell(const linkaddr_t *lladdr, uint16_t cell);
+#endif /* LINK_STATS_PER_CELL_ETX */
 
 #endif /* LINK_STATS_H_ */
@@ -230,6 +230,30 @@
 #define TSCH_CHANNEL_SCAN_DURATION CLOCK_SECOND
 #endif
 
+/* Learned scan: remember the channels on which EBs were last heard, and
+ * try these channels first (most recent first) when scanning, before
+ * falling back to the random channel hopping scan. Cuts association time
+ * after short outages. */
+#ifdef TSCH_CONF_SCAN_LEARNED
+#define TSCH_SCAN_LEARNED TSCH_CONF_SCAN_LEARNED
+#else
+#define TSCH_SCAN_LEARNED 0
+#endif
+
+/* Max number of channels remembered by the learned scan */
+#ifdef TSCH_CONF_SCAN_LEARNED_MAX_CHANNELS
+#define TSCH_SCAN_LEARNED_MAX_CHANNELS TSCH_CONF_SCAN_LEARNED_MAX_CHANNELS
+#else
+#define TSCH_SCAN_LEARNED_MAX_CHANNELS 4
+#endif
+
+/* Channels not heard from for longer than this are ignored by the learned scan */
+#ifdef TSCH_CONF_SCAN_LEARNED_MAX_AGE
+#define TSCH_SCAN_LEARNED_MAX_AGE TSCH_CONF_SCAN_LEARNED_MAX_AGE
+#else
+#define TSCH_SCAN_LEARNED_MAX_AGE (10 * 60 * CLOCK_SECOND)
+#endif
+
 /* TSCH EB: include timeslot timing Information Element? */
 #ifdef TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TIMING
 #define TSCH_PACKET_EB_WITH_TIMESLOT_TIMING TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TIMING
@@ -311,6 +335,14 @@
 #endif
 #endif
 
+/* Size of the ringbuf of transmission attempts reported to link-stats
+ * with LINK_STATS_CONF_PER_CELL_ETX. Must be power of two */
+#ifdef TSCH_CONF_CELL_TX_ARRAY_SIZE
+#define TSCH_CELL_TX_ARRAY_SIZE TSCH_CONF_CELL_TX_ARRAY_SIZE
+#else
+#define TSCH_CELL_TX_ARRAY_SIZE 16
+#endif
+
 /* The number of neighbor queues. There are two queues allocated at all times:
  * one for EBs, one for broadcasts. Other queues are for unicast to neighbors */
 #ifdef TSCH_QUEUE_CONF_MAX_NEIGHBOR_QUEUES
@@ -319,6 +351,48 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Trace the latency of every packet in ASNs (enqueue, first transmission,
+ * ACK) and keep per-neighbor and per-cell histograms. See tsch-latency.h */
+#ifdef TSCH_CONF_WITH_LATENCY
+#define TSCH_WITH_LATENCY TSCH_CONF_WITH_LATENCY
+#else
+#define TSCH_WITH_LATENCY 0
+#endif
+
+/* Number of log2 histogram bins: bin 0 counts a latency of 0 slots,
+ * bin i counts [2^(i-1), 2^i) slots, the last bin everything above */
+#ifdef TSCH_LATENCY_CONF_NUM_BINS
+#define TSCH_LATENCY_NUM_BINS TSCH_LATENCY_CONF_NUM_BINS
+#else
+#define TSCH_LATENCY_NUM_BINS 12
+#endif
+
+/* Number of cells with a latency histogram. Cells beyond that are only
+ * accounted for in the per-neighbor histograms */
+#ifdef TSCH_LATENCY_CONF_MAX_CELLS
+#define TSCH_LATENCY_MAX_CELLS TSCH_LATENCY_CONF_MAX_CELLS
+#else
+#define TSCH_LATENCY_MAX_CELLS 16
+#endif
+
+/* Profile the slot operation: at the end of every phase of Tx and Rx
+ * slots, record the margin left to the deadline of the next phase
+ * in a log2 histogram, and log deadline misses. See tsch-slot-timing.h */
+#ifdef TSCH_CONF_WITH_SLOT_TIMING
+#define TSCH_WITH_SLOT_TIMING TSCH_CONF_WITH_SLOT_TIMING
+#else
+#define TSCH_WITH_SLOT_TIMING 0
+#endif
+
+/* Number of log2 histogram bins of the slot timing profiler: bin 0
+ * counts a margin of 0 rtimer ticks, bin i counts [2^(i-1), 2^i) ticks,
+ * the last bin everything above */
+#ifdef TSCH_SLOT_TIMING_CONF_NUM_BINS
+#define TSCH_SLOT_TIMING_NUM_BINS TSCH_SLOT_TIMING_CONF_NUM_BINS
+#else
+#define TSCH_SLOT_TIMING_NUM_BINS 16
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -351,6 +425,15 @@
 #define TSCH_SCHEDULE_MAX_SLOTFRAMES 5
 #endif
 
+/* Max number of entries of the slotframe registry: owned slotframe
+ * handles and reserved timeslot ranges (see tsch-schedule.h). By default,
+ * a handle and a range per slotframe, plus the 6TiSCH minimal schedule's */
+#ifdef TSCH_SCHEDULE_CONF_MAX_RESERVATIONS
+#define TSCH_SCHEDULE_MAX_RESERVATIONS TSCH_SCHEDULE_CONF_MAX_RESERVATIONS
+#else
+#define TSCH_SCHEDULE_MAX_RESERVATIONS (2 * TSCH_SCHEDULE_MAX_SLOTFRAMES + 2)
+#endif
+
 /* Max number of links */
 #ifdef TSCH_SCHEDULE_CONF_MAX_LINKS
 #define TSCH_SCHEDULE_MAX_LINKS TSCH_SCHEDULE_CONF_MAX_LINKS
@@ -358,6 +441,52 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Compact link representation: store the neighbor as an index into the
+ * TSCH neighbor table instead of a full address, and pack options, type
+ * and offsets. Halves the size of a link, at the cost of keeping a TSCH
+ * neighbor entry for every neighbor that has a link (RX links included).
+ * Requires slotframe handles and channel offsets below 256. */
+#ifdef TSCH_SCHEDULE_CONF_COMPACT_LINKS
+#define TSCH_SCHEDULE_COMPACT_LINKS TSCH_SCHEDULE_CONF_COMPACT_LINKS
+#else
+#define TSCH_SCHEDULE_COMPACT_LINKS 0
+#endif
+
+/* Maintain hash indexes over the links (by handle and by slotframe and
+ * timeslot), so that link lookup and removal do not walk the schedule.
+ * Costs two pointers per index entry. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#define TSCH_SCHEDULE_WITH_LINK_INDEX TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_LINK_INDEX 0
+#endif
+
+/* Number of entries of each link index. Keep it well above
+ * TSCH_SCHEDULE_MAX_LINKS for short probe sequences. */
+#ifdef TSCH_SCHEDULE_CONF_LINK_INDEX_SIZE
+#define TSCH_SCHEDULE_LINK_INDEX_SIZE TSCH_SCHEDULE_CONF_LINK_INDEX_SIZE
+#else
+#define TSCH_SCHEDULE_LINK_INDEX_SIZE (2 * TSCH_SCHEDULE_MAX_LINKS + 1)
+#endif
+
+/* At the end of a slot, look up to this many active links ahead and skip
+ * the Tx-only links that have nothing to send (and no Rx backup link),
+ * instead of waking up for each of them. A packet queued while asleep
+ * waits for the next link that is not skipped. 0 to disable */
+#ifdef TSCH_SCHEDULE_CONF_LOOKAHEAD
+#define TSCH_SCHEDULE_LOOKAHEAD TSCH_SCHEDULE_CONF_LOOKAHEAD
+#else
+#define TSCH_SCHEDULE_LOOKAHEAD 0
+#endif
+
+/* Links are only skipped after this many timeslots without any packet
+ * being queued, so that nodes with ongoing traffic use all their cells */
+#ifdef TSCH_SCHEDULE_CONF_LOOKAHEAD_IDLE_SLOTS
+#define TSCH_SCHEDULE_LOOKAHEAD_IDLE_SLOTS TSCH_SCHEDULE_CONF_LOOKAHEAD_IDLE_SLOTS
+#else
+#define TSCH_SCHEDULE_LOOKAHEAD_IDLE_SLOTS 256
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -380,6 +509,13 @@
 #define TSCH_LINK_COMPARATOR(a, b) default_tsch_link_comparator(a, b)
 #endif
 
+/* Print the statistics of every cell evaluated for PDR-based relocation */
+#ifdef TSCH_CONF_LOG_CELL_EVALUATION
+#define TSCH_LOG_CELL_EVALUATION TSCH_CONF_LOG_CELL_EVALUATION
+#else
+#define TSCH_LOG_CELL_EVALUATION 0
+#endif
+
 /******** Configuration: CSMA *******/
 
 /* TSCH CSMA-CA parameters, see IEEE 802.15.4e-2012 */
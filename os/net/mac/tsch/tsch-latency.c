@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+ */
+
+/**
+ * \file
+ *         Per-packet latency tracing in ASNs
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-latency.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_latency_hist_count(const struct tsch_latency_hist *h)
+{
+  uint32_t count = 0;
+  uint8_t i;
+
+  for(i = 0; i < TSCH_LATENCY_NUM_BINS; i++) {
+    count += h->bins[i];
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_latency_hist_mean(const struct tsch_latency_hist *h)
+{
+  uint32_t count = tsch_latency_hist_count(h);
+
+  return count == 0 ? 0 : h->sum / count;
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_WITH_LATENCY
+
+static struct tsch_latency_cell cells[TSCH_LATENCY_MAX_CELLS];
+static uint8_t cells_count;
+
+/*---------------------------------------------------------------------------*/
+static void
+hist_add(struct tsch_latency_hist *h, uint32_t slots)
+{
+  uint32_t v = slots;
+  uint8_t bin = 0;
+
+  /* bin = 1 + floor(log2(slots)), saturated to the last bin */
+  if(v > 0) {
+    bin = 1;
+    while(v > 1 && bin < TSCH_LATENCY_NUM_BINS - 1) {
+      v >>= 1;
+      bin++;
+    }
+  }
+  if(h->bins[bin] < 0xffff) {
+    h->bins[bin]++;
+  }
+  h->sum += slots;
+  if(slots > h->max) {
+    h->max = slots > 0xffff ? 0xffff : slots;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_latency_cell *
+get_cell(const struct tsch_link *link)
+{
+  uint8_t i;
+
+  for(i = 0; i < cells_count; i++) {
+    if(cells[i].timeslot == link->timeslot
+       && cells[i].slotframe_handle == link->slotframe_handle) {
+      return &cells[i];
+    }
+  }
+  if(cells_count < TSCH_LATENCY_MAX_CELLS) {
+    cells[cells_count].slotframe_handle = link->slotframe_handle;
+    cells[cells_count].timeslot = link->timeslot;
+    return &cells[cells_count++];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_latency_packet_added(struct tsch_packet *p)
+{
+  p->enqueue_asn = tsch_current_asn;
+  p->dequeue_asn = tsch_current_asn;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_latency_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
+                         struct tsch_link *link, uint8_t mac_tx_status,
+                         int in_queue)
+{
+  struct tsch_latency_cell *cell;
+  uint32_t latency;
+
+  if(p->transmissions == 1) {
+    p->dequeue_asn = tsch_current_asn;
+  }
+  if(in_queue) {
+    return;
+  }
+
+  /* The packet leaves the queue: ACKed, broadcast, or dropped */
+  hist_add(&n->queue_latency, TSCH_ASN_DIFF(p->dequeue_asn, p->enqueue_asn));
+  if(mac_tx_status == MAC_TX_OK) {
+    latency = TSCH_ASN_DIFF(tsch_current_asn, p->enqueue_asn);
+    hist_add(&n->ack_latency, latency);
+    cell = get_cell(link);
+    if(cell != NULL) {
+      hist_add(&cell->hist, latency);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_latency_cell *
+tsch_latency_cell_at(uint8_t i)
+{
+  return i < cells_count ? &cells[i] : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_latency_reset(void)
+{
+  struct tsch_neighbor *n;
+
+  if(tsch_get_lock()) {
+    for(n = tsch_queue_first_nbr(); n != NULL; n = tsch_queue_next_nbr(n)) {
+      memset(&n->queue_latency, 0, sizeof(n->queue_latency));
+      memset(&n->ack_latency, 0, sizeof(n->ack_latency));
+    }
+    memset(cells, 0, sizeof(cells));
+    cells_count = 0;
+    tsch_release_lock();
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_WITH_LATENCY */
+/** @} */
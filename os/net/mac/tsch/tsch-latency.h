@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+ */
+
+/**
+ * \file
+ *         Per-packet latency tracing in ASNs. Every packet is stamped
+ *         with the ASN at which it is queued and the ASN of its first
+ *         transmission; when it leaves the queue, the queueing latency
+ *         (enqueue to first transmission) and the link latency (enqueue
+ *         to ACK) are added to log2 histograms of the neighbor, and the
+ *         link latency to the histogram of the cell it was ACKed on.
+ *
+ *         Enable with TSCH_CONF_WITH_LATENCY. All updates run in the
+ *         slot operation and cost a few shifts and additions.
+ */
+
+#ifndef TSCH_LATENCY_H_
+#define TSCH_LATENCY_H_
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-conf.h"
+#include "net/mac/tsch/tsch-types.h"
+
+/** \brief Latency histogram of a cell */
+struct tsch_latency_cell {
+  uint16_t slotframe_handle;
+  uint16_t timeslot;
+  struct tsch_latency_hist hist;
+};
+
+#if TSCH_WITH_LATENCY
+
+/**
+ * \brief Stamp a packet that was just queued
+ * \param p The packet
+ */
+void tsch_latency_packet_added(struct tsch_packet *p);
+
+/**
+ * \brief Account for a transmission attempt, called from tsch_queue_packet_sent
+ * \param n The neighbor the packet is queued for
+ * \param p The packet
+ * \param link The link used for the transmission
+ * \param mac_tx_status The MAC status of the attempt
+ * \param in_queue Nonzero if the packet stays in the queue
+ */
+void tsch_latency_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
+                              struct tsch_link *link, uint8_t mac_tx_status,
+                              int in_queue);
+
+/**
+ * \brief Get the histogram of a cell
+ * \param i The index of the cell, from 0
+ * \return The cell, NULL if there are fewer cells
+ */
+const struct tsch_latency_cell *tsch_latency_cell_at(uint8_t i);
+
+/**
+ * \brief Clear all per-neighbor and per-cell histograms
+ */
+void tsch_latency_reset(void);
+
+#else /* TSCH_WITH_LATENCY */
+
+#define tsch_latency_packet_added(p)
+#define tsch_latency_packet_sent(n, p, link, mac_tx_status, in_queue)
+#define tsch_latency_cell_at(i) ((const struct tsch_latency_cell *)NULL)
+#define tsch_latency_reset()
+
+#endif /* TSCH_WITH_LATENCY */
+
+/**
+ * \brief Number of samples of a histogram
+ */
+uint32_t tsch_latency_hist_count(const struct tsch_latency_hist *h);
+
+/**
+ * \brief Mean of a histogram, in timeslots
+ */
+uint32_t tsch_latency_hist_mean(const struct tsch_latency_hist *h);
+
+/**
+ * \brief Lower bound, in timeslots, of a histogram bin
+ */
+#define TSCH_LATENCY_BIN_MIN(bin) ((bin) == 0 ? 0 : 1ul << ((bin) - 1))
+
+#endif /* TSCH_LATENCY_H_ */
+/** @} */
@@ -68,12 +68,15 @@
 #endif
 
 /* We have as many packets are there are queuebuf in the system */
-MEMB(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
+MEMB_FREE_LIST(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
 NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 
 /* Broadcast and EB virtual neighbors */
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
+#if TSCH_SCHEDULE_LOOKAHEAD
+struct tsch_asn_t tsch_queue_last_enqueue_asn;
+#endif /* TSCH_SCHEDULE_LOOKAHEAD */
 
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
@@ -137,6 +140,32 @@ tsch_queue_get_nbr_address(const struct tsch_neighbor *n)
   return nbr_table_get_lladdr(tsch_neighbors, n);
 }
 /*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_first_nbr(void)
+{
+  return (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_next_nbr(struct tsch_neighbor *n)
+{
+  return (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
+}
+#if TSCH_SCHEDULE_COMPACT_LINKS
+/*---------------------------------------------------------------------------*/
+tsch_nbr_index_t
+tsch_queue_get_nbr_index(const struct tsch_neighbor *n)
+{
+  return n - (struct tsch_neighbor *)tsch_neighbors->data;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_get_nbr_by_index(tsch_nbr_index_t index)
+{
+  return (struct tsch_neighbor *)tsch_neighbors->data + index;
+}
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+/*---------------------------------------------------------------------------*/
 /* Update TSCH time source */
 int
 tsch_queue_update_time_source(const linkaddr_t *new_addr)
@@ -257,6 +286,10 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             p->ret = MAC_TX_DEFERRED;
             p->transmissions = 0;
             p->max_transmissions = max_transmissions;
+            tsch_latency_packet_added(p);
+#if TSCH_SCHEDULE_LOOKAHEAD
+            tsch_queue_last_enqueue_asn = tsch_current_asn;
+#endif /* TSCH_SCHEDULE_LOOKAHEAD */
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
@@ -323,13 +356,38 @@ tsch_queue_free_packet(struct tsch_packet *p)
 void
 tsch_queue_free_packets_to(const linkaddr_t *addr)
 {
-  struct tsch_neighbor *n = NULL;
-  if(!tsch_is_locked()) {
-    n = tsch_queue_get_nbr(addr);
-    if(n != NULL) {
-      tsch_queue_flush_nbr_queue(n);
+  struct tsch_packet *flushed[QUEUEBUF_NUM];
+  struct tsch_neighbor *n;
+  int16_t get_index;
+  int count = 0;
+  int locked;
+  int i;
+
+  /* An ongoing slot operation may have selected one of the packets for
+   * transmission: wait for its end, and keep new ones from starting until
+   * the queue is empty. If the lock is not available, our caller holds it
+   * and slot operations are excluded already: flush anyway. */
+  locked = tsch_get_lock();
+  n = (struct tsch_neighbor *)nbr_table_get_from_lladdr(tsch_neighbors, addr);
+  if(n != NULL) {
+    /* All packets come from packet_memb: there are at most QUEUEBUF_NUM */
+    while(count < QUEUEBUF_NUM
+          && (get_index = ringbufindex_get(&n->tx_ringbuf)) != -1) {
+      flushed[count++] = n->tx_array[get_index];
     }
   }
+  if(locked) {
+    tsch_release_lock();
+  }
+
+  /* Call the sent callbacks unlocked, as they may queue new packets */
+  for(i = 0; i < count; i++) {
+    flushed[i]->ret = MAC_TX_ERR;
+    LOG_WARN("! flushing packet\n");
+    mac_call_sent_callback(flushed[i]->sent, flushed[i]->ptr,
+                           flushed[i]->ret, flushed[i]->transmissions);
+    tsch_queue_free_packet(flushed[i]);
+  }
 }
 /*---------------------------------------------------------------------------*/
 /* Updates neighbor queue state after a transmission */
@@ -372,6 +430,8 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     }
   }
 
+  tsch_latency_packet_sent(n, p, link, mac_tx_status, in_queue);
+
   return in_queue;
 }
 /*---------------------------------------------------------------------------*/
@@ -405,6 +465,10 @@ tsch_queue_free_unused_neighbors(void)
       /* Queue is empty, no tx link to this neighbor: deallocate.
        * Always keep time source and virtual broadcast neighbors. */
       if(!n->is_broadcast && !n->is_time_source && !n->tx_links_count
+#if TSCH_SCHEDULE_COMPACT_LINKS
+         /* Compact links refer to their neighbor by index */
+         && !n->links_count
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
          && tsch_queue_is_empty(n)) {
         tsch_queue_remove_nbr(n);
       }
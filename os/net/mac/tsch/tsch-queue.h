@@ -52,6 +52,10 @@
 /* Broadcast and EB virtual neighbors */
 extern struct tsch_neighbor *n_broadcast;
 extern struct tsch_neighbor *n_eb;
+#if TSCH_SCHEDULE_LOOKAHEAD
+/* ASN at which the last packet was queued */
+extern struct tsch_asn_t tsch_queue_last_enqueue_asn;
+#endif /* TSCH_SCHEDULE_LOOKAHEAD */
 
 /********** Functions *********/
 
@@ -76,6 +80,31 @@ struct tsch_neighbor *tsch_queue_get_time_source(void);
  * \return The link-layer address of the neighbor.
  */
 linkaddr_t *tsch_queue_get_nbr_address(const struct tsch_neighbor *);
+/**
+ * \brief Get the first neighbor of the TSCH neighbor table
+ * \return The first neighbor, NULL if the table is empty
+ */
+struct tsch_neighbor *tsch_queue_first_nbr(void);
+/**
+ * \brief Get the next neighbor of the TSCH neighbor table
+ * \param n The current neighbor
+ * \return The next neighbor, NULL at the end of the table
+ */
+struct tsch_neighbor *tsch_queue_next_nbr(struct tsch_neighbor *n);
+#if TSCH_SCHEDULE_COMPACT_LINKS
+/**
+ * \brief Get the index of a neighbor in the TSCH neighbor table
+ * \param n The neighbor
+ * \return The index of the neighbor, as stored in compact links
+ */
+tsch_nbr_index_t tsch_queue_get_nbr_index(const struct tsch_neighbor *n);
+/**
+ * \brief Get a neighbor from its index in the TSCH neighbor table
+ * \param index The index of the neighbor
+ * \return The neighbor
+ */
+struct tsch_neighbor *tsch_queue_get_nbr_by_index(tsch_nbr_index_t index);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
 /**
  * \brief Update TSCH time source
  * \param new_addr The address of the new TSCH time source
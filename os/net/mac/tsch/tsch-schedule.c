@@ -48,6 +48,7 @@
 #include "dev/leds.h"
 #include "lib/memb.h"
 #include "net/nbr-table.h"
+#include "net/link-stats.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
 #include "net/mac/tsch/tsch.h"
@@ -62,12 +63,115 @@
 #define LOG_LEVEL LOG_LEVEL_MAC
 
 /* Pre-allocated space for links */
-MEMB(link_memb, struct tsch_link, TSCH_SCHEDULE_MAX_LINKS);
+MEMB_FREE_LIST(link_memb, struct tsch_link, TSCH_SCHEDULE_MAX_LINKS);
 /* Pre-allocated space for slotframes */
 MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+/* Open-addressing (linear probing) indexes over all links: one keyed by
+ * link handle, one keyed by (slotframe handle, timeslot). Removal uses
+ * backward-shift deletion, so that no tombstones are needed and probe
+ * sequences stay short as the schedule churns. */
+#define LINK_INDEX_SIZE TSCH_SCHEDULE_LINK_INDEX_SIZE
+/* Probing stops at an empty entry: there must always be one */
+#if LINK_INDEX_SIZE <= TSCH_SCHEDULE_MAX_LINKS
+#error TSCH_SCHEDULE_CONF_LINK_INDEX_SIZE must be larger than TSCH_SCHEDULE_MAX_LINKS
+#endif
+static struct tsch_link *link_index_by_handle[LINK_INDEX_SIZE];
+static struct tsch_link *link_index_by_timeslot[LINK_INDEX_SIZE];
+
+typedef uint16_t (*link_index_hash_t)(const struct tsch_link *l);
+/*---------------------------------------------------------------------------*/
+static uint16_t
+hash_handle(uint16_t handle)
+{
+  return handle % LINK_INDEX_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+hash_timeslot(uint16_t slotframe_handle, uint16_t timeslot)
+{
+  return (uint16_t)(((uint32_t)slotframe_handle * 40503u + timeslot) % LINK_INDEX_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+link_hash_handle(const struct tsch_link *l)
+{
+  return hash_handle(l->handle);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+link_hash_timeslot(const struct tsch_link *l)
+{
+  return hash_timeslot(l->slotframe_handle, l->timeslot);
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_index_add(struct tsch_link **index, link_index_hash_t hash,
+               struct tsch_link *l)
+{
+  uint16_t i = hash(l);
+  while(index[i] != NULL) {
+    i = (i + 1) % LINK_INDEX_SIZE;
+  }
+  index[i] = l;
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_index_remove(struct tsch_link **index, link_index_hash_t hash,
+                  struct tsch_link *l)
+{
+  uint16_t i = hash(l);
+  uint16_t j;
+
+  /* Find the entry */
+  while(index[i] != l) {
+    if(index[i] == NULL) {
+      return;
+    }
+    i = (i + 1) % LINK_INDEX_SIZE;
+  }
+
+  /* Shift back the following entries of the cluster that would otherwise
+   * become unreachable from their home slot */
+  j = i;
+  while(1) {
+    uint16_t k;
+    j = (j + 1) % LINK_INDEX_SIZE;
+    if(index[j] == NULL) {
+      break;
+    }
+    k = hash(index[j]);
+    /* Move entry j to i unless its home slot k lies cyclically in (i, j] */
+    if(i <= j ? (k <= i || k > j) : (k <= i && k > j)) {
+      index[i] = index[j];
+      i = j;
+    }
+  }
+  index[i] = NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Looks up a link by (slotframe handle, timeslot) and, if channel_offset
+ * is not 0xffff, channel offset */
+static struct tsch_link *
+link_index_get_by_offsets(uint16_t slotframe_handle, uint16_t timeslot,
+                          uint16_t channel_offset)
+{
+  uint16_t i = hash_timeslot(slotframe_handle, timeslot);
+  struct tsch_link *l;
+  while((l = link_index_by_timeslot[i]) != NULL) {
+    if(l->slotframe_handle == slotframe_handle && l->timeslot == timeslot
+       && (channel_offset == 0xffff || l->channel_offset == channel_offset)) {
+      return l;
+    }
+    i = (i + 1) % LINK_INDEX_SIZE;
+  }
+  return NULL;
+}
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -76,6 +180,14 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
     return NULL;
   }
 
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  /* Compact links store the slotframe handle on 8 bits */
+  if(handle > UINT8_MAX) {
+    LOG_ERR("! add_slotframe invalid handle for compact links: %u\n", handle);
+    return NULL;
+  }
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+
   if(tsch_schedule_get_slotframe_by_handle(handle)) {
     /* A slotframe with this handle already exists */
     return NULL;
@@ -151,11 +263,44 @@ tsch_schedule_get_slotframe_by_handle(uint16_t handle)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the address of the neighbor of a link */
+const linkaddr_t *
+tsch_schedule_get_link_addr(const struct tsch_link *link)
+{
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  return tsch_queue_get_nbr_address(tsch_queue_get_nbr_by_index(link->nbr_index));
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
+  return &link->addr;
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the neighbor of a link */
+struct tsch_neighbor *
+tsch_schedule_get_link_nbr(const struct tsch_link *link)
+{
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  /* Kept allocated by the link, see links_count */
+  return tsch_queue_get_nbr_by_index(link->nbr_index);
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
+  return tsch_queue_get_nbr(&link->addr);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+}
+/*---------------------------------------------------------------------------*/
 /* Looks for a link from a handle */
 struct tsch_link *
 tsch_schedule_get_link_by_handle(uint16_t handle)
 {
   if(!tsch_is_locked()) {
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+    uint16_t i = hash_handle(handle);
+    struct tsch_link *l;
+    while((l = link_index_by_handle[i]) != NULL) {
+      if(l->handle == handle) {
+        return l;
+      }
+      i = (i + 1) % LINK_INDEX_SIZE;
+    }
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     struct tsch_slotframe *sf = list_head(slotframe_list);
     while(sf != NULL) {
       struct tsch_link *l = list_head(sf->links_list);
@@ -168,6 +313,7 @@ tsch_schedule_get_link_by_handle(uint16_t handle)
       }
       sf = list_item_next(sf);
     }
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
   }
   return NULL;
 }
@@ -218,6 +364,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
                        uint16_t timeslot, uint16_t channel_offset, uint8_t do_remove)
 {
   struct tsch_link *l = NULL;
+  struct tsch_neighbor *n = NULL;
   if(slotframe != NULL) {
     /* We currently support only one link per timeslot in a given slotframe. */
 
@@ -226,6 +373,14 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
       LOG_ERR("! add_link invalid timeslot: %u\n", timeslot);
       return NULL;
     }
+#if TSCH_SCHEDULE_COMPACT_LINKS
+    /* Compact links store the channel offset on 8 bits */
+    if(channel_offset > UINT8_MAX) {
+      LOG_ERR("! add_link invalid channel offset for compact links: %u\n",
+              channel_offset);
+      return NULL;
+    }
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
 
     if(do_remove) {
       /* Start with removing any link currently installed at this timeslot
@@ -239,6 +394,18 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         l = NULL;
       }
     }
+    if(address == NULL) {
+      address = &linkaddr_null;
+    }
+#if TSCH_SCHEDULE_COMPACT_LINKS
+    /* Compact links refer to their neighbor by index: add the neighbor
+     * first (this takes the lock). linkaddr_null maps to the EB neighbor. */
+    n = tsch_queue_add_nbr(address);
+    if(n == NULL) {
+      LOG_ERR("! add_link could not add neighbor\n");
+      return NULL;
+    }
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
     if(!tsch_get_lock()) {
       LOG_ERR("! add_link memb_alloc couldn't take lock\n");
     } else {
@@ -248,7 +415,6 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         tsch_release_lock();
       } else {
         static int current_link_handle = 0;
-        struct tsch_neighbor *n;
         /* Add the link to the slotframe */
         list_add(slotframe->links_list, l);
         /* Initialize link */
@@ -259,10 +425,16 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         l->timeslot = timeslot;
         l->channel_offset = channel_offset;
         l->data = NULL;
-        if(address == NULL) {
-          address = &linkaddr_null;
-        }
+#if TSCH_SCHEDULE_COMPACT_LINKS
+        l->nbr_index = tsch_queue_get_nbr_index(n);
+        n->links_count++;
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
         linkaddr_copy(&l->addr, address);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+        link_index_add(link_index_by_handle, link_hash_handle, l);
+        link_index_add(link_index_by_timeslot, link_hash_timeslot, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -274,7 +446,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         tsch_release_lock();
 
         if(l->link_options & LINK_OPTION_TX) {
+#if !TSCH_SCHEDULE_COMPACT_LINKS
           n = tsch_queue_add_nbr(&l->addr);
+#endif /* !TSCH_SCHEDULE_COMPACT_LINKS */
           /* We have a tx link to this neighbor, update counters */
           if(n != NULL) {
             n->tx_links_count++;
@@ -296,12 +470,23 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
   if(slotframe != NULL && l != NULL && l->slotframe_handle == slotframe->handle) {
     if(tsch_get_lock()) {
       uint8_t link_options;
+#if LINK_STATS_PER_CELL_ETX
+      uint16_t handle = l->handle;
+#endif /* LINK_STATS_PER_CELL_ETX */
+#if TSCH_SCHEDULE_COMPACT_LINKS
+      struct tsch_neighbor *n = tsch_queue_get_nbr_by_index(l->nbr_index);
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
       linkaddr_t addr;
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
 
       /* Save link option and addr in local variables as we need them
        * after freeing the link */
       link_options = l->link_options;
+#if TSCH_SCHEDULE_COMPACT_LINKS
+      n->links_count--;
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
       linkaddr_copy(&addr, &l->addr);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
 
       /* The link to be removed is scheduled as next, set it to NULL
        * to abort the next link operation */
@@ -312,10 +497,14 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
                slotframe->handle,
                print_link_options(l->link_options),
                print_link_type(l->link_type), l->timeslot, l->channel_offset);
-      LOG_INFO_LLADDR(&l->addr);
+      LOG_INFO_LLADDR(tsch_schedule_get_link_addr(l));
       LOG_INFO_("\n");
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      link_index_remove(link_index_by_handle, link_hash_handle, l);
+      link_index_remove(link_index_by_timeslot, link_hash_timeslot, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -323,7 +512,17 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
 
       /* This was a tx link to this neighbor, update counters */
       if(link_options & LINK_OPTION_TX) {
+#if !TSCH_SCHEDULE_COMPACT_LINKS
         struct tsch_neighbor *n = tsch_queue_get_nbr(&addr);
+#endif /* !TSCH_SCHEDULE_COMPACT_LINKS */
+#if LINK_STATS_PER_CELL_ETX
+        /* The neighbor's ETX no longer includes this cell, e.g. after a relocation */
+#if TSCH_SCHEDULE_COMPACT_LINKS
+        link_stats_cell_removed(tsch_queue_get_nbr_address(n), handle);
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
+        link_stats_cell_removed(&addr, handle);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+#endif /* LINK_STATS_PER_CELL_ETX */
         if(n != NULL) {
           n->tx_links_count--;
           if(!(link_options & LINK_OPTION_SHARED)) {
@@ -349,6 +548,17 @@ tsch_schedule_remove_link_by_offsets(struct tsch_slotframe *slotframe,
   int ret = 0;
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      struct tsch_link *l;
+      /* Remove all matching links */
+      while((l = link_index_get_by_offsets(slotframe->handle,
+                                           timeslot, channel_offset)) != NULL) {
+        if(!tsch_schedule_remove_link(slotframe, l)) {
+          break;
+        }
+        ret = 1;
+      }
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items and remove all matching links */
       while(l != NULL) {
@@ -360,6 +570,7 @@ tsch_schedule_remove_link_by_offsets(struct tsch_slotframe *slotframe,
         }
         l = next;
       }
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     }
   }
   return ret;
@@ -373,6 +584,10 @@ tsch_schedule_get_link_by_offsets(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      return link_index_get_by_offsets(slotframe->handle,
+                                       timeslot, channel_offset);
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot
          and channel_offset */
@@ -383,6 +598,7 @@ tsch_schedule_get_link_by_offsets(struct tsch_slotframe *slotframe,
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     }
   }
   return NULL;
@@ -395,6 +611,9 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      return link_index_get_by_offsets(slotframe->handle, timeslot, 0xffff);
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
@@ -404,6 +623,7 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     }
   }
   return NULL;
@@ -418,9 +638,9 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   }
 
   /* Two Tx links at the same slotframe; return the one with most packets to send */
-  if(!linkaddr_cmp(&a->addr, &b->addr)) {
-    struct tsch_neighbor *an = tsch_queue_get_nbr(&a->addr);
-    struct tsch_neighbor *bn = tsch_queue_get_nbr(&b->addr);
+  if(!linkaddr_cmp(tsch_schedule_get_link_addr(a), tsch_schedule_get_link_addr(b))) {
+    struct tsch_neighbor *an = tsch_schedule_get_link_nbr(a);
+    struct tsch_neighbor *bn = tsch_schedule_get_link_nbr(b);
     int a_packet_count = an ? ringbufindex_elements(&an->tx_ringbuf) : 0;
     int b_packet_count = bn ? ringbufindex_elements(&bn->tx_ringbuf) : 0;
     /* Compare the number of packets in the queue */
@@ -514,6 +734,196 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
   return curr_best;
 }
 /*---------------------------------------------------------------------------*/
+/* Slotframe registry. An entry with num_timeslots 0 records the owner of a
+ * slotframe handle, any other entry a timeslot range reserved by an owner */
+static struct tsch_schedule_reservation {
+  const char *owner;
+  uint16_t slotframe_handle;
+  uint16_t timeslot;
+  uint16_t num_timeslots;
+} reservations[TSCH_SCHEDULE_MAX_RESERVATIONS];
+/*---------------------------------------------------------------------------*/
+static struct tsch_schedule_reservation *
+reservation_alloc(const char *owner, uint16_t handle,
+                  uint16_t timeslot, uint16_t num_timeslots)
+{
+  int i;
+  for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS; i++) {
+    if(reservations[i].owner == NULL) {
+      reservations[i].owner = owner;
+      reservations[i].slotframe_handle = handle;
+      reservations[i].timeslot = timeslot;
+      reservations[i].num_timeslots = num_timeslots;
+      return &reservations[i];
+    }
+  }
+  LOG_ERR("! registry full, cannot register %s\n", owner);
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_same_owner(const char *a, const char *b)
+{
+  return a != NULL && b != NULL && (a == b || strcmp(a, b) == 0);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+gcd(uint16_t a, uint16_t b)
+{
+  while(b != 0) {
+    uint16_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Tells whether timeslot ts of a slotframe of size a and timeslot other_ts of
+ * a different slotframe of size b are active at a same ASN, i.e. whether
+ * ts = other_ts modulo gcd(a, b). Coprime sizes are not considered as
+ * overlapping, as every timeslot overlaps them equally often. */
+static int
+timeslots_overlap(uint16_t a, uint16_t ts, uint16_t b, uint16_t other_ts)
+{
+  uint16_t g = gcd(a, b);
+  return g > 1 && ts % g == other_ts % g;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_schedule_allocate_slotframe_handle(const char *owner, uint16_t *handle)
+{
+  uint16_t h;
+  int i;
+
+  if(owner == NULL || handle == NULL) {
+    return 0;
+  }
+
+  /* There are at most MAX_SLOTFRAMES + MAX_RESERVATIONS handles in use */
+  for(h = 0; h <= TSCH_SCHEDULE_MAX_SLOTFRAMES + TSCH_SCHEDULE_MAX_RESERVATIONS; h++) {
+    int in_use = tsch_schedule_get_slotframe_by_handle(h) != NULL;
+    for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS && !in_use; i++) {
+      in_use = reservations[i].owner != NULL
+        && reservations[i].num_timeslots == 0
+        && reservations[i].slotframe_handle == h;
+    }
+    if(!in_use) {
+      if(reservation_alloc(owner, h, 0, 0) == NULL) {
+        return 0;
+      }
+      LOG_INFO("Slotframe handle %u allocated to %s\n", h, owner);
+      *handle = h;
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_schedule_reserve_timeslots(const char *owner, uint16_t handle,
+                                uint16_t timeslot, uint16_t num_timeslots)
+{
+  int i;
+
+  if(owner == NULL || num_timeslots == 0) {
+    return 0;
+  }
+
+  for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS; i++) {
+    struct tsch_schedule_reservation *r = &reservations[i];
+    if(r->owner != NULL && r->num_timeslots > 0
+       && r->slotframe_handle == handle && !is_same_owner(r->owner, owner)
+       && timeslot < r->timeslot + r->num_timeslots
+       && r->timeslot < timeslot + num_timeslots) {
+      LOG_WARN("! timeslots %u-%u of slotframe %u already reserved by %s\n",
+               timeslot, timeslot + num_timeslots - 1, handle, r->owner);
+      return 0;
+    }
+  }
+
+  if(reservation_alloc(owner, handle, timeslot, num_timeslots) == NULL) {
+    return 0;
+  }
+  LOG_INFO("Timeslots %u-%u of slotframe %u reserved by %s\n",
+           timeslot, timeslot + num_timeslots - 1, handle, owner);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_schedule_release(const char *owner)
+{
+  int i;
+  for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS; i++) {
+    if(is_same_owner(reservations[i].owner, owner)) {
+      reservations[i].owner = NULL;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+const char *
+tsch_schedule_get_owner(uint16_t handle)
+{
+  int i;
+  for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS; i++) {
+    if(reservations[i].owner != NULL && reservations[i].num_timeslots == 0
+       && reservations[i].slotframe_handle == handle) {
+      return reservations[i].owner;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_schedule_is_cell_free(const char *owner, struct tsch_slotframe *slotframe,
+                           uint16_t timeslot)
+{
+  struct tsch_slotframe *sf;
+  uint16_t size;
+  int i;
+
+  if(slotframe == NULL || timeslot >= slotframe->size.val || tsch_is_locked()) {
+    return 0;
+  }
+  size = slotframe->size.val;
+
+  /* Links of the slotframe itself, and of any other slotframe */
+  if(tsch_schedule_get_link_by_timeslot(slotframe, timeslot) != NULL) {
+    return 0;
+  }
+  for(sf = list_head(slotframe_list); sf != NULL; sf = list_item_next(sf)) {
+    struct tsch_link *l;
+    if(sf == slotframe) {
+      continue;
+    }
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      if(timeslots_overlap(size, timeslot, sf->size.val, l->timeslot)) {
+        return 0;
+      }
+    }
+  }
+
+  /* Timeslot ranges reserved by other owners */
+  for(i = 0; i < TSCH_SCHEDULE_MAX_RESERVATIONS; i++) {
+    struct tsch_schedule_reservation *r = &reservations[i];
+    uint16_t ts;
+    if(r->owner == NULL || r->num_timeslots == 0 || is_same_owner(r->owner, owner)) {
+      continue;
+    }
+    if(r->slotframe_handle == slotframe->handle) {
+      if(timeslot >= r->timeslot && timeslot - r->timeslot < r->num_timeslots) {
+        return 0;
+      }
+    } else if((sf = tsch_schedule_get_slotframe_by_handle(r->slotframe_handle)) != NULL) {
+      for(ts = r->timeslot; ts - r->timeslot < r->num_timeslots; ts++) {
+        if(timeslots_overlap(size, timeslot, sf->size.val, ts)) {
+          return 0;
+        }
+      }
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 /* Module initialization, call only once at startup. Returns 1 is success, 0 if failure. */
 int
 tsch_schedule_init(void)
@@ -522,6 +932,16 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+    memset(link_index_by_handle, 0, sizeof(link_index_by_handle));
+    memset(link_index_by_timeslot, 0, sizeof(link_index_by_timeslot));
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
+    memset(reservations, 0, sizeof(reservations));
+#if TSCH_SCHEDULE_WITH_6TISCH_MINIMAL
+    /* Slotframe 0 and its shared cell belong to the minimal schedule */
+    reservation_alloc("minimal", 0, 0, 0);
+    reservation_alloc("minimal", 0, 0, 1);
+#endif /* TSCH_SCHEDULE_WITH_6TISCH_MINIMAL */
     tsch_release_lock();
     return 1;
   } else {
@@ -573,7 +993,10 @@ tsch_schedule_print(void)
     while(sf != NULL) {
       struct tsch_link *l = list_head(sf->links_list);
 
-      LOG_PRINT("Slotframe Handle %u, size %u\n", sf->handle, sf->size.val);
+      const char *owner = tsch_schedule_get_owner(sf->handle);
+
+      LOG_PRINT("Slotframe Handle %u, size %u, owner %s\n",
+                sf->handle, sf->size.val, owner != NULL ? owner : "-");
 
       while(l != NULL) {
         LOG_PRINT("* Link Options %s, type %s, timeslot %u, " \
@@ -581,7 +1004,7 @@ tsch_schedule_print(void)
                   print_link_options(l->link_options),
                   print_link_type(l->link_type),
                   l->timeslot, l->channel_offset);
-        LOG_PRINT_LLADDR(&l->addr);
+        LOG_PRINT_LLADDR(tsch_schedule_get_link_addr(l));
         LOG_PRINT_("\n");
         l = list_item_next(l);
       }
@@ -90,6 +90,60 @@ int tsch_schedule_remove_slotframe(struct tsch_slotframe *slotframe);
  */
 int tsch_schedule_remove_all_slotframes(void);
 
+/**
+ * \brief Allocates the lowest slotframe handle that is neither in use in the
+ * schedule nor owned, and records its owner in the slotframe registry. The
+ * slotframe itself is still to be added with tsch_schedule_add_slotframe.
+ * Lower handles have higher priority: owners allocating first take precedence.
+ * \param owner The owner name, e.g. "orchestra" or the name of a 6P SF
+ * \param handle A pointer where to write the allocated handle
+ * \return 1 if success, 0 if failure (registry full)
+ */
+int tsch_schedule_allocate_slotframe_handle(const char *owner, uint16_t *handle);
+
+/**
+ * \brief Reserves a range of timeslots of a slotframe for an owner. Cells of
+ * other owners are not considered free in that range (see
+ * tsch_schedule_is_cell_free)
+ * \param owner The owner name
+ * \param handle The slotframe handle
+ * \param timeslot The first timeslot of the range
+ * \param num_timeslots The length of the range
+ * \return 1 if success, 0 if failure (overlap with another owner, registry full)
+ */
+int tsch_schedule_reserve_timeslots(const char *owner, uint16_t handle,
+                                    uint16_t timeslot, uint16_t num_timeslots);
+
+/**
+ * \brief Releases all slotframe handles and timeslot ranges of an owner
+ * \param owner The owner name
+ */
+void tsch_schedule_release(const char *owner);
+
+/**
+ * \brief Looks up the owner of a slotframe handle
+ * \param handle The slotframe handle
+ * \return The owner name, NULL if the handle is not owned
+ */
+const char *tsch_schedule_get_owner(uint16_t handle);
+
+/**
+ * \brief Tells whether an owner may schedule a cell at a timeslot of one of
+ * its slotframes. The timeslot is not free if the slotframe already has a link
+ * there, or if it overlaps, at some ASN, a link of another slotframe or a
+ * timeslot range reserved by another owner. Overlaps with slotframes whose
+ * length is coprime with that of the slotframe are ignored: every timeslot
+ * overlaps them equally often, and the slotframe handles set the priority.
+ * To keep cells clear of e.g. Orchestra's, use slotframe lengths that
+ * share a factor with Orchestra's.
+ * \param owner The owner name
+ * \param slotframe The slotframe
+ * \param timeslot The timeslot within the slotframe
+ * \return 1 if the timeslot is free, 0 otherwise
+ */
+int tsch_schedule_is_cell_free(const char *owner, struct tsch_slotframe *slotframe,
+                               uint16_t timeslot);
+
 /**
  * \brief Adds a link to a slotframe
  * \param slotframe The slotframe that will contain the new link
@@ -104,6 +158,19 @@ int tsch_schedule_remove_all_slotframes(void);
 struct tsch_link *tsch_schedule_add_link(struct tsch_slotframe *slotframe,
                                          uint8_t link_options, enum link_type link_type, const linkaddr_t *address,
                                          uint16_t timeslot, uint16_t channel_offset, uint8_t do_remove);
+/**
+ * \brief Returns the address of the neighbor of a link
+ * \param link The link
+ * \return The link-layer address of the neighbor (linkaddr_null if none)
+ */
+const linkaddr_t *tsch_schedule_get_link_addr(const struct tsch_link *link);
+/**
+ * \brief Returns the TSCH neighbor of a link. With compact links, this is
+ * an array access rather than an address lookup, for the slot operation.
+ * \param link The link
+ * \return The neighbor, NULL if none
+ */
+struct tsch_neighbor *tsch_schedule_get_link_nbr(const struct tsch_link *link);
 /**
 * \brief Looks for a link from a handle
 * \param handle The target handle
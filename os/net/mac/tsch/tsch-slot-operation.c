@@ -53,6 +53,7 @@
 #include "net/mac/framer/framer-802154.h"
 #include "net/mac/tsch/tsch.h"
 #include "sys/critical.h"
+#include "sys/metrics.h"
 #include "tsch-types.h"
 #include "tsch-slot-operation.h"
 
@@ -91,6 +92,11 @@
 #error TSCH_DEQUEUED_ARRAY_SIZE must be power of two
 #endif
 
+/* Check if TSCH_CELL_TX_ARRAY_SIZE is power of two */
+#if (TSCH_CELL_TX_ARRAY_SIZE & (TSCH_CELL_TX_ARRAY_SIZE - 1)) != 0
+#error TSCH_CELL_TX_ARRAY_SIZE must be power of two
+#endif
+
 /* Truncate received drift correction information to maximum half
  * of the guard time (one fourth of TSCH_DEFAULT_TS_RX_WAIT) */
 #define SYNC_IE_BOUND ((int32_t)US_TO_RTIMERTICKS(tsch_timing_us[tsch_ts_rx_wait] / 4))
@@ -124,6 +130,12 @@ enum tsch_radio_state_off_cmd {
  * Will be processed layer by tsch_tx_process_pending */
 struct ringbufindex dequeued_ringbuf;
 struct tsch_packet *dequeued_array[TSCH_DEQUEUED_ARRAY_SIZE];
+#if LINK_STATS_PER_CELL_ETX
+/* A ringbuf storing transmission attempts per cell.
+ * Will be processed layer by tsch_tx_process_pending */
+struct ringbufindex cell_tx_ringbuf;
+struct tsch_cell_tx cell_tx_array[TSCH_CELL_TX_ARRAY_SIZE];
+#endif /* LINK_STATS_PER_CELL_ETX */
 /* A ringbuf storing incoming packets.
  * Will be processed layer by tsch_rx_process_pending */
 struct ringbufindex input_ringbuf;
@@ -169,6 +181,9 @@ static struct tsch_neighbor *current_neighbor = NULL;
 static int burst_link_scheduled = 0;
 /* Counts the length of the current burst */
 int tsch_current_burst_count = 0;
+/* Wake-up and lookahead counters */
+uint32_t tsch_slot_operation_wakeups;
+uint32_t tsch_slot_operation_skipped;
 
 /* Protothread for association */
 PT_THREAD(tsch_scan(struct pt *pt));
@@ -193,19 +208,43 @@ static uint8_t tsch_pdr_rel_cells_index_len;
 static uint8_t cell_number_relocated[MAX_ALLOCATE_CELLS] = {0};
 static uint8_t cell_number_relocated_len = 0;
 
+/* Event-driven housekeeping: transmissions since the last evaluation */
+static struct process *housekeeping_process;
+static uint16_t tx_since_evaluation;
+static volatile uint8_t housekeeping_pending;
+
+/* Relocation threshold on the failure ratio, in per mille, set at runtime */
+static uint16_t relocate_thres = (uint16_t)(RELOCATE_PDRTHRES * 1000 + 0.5);
+
+/* Transmission counters of every evaluated cell, indexed by slot offset */
+METRICS_GAUGE(cell_tx_total, "cell_tx_total");
+METRICS_GAUGE(cell_tx_success, "cell_tx_success");
+
+/* Is the cell's failure ratio above the relocation threshold? */
+static int cell_is_bad(const tsch_schedule_cell_stats *cell){
+  return cell->tx_total > 0
+    && (uint32_t)(cell->tx_total - cell->tx_success) * 1000 > (uint32_t)relocate_thres * cell->tx_total;
+}
+
 /* takes pointer to a cell list and fills it with cells that need to be relocated and returns the amount of cells evaluated */
 int tsch_stats_evaluate_cells_for_relocation(tsch_schedule_cell_stats *rel_return_list, uint8_t *return_list_len){
   uint8_t evaluated_cells = 0;
   tsch_pdr_rel_cells_index_len = 0;
+  tx_since_evaluation = 0;
+  housekeeping_pending = 0;
 
   /* go through all cells with pdr stats */
   // printf("tsch-slot-operation: Looking at %u cells\n", pdrCellList.cellAmount);
   for(int i=0; i<pdrCellList.cellAmount; i++){
     tsch_schedule_cell_stats *currentCell = &(pdrCellList.cellList[i]);
+#if TSCH_LOG_CELL_EVALUATION
     printf("tsch-slot-operation: looking at cell %u tx-total:%u tx-success:%u and is relevant: %u\n", currentCell->slotOffset, currentCell->tx_total, currentCell->tx_success, currentCell->isStatisticallyRelevant);
+#endif
+    metrics_gauge_set_at(&cell_tx_total, currentCell->slotOffset, currentCell->tx_total);
+    metrics_gauge_set_at(&cell_tx_success, currentCell->slotOffset, currentCell->tx_success);
 
     if(currentCell->isStatisticallyRelevant && currentCell->tx_total > 0){
-      if((1.0f - ((float) currentCell->tx_success /(float) currentCell->tx_total)) > RELOCATE_PDRTHRES){
+      if(cell_is_bad(currentCell)){
         /* add cell to relocation list and increase list length */
         rel_return_list[*return_list_len] = *currentCell;
         (*return_list_len)++;
@@ -248,6 +287,44 @@ void tsch_stats_delete_cells_pdr_list(){
 }
 
 
+uint8_t tsch_stats_cell_count(void){
+  return pdrCellList.cellAmount;
+}
+
+const tsch_schedule_cell_stats *tsch_stats_cell_at(uint8_t i){
+  return i < pdrCellList.cellAmount ? &pdrCellList.cellList[i] : NULL;
+}
+
+uint16_t tsch_stats_get_relocate_thres(void){
+  return relocate_thres;
+}
+
+void tsch_stats_set_relocate_thres(uint16_t permille){
+  relocate_thres = MIN(permille, 1000);
+}
+
+void tsch_stats_set_housekeeping_process(struct process *p){
+  housekeeping_process = p;
+}
+
+int tsch_stats_housekeeping_pending(void){
+  return housekeeping_pending;
+}
+
+/* Called from slot operation after a cell's counters were updated */
+static void housekeeping_check(const tsch_schedule_cell_stats *cell, uint8_t was_bad){
+  uint8_t is_bad = cell->isStatisticallyRelevant && cell_is_bad(cell);
+
+  tx_since_evaluation++;
+  if((is_bad && !was_bad)
+     || tx_since_evaluation >= (uint16_t)HOUSEKEEPING_NEW_TX_PER_CELL * pdrCellList.cellAmount){
+    housekeeping_pending = 1;
+  }
+  if(housekeeping_pending && housekeeping_process != NULL){
+    process_poll(housekeeping_process);
+  }
+}
+
 void print_cell_pdr_list(){
   printf("Python: ");
   for(int i=0; i<cell_number_relocated_len; i++){
@@ -466,7 +543,7 @@ get_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **
       /* NORMAL link or no EB to send, pick a data packet */
       if(p == NULL) {
         /* Get neighbor queue associated to the link and get packet from it */
-        n = tsch_queue_get_nbr(&link->addr);
+        n = tsch_schedule_get_link_nbr(link);
         p = tsch_queue_get_packet_for_nbr(n, link);
         /* if it is a broadcast slot and there were no broadcast packets, pick any unicast packet */
         if(p == NULL && n == n_broadcast) {
@@ -490,9 +567,85 @@ void update_link_backoff(struct tsch_link *link) {
       && (link->link_options & LINK_OPTION_SHARED)) {
     /* Decrement the backoff window for all neighbors able to transmit over
      * this Tx, Shared link. */
-    tsch_queue_update_all_backoff_windows(&link->addr);
+    tsch_queue_update_all_backoff_windows(tsch_schedule_get_link_addr(link));
   }
 }
+#if TSCH_SCHEDULE_LOOKAHEAD
+/*---------------------------------------------------------------------------*/
+/* Is this a Tx-only link with nothing to send? Conservative: queued EBs
+ * count regardless of the join hopping sequence, and no link is idle
+ * shortly after a packet was queued. */
+static int
+link_is_idle(struct tsch_link *link, struct tsch_link *backup)
+{
+  struct tsch_neighbor *n;
+
+  if(TSCH_ASN_DIFF(tsch_current_asn, tsch_queue_last_enqueue_asn) < TSCH_SCHEDULE_LOOKAHEAD_IDLE_SLOTS
+     || backup != NULL
+     || (link->link_options & LINK_OPTION_RX)
+     || !(link->link_options & LINK_OPTION_TX)
+     || tsch_is_locked()) {
+    return 0;
+  }
+  if(link->link_type == LINK_TYPE_ADVERTISING || link->link_type == LINK_TYPE_ADVERTISING_ONLY) {
+    if(tsch_queue_get_packet_for_nbr(n_eb, link) != NULL) {
+      return 0;
+    }
+  }
+  if(link->link_type != LINK_TYPE_ADVERTISING_ONLY) {
+    n = tsch_schedule_get_link_nbr(link);
+    if(tsch_queue_get_packet_for_nbr(n, link) != NULL) {
+      return 0;
+    }
+    if(n == n_broadcast && tsch_queue_get_unicast_packet_for_any(&n, link) != NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+#endif /* TSCH_SCHEDULE_LOOKAHEAD */
+/*---------------------------------------------------------------------------*/
+/* Get the next link to wake up for, and the number of slots until then.
+ * With TSCH_SCHEDULE_LOOKAHEAD, up to that many idle links are skipped;
+ * their Tx backoff is accounted for as if they had run. */
+static struct tsch_link *
+get_next_link_to_wake_up_for(uint16_t *timeslot_diff, struct tsch_link **backup)
+{
+  struct tsch_link *link;
+#if TSCH_SCHEDULE_LOOKAHEAD
+  struct tsch_asn_t asn = tsch_current_asn;
+  uint16_t diff = 0;
+  uint16_t skipped_diff = 0;
+  uint8_t skipped = 0;
+
+  link = tsch_schedule_get_next_active_link(&asn, &diff, backup);
+  while(link != NULL && skipped < TSCH_SCHEDULE_LOOKAHEAD
+        && link_is_idle(link, *backup)) {
+    struct tsch_asn_t next_asn = asn;
+    struct tsch_link *next_backup;
+    struct tsch_link *next;
+    uint16_t next_diff;
+
+    TSCH_ASN_INC(next_asn, diff);
+    next = tsch_schedule_get_next_active_link(&next_asn, &next_diff, &next_backup);
+    if(next == NULL || (uint32_t)skipped_diff + diff + next_diff > 0xffff) {
+      break;
+    }
+    update_link_backoff(link);
+    skipped_diff += diff;
+    asn = next_asn;
+    diff = next_diff;
+    link = next;
+    *backup = next_backup;
+    skipped++;
+  }
+  tsch_slot_operation_skipped += skipped;
+  *timeslot_diff = skipped_diff + diff;
+#else /* TSCH_SCHEDULE_LOOKAHEAD */
+  link = tsch_schedule_get_next_active_link(&tsch_current_asn, timeslot_diff, backup);
+#endif /* TSCH_SCHEDULE_LOOKAHEAD */
+  return link;
+}
 /*---------------------------------------------------------------------------*/
 uint64_t
 tsch_get_network_uptime_ticks(void)
@@ -675,6 +828,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         static rtimer_clock_t tx_duration;
 
 #if TSCH_CCA_ENABLED
+        tsch_slot_timing_mark(TSCH_SLOT_TX_PREPARE, current_slot_start, tsch_timing[tsch_ts_cca_offset]);
         cca_status = 1;
         /* delay before CCA */
         TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, tsch_timing[tsch_ts_cca_offset], "cca");
@@ -691,6 +845,9 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         } else
 #endif /* TSCH_CCA_ENABLED */
         {
+#if !TSCH_CCA_ENABLED
+          tsch_slot_timing_mark(TSCH_SLOT_TX_PREPARE, current_slot_start, tsch_timing[tsch_ts_tx_offset] - RADIO_DELAY_BEFORE_TX);
+#endif /* !TSCH_CCA_ENABLED */
           /* delay before TX */
           TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, tsch_timing[tsch_ts_tx_offset] - RADIO_DELAY_BEFORE_TX, "TxBeforeTx");
           TSCH_DEBUG_TX_EVENT();
@@ -705,6 +862,8 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
           tx_duration = MIN(tx_duration, tsch_timing[tsch_ts_max_tx]);
           /* turn tadio off -- will turn on again to wait for ACK if needed */
           tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
+          tsch_slot_timing_mark(TSCH_SLOT_TX_TRANSMIT, tx_start_time,
+              tx_duration + tsch_timing[tsch_ts_rx_ack_delay] - RADIO_DELAY_BEFORE_RX);
 
           if(mac_tx_status == RADIO_TX_OK) {
             if(do_wait_for_ack) {
@@ -748,6 +907,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
 
               /* Read ack frame */
               ack_len = NETSTACK_RADIO.read((void *)ackbuf, sizeof(ackbuf));
+              tsch_slot_timing_mark(TSCH_SLOT_TX_ACK, ack_start_time, tsch_timing[tsch_ts_max_ack]);
 
               is_time_source = 0;
               /* The radio driver should return 0 if no valid packets are in the rx buffer */
@@ -836,6 +996,21 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       ringbufindex_put(&dequeued_ringbuf);
     }
 
+#if LINK_STATS_PER_CELL_ETX
+    /* Report unicast attempts per cell, processed by tsch_tx_process_pending.
+     * Attempts are not reported if the ringbuf is full. */
+    if(!current_neighbor->is_broadcast) {
+      int16_t cell_tx_index = ringbufindex_peek_put(&cell_tx_ringbuf);
+      if(cell_tx_index != -1) {
+        struct tsch_cell_tx *cell_tx = &cell_tx_array[cell_tx_index];
+        linkaddr_copy(&cell_tx->addr, tsch_queue_get_nbr_address(current_neighbor));
+        cell_tx->link_handle = current_link->handle;
+        cell_tx->status = mac_tx_status;
+        ringbufindex_put(&cell_tx_ringbuf);
+      }
+    }
+#endif /* LINK_STATS_PER_CELL_ETX */
+
     /* If this is an unicast packet to timesource, update stats for this cell */
     if(current_neighbor != NULL && current_neighbor->is_time_source && current_link->timeslot != 0) {
       tsch_stats_tx_packet(current_neighbor, mac_tx_status, tsch_current_channel);
@@ -845,7 +1020,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       tsch_schedule_cell_stats *currentCell = tsch_stats_get_cell_pdr(current_link->timeslot);
       uint8_t skip_cell_stats = 0;
       // if cell has been tracked already then increment counters dependent on 6P ack
-      for(int ind = 0; ind<tsch_pdr_rel_cells_index_len; ind++){
+      for(int ind = 0; currentCell != NULL && ind<tsch_pdr_rel_cells_index_len; ind++){
         if(tsch_pdr_rel_cells_index[ind].timeslot == currentCell->slotOffset){
           skip_cell_stats = 1;
           break;
@@ -853,6 +1028,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       }   
 
       if(currentCell != NULL && skip_cell_stats == 0){
+        uint8_t was_bad = currentCell->isStatisticallyRelevant && cell_is_bad(currentCell);
         currentCell->tx_total++;
         currentCell->tx_success = (mac_tx_status == MAC_TX_OK)? (currentCell->tx_success + 1) : currentCell->tx_success;
         /* If MAX_NUMTX is reached then halve the amount for weighting */
@@ -861,6 +1037,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
           currentCell->tx_success = currentCell->tx_success / 2;
           currentCell->isStatisticallyRelevant = 1;
         }
+        housekeeping_check(currentCell, was_bad);
       }
       else if(skip_cell_stats == 0){ /*insert values into the next free spot in the array*/
         uint8_t newCellIndex = pdrCellList.cellAmount;
@@ -899,6 +1076,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
 
     /* Poll process for later processing of packet sent events and logs */
     process_poll(&tsch_pending_events_process);
+    tsch_slot_timing_mark(TSCH_SLOT_TX_POST, current_slot_start, tsch_timing[tsch_ts_timeslot_length]);
   }
 
   TSCH_DEBUG_TX_EVENT();
@@ -948,6 +1126,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
     current_input = &input_array[input_index];
 
     /* Wait before starting to listen */
+    tsch_slot_timing_mark(TSCH_SLOT_RX_PREPARE, current_slot_start, tsch_timing[tsch_ts_rx_offset] - RADIO_DELAY_BEFORE_RX);
     TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, tsch_timing[tsch_ts_rx_offset] - RADIO_DELAY_BEFORE_RX, "RxBeforeListen");
     TSCH_DEBUG_RX_EVENT();
 
@@ -1082,11 +1261,15 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
                 NETSTACK_RADIO.prepare((const void *)ack_buf, ack_len);
 
                 /* Wait for time to ACK and transmit ACK */
+                tsch_slot_timing_mark(TSCH_SLOT_RX_RECEIVE, rx_start_time,
+                                      packet_duration + tsch_timing[tsch_ts_tx_ack_delay] - RADIO_DELAY_BEFORE_TX);
                 TSCH_SCHEDULE_AND_YIELD(pt, t, rx_start_time,
                                         packet_duration + tsch_timing[tsch_ts_tx_ack_delay] - RADIO_DELAY_BEFORE_TX, "RxBeforeAck");
                 TSCH_DEBUG_RX_EVENT();
                 NETSTACK_RADIO.transmit(ack_len);
                 tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
+                tsch_slot_timing_mark(TSCH_SLOT_RX_ACK, rx_start_time,
+                                      packet_duration + tsch_timing[tsch_ts_tx_ack_delay] + tsch_timing[tsch_ts_max_ack]);
 
                 /* Schedule a burst link iff the frame pending bit was set */
                 burst_link_scheduled = tsch_packet_get_frame_pending(current_input->payload, current_input->len);
@@ -1137,6 +1320,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
       }
 
       tsch_radio_off(TSCH_RADIO_CMD_OFF_END_OF_TIMESLOT);
+      tsch_slot_timing_mark(TSCH_SLOT_RX_POST, current_slot_start, tsch_timing[tsch_ts_timeslot_length]);
     }
 
     if(input_queue_drop != 0) {
@@ -1179,6 +1363,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
       int is_active_slot;
       TSCH_DEBUG_SLOT_START();
       tsch_in_slot_operation = 1;
+      tsch_slot_operation_wakeups++;
       /* Measure on-air noise level while TSCH is idle */
       tsch_stats_sample_rssi();
       /* Reset drift correction */
@@ -1280,7 +1465,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
           tsch_current_burst_count++;
         } else {
           /* Get next active link */
-          current_link = tsch_schedule_get_next_active_link(&tsch_current_asn, &timeslot_diff, &backup_link);
+          current_link = get_next_link_to_wake_up_for(&timeslot_diff, &backup_link);
           if(current_link == NULL) {
             /* There is no next link. Fall back to default
              * behavior: wake up at the next slot. */
@@ -44,6 +44,7 @@
 
 #include "contiki.h"
 #include "lib/ringbufindex.h"
+#include "net/link-stats.h"
 
 /***** External Variables *****/
 
@@ -51,6 +52,12 @@
  * Will be processed layer by tsch_tx_process_pending */
 extern struct ringbufindex dequeued_ringbuf;
 extern struct tsch_packet *dequeued_array[TSCH_DEQUEUED_ARRAY_SIZE];
+#if LINK_STATS_PER_CELL_ETX
+/* A ringbuf storing transmission attempts per cell.
+ * Will be processed layer by tsch_tx_process_pending */
+extern struct ringbufindex cell_tx_ringbuf;
+extern struct tsch_cell_tx cell_tx_array[TSCH_CELL_TX_ARRAY_SIZE];
+#endif /* LINK_STATS_PER_CELL_ETX */
 /* A ringbuf storing incoming packets.
  * Will be processed layer by tsch_rx_process_pending */
 extern struct ringbufindex input_ringbuf;
@@ -59,12 +66,23 @@ extern struct input_packet input_array[TSCH_MAX_INCOMING_PACKETS];
 extern clock_time_t tsch_last_sync_time;
 /* Counts the length of the current burst */
 extern int tsch_current_burst_count;
+/* Number of slots the slot operation woke up for */
+extern uint32_t tsch_slot_operation_wakeups;
+/* Number of idle Tx links skipped by the lookahead, see TSCH_SCHEDULE_LOOKAHEAD */
+extern uint32_t tsch_slot_operation_skipped;
 
 
 /* BA-Benjamin PDR additions START */
 #define MAX_ALLOCATE_CELLS 60
+#ifndef RELOCATE_PDRTHRES
 #define RELOCATE_PDRTHRES 0.5
+#endif
 #define MAX_NUM_TX 32
+/* Request housekeeping once this many transmissions per tracked cell
+ * happened since the last evaluation */
+#ifndef HOUSEKEEPING_NEW_TX_PER_CELL
+#define HOUSEKEEPING_NEW_TX_PER_CELL MAX_NUM_TX
+#endif
 
 typedef struct{
     uint8_t slotOffset;
@@ -84,6 +102,17 @@ tsch_schedule_cell_stats *tsch_stats_get_cell_pdr(uint16_t slotOffset);
 int tsch_stats_evaluate_cells_for_relocation(tsch_schedule_cell_stats *rel_return_list, uint8_t *return_list_len);
 void tsch_stats_delete_cells_pdr_list();
 void print_cell_pdr_list();
+/* Read access to the per-cell statistics, for the shell and CoAP */
+uint8_t tsch_stats_cell_count(void);
+const tsch_schedule_cell_stats *tsch_stats_cell_at(uint8_t i);
+/* Runtime relocation threshold on the failure ratio, in per mille.
+ * Defaults to RELOCATE_PDRTHRES */
+uint16_t tsch_stats_get_relocate_thres(void);
+void tsch_stats_set_relocate_thres(uint16_t permille);
+/* Process polled from slot operation when a relocation evaluation is due:
+ * enough new transmissions, or a relevant cell crossed RELOCATE_PDRTHRES */
+void tsch_stats_set_housekeeping_process(struct process *p);
+int tsch_stats_housekeeping_pending(void);
 
 
 /* BA-Benjamin PDR additions END */
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+ */
+
+/**
+ * \file
+ *         Slot timing profiler
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-slot-timing.h"
+#include <string.h>
+#include <stdio.h>
+
+static const char *const phase_names[TSCH_SLOT_NUM_PHASES] = {
+  "tx-prepare", "tx-transmit", "tx-ack", "tx-post",
+  "rx-prepare", "rx-receive", "rx-ack", "rx-post"
+};
+
+/*---------------------------------------------------------------------------*/
+const char *
+tsch_slot_timing_phase_name(enum tsch_slot_phase phase)
+{
+  return phase < TSCH_SLOT_NUM_PHASES ? phase_names[phase] : "?";
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_slot_timing_hist_mean(const struct tsch_slot_timing_hist *h)
+{
+  uint32_t count = h->count - h->misses;
+
+  return count == 0 ? 0 : (uint32_t)(h->sum / count);
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_WITH_SLOT_TIMING
+
+static struct tsch_slot_timing_hist hists[TSCH_SLOT_NUM_PHASES];
+
+/*---------------------------------------------------------------------------*/
+void
+tsch_slot_timing_mark(enum tsch_slot_phase phase,
+                      rtimer_clock_t ref_time, rtimer_clock_t deadline)
+{
+  struct tsch_slot_timing_hist *h = &hists[phase];
+  int32_t margin = (int32_t)deadline - (int32_t)RTIMER_CLOCK_DIFF(RTIMER_NOW(), ref_time);
+  uint32_t v;
+  uint8_t bin = 0;
+
+  if(h->count == 0 || margin < h->min_margin) {
+    h->min_margin = margin;
+  }
+  h->count++;
+
+  if(margin < 0) {
+    h->misses++;
+    TSCH_LOG_ADD(tsch_log_message,
+                 snprintf(log->message, sizeof(log->message),
+                          "!late %s by %ld", phase_names[phase], (long)-margin);
+    );
+    return;
+  }
+
+  /* bin = 1 + floor(log2(margin)), saturated to the last bin */
+  v = margin;
+  if(v > 0) {
+    bin = 1;
+    while(v > 1 && bin < TSCH_SLOT_TIMING_NUM_BINS - 1) {
+      v >>= 1;
+      bin++;
+    }
+  }
+  if(h->bins[bin] < 0xffff) {
+    h->bins[bin]++;
+  }
+  h->sum += margin;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_slot_timing_hist *
+tsch_slot_timing_get(enum tsch_slot_phase phase)
+{
+  return phase < TSCH_SLOT_NUM_PHASES ? &hists[phase] : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_slot_timing_reset(void)
+{
+  if(tsch_get_lock()) {
+    memset(hists, 0, sizeof(hists));
+    tsch_release_lock();
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_WITH_SLOT_TIMING */
+/** @} */
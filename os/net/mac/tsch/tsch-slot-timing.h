@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+ */
+
+/**
+ * \file
+ *         Slot timing profiler. At the end of every phase of Tx and Rx
+ *         slots, the margin left to the deadline of the next phase, e.g.
+ *         tsch_timing[tsch_ts_tx_offset] for the preparation of a Tx
+ *         slot, is added to a log2 histogram of the phase. Deadline
+ *         misses are counted and logged through the TSCH log.
+ *
+ *         Enable with TSCH_CONF_WITH_SLOT_TIMING. Updates run in the
+ *         slot operation and cost a few shifts and additions.
+ */
+
+#ifndef TSCH_SLOT_TIMING_H_
+#define TSCH_SLOT_TIMING_H_
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-conf.h"
+
+/** \brief The profiled phases of the slot operation */
+enum tsch_slot_phase {
+  TSCH_SLOT_TX_PREPARE,  /* Packet copied to the radio, before CCA or Tx */
+  TSCH_SLOT_TX_TRANSMIT, /* Packet sent, before the ACK window */
+  TSCH_SLOT_TX_ACK,      /* ACK received or timed out */
+  TSCH_SLOT_TX_POST,     /* Queue and stats updated, end of the slot */
+  TSCH_SLOT_RX_PREPARE,  /* Before listening */
+  TSCH_SLOT_RX_RECEIVE,  /* Frame parsed and ACK prepared, before the ACK */
+  TSCH_SLOT_RX_ACK,      /* ACK sent */
+  TSCH_SLOT_RX_POST,     /* Input queued and stats updated, end of the slot */
+  TSCH_SLOT_NUM_PHASES
+};
+
+/** \brief Margins to the deadline of a phase, in rtimer ticks. The sum is
+ * 64-bit, as 32 bits overflow within hours at 1 MHz rtimers. */
+struct tsch_slot_timing_hist {
+  uint32_t count;
+  uint32_t misses;
+  uint64_t sum;
+  int32_t min_margin;
+  uint16_t bins[TSCH_SLOT_TIMING_NUM_BINS];
+};
+
+#if TSCH_WITH_SLOT_TIMING
+
+/**
+ * \brief Mark the end of a phase, called from the slot operation
+ * \param phase The phase that ends now
+ * \param ref_time The reference time of the deadline, e.g. the slot start
+ * \param deadline The offset of the deadline from ref_time
+ */
+void tsch_slot_timing_mark(enum tsch_slot_phase phase,
+                           rtimer_clock_t ref_time, rtimer_clock_t deadline);
+
+/**
+ * \brief Get the histogram of a phase
+ * \param phase The phase
+ * \return The histogram, NULL for an invalid phase
+ */
+const struct tsch_slot_timing_hist *tsch_slot_timing_get(enum tsch_slot_phase phase);
+
+/**
+ * \brief Clear all histograms
+ */
+void tsch_slot_timing_reset(void);
+
+#else /* TSCH_WITH_SLOT_TIMING */
+
+#define tsch_slot_timing_mark(phase, ref_time, deadline)
+#define tsch_slot_timing_get(phase) ((const struct tsch_slot_timing_hist *)NULL)
+#define tsch_slot_timing_reset()
+
+#endif /* TSCH_WITH_SLOT_TIMING */
+
+/**
+ * \brief Name of a phase, for logs and shell output
+ */
+const char *tsch_slot_timing_phase_name(enum tsch_slot_phase phase);
+
+/**
+ * \brief Mean margin of a histogram, in rtimer ticks, misses excluded
+ */
+uint32_t tsch_slot_timing_hist_mean(const struct tsch_slot_timing_hist *h);
+
+/**
+ * \brief Lower bound, in rtimer ticks, of a histogram bin
+ */
+#define TSCH_SLOT_TIMING_BIN_MIN(bin) ((bin) == 0 ? 0 : 1ul << ((bin) - 1))
+
+#endif /* TSCH_SLOT_TIMING_H_ */
+/** @} */
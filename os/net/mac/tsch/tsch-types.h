@@ -47,12 +47,49 @@
 #include "net/mac/tsch/tsch-asn.h"
 #include "lib/list.h"
 #include "lib/ringbufindex.h"
+#include "net/nbr-table.h"
 
 /********** Data types **********/
 
 /** \brief 802.15.4e link types. LINK_TYPE_ADVERTISING_ONLY is an extra one: for EB-only links. */
 enum link_type { LINK_TYPE_NORMAL, LINK_TYPE_ADVERTISING, LINK_TYPE_ADVERTISING_ONLY };
 
+#if TSCH_SCHEDULE_COMPACT_LINKS
+
+/** \brief Index of a neighbor in the TSCH neighbor table */
+#if NBR_TABLE_MAX_NEIGHBORS <= 256
+typedef uint8_t tsch_nbr_index_t;
+#else
+typedef uint16_t tsch_nbr_index_t;
+#endif
+
+/** \brief An IEEE 802.15.4-2015 TSCH link, compact representation.
+ * Use tsch_schedule_get_link_addr() to get the neighbor address.
+ * Slotframe handles and channel offsets are stored on 8 bits: larger
+ * values are rejected when adding slotframes and links. */
+struct tsch_link {
+  /* Links are stored as a list: "next" must be the first field */
+  struct tsch_link *next;
+  /* Any other data for upper layers */
+  void *data;
+  /* Unique identifier */
+  uint16_t handle;
+  /* Timeslot for this link */
+  uint16_t timeslot;
+  /* Slotframe identifier */
+  uint8_t slotframe_handle;
+  /* Channel offset for this link */
+  uint8_t channel_offset;
+  /* Index of the neighbor in the TSCH neighbor table */
+  tsch_nbr_index_t nbr_index;
+  /* b0 = Transmit, b1 = Receive, b2 = Shared, b3 = Timekeeping, b4 = reserved */
+  uint8_t link_options : 5;
+  /* Type of link, an enum link_type */
+  uint8_t link_type : 3;
+};
+
+#else /* TSCH_SCHEDULE_COMPACT_LINKS */
+
 /** \brief An IEEE 802.15.4-2015 TSCH link (also called cell or slot) */
 struct tsch_link {
   /* Links are stored as a list: "next" must be the first field */
@@ -80,6 +117,8 @@ struct tsch_link {
   void *data;
 };
 
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+
 /** \brief 802.15.4e slotframe (contains links) */
 struct tsch_slotframe {
   /* Slotframes are stored as a list: "next" must be the first field */
@@ -93,6 +132,13 @@ struct tsch_slotframe {
   LIST_STRUCT(links_list);
 };
 
+/** \brief Log2 histogram of latencies, in timeslots */
+struct tsch_latency_hist {
+  uint16_t bins[TSCH_LATENCY_NUM_BINS];
+  uint32_t sum; /* Sum of all samples, for the mean */
+  uint16_t max; /* Largest sample, saturated at 0xffff */
+};
+
 /** \brief TSCH packet information */
 struct tsch_packet {
   struct queuebuf *qb;  /* pointer to the queuebuf to be sent */
@@ -103,6 +149,10 @@ struct tsch_packet {
   uint8_t ret; /* status -- MAC return code */
   uint8_t header_len; /* length of header and header IEs (needed for link-layer security) */
   uint8_t tsch_sync_ie_offset; /* Offset within the frame used for quick update of EB ASN and join priority */
+#if TSCH_WITH_LATENCY
+  struct tsch_asn_t enqueue_asn; /* ASN at which the packet was queued */
+  struct tsch_asn_t dequeue_asn; /* ASN of the first transmission */
+#endif /* TSCH_WITH_LATENCY */
 };
 
 /** \brief TSCH neighbor information */
@@ -113,6 +163,13 @@ struct tsch_neighbor {
   uint16_t backoff_window; /* CSMA backoff window (number of slots to skip) */
   uint8_t tx_links_count; /* How many links do we have to this neighbor? */
   uint8_t dedicated_tx_links_count; /* How many dedicated links do we have to this neighbor? */
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  uint16_t links_count; /* How many links (of any kind) refer to this neighbor? */
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+#if TSCH_WITH_LATENCY
+  struct tsch_latency_hist queue_latency; /* Enqueue to first transmission */
+  struct tsch_latency_hist ack_latency; /* Enqueue to ACK (or to the broadcast) */
+#endif /* TSCH_WITH_LATENCY */
   /* Array for the ringbuf. Contains pointers to packets.
    * Its size must be a power of two to allow for atomic put */
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
@@ -144,6 +201,13 @@ typedef rtimer_clock_t tsch_timeslot_timing_ticks[tsch_ts_elements_count];
 /** \brief TSCH timeslot timing elements in micro-seconds */
 typedef uint16_t tsch_timeslot_timing_usec[tsch_ts_elements_count];
 
+/** \brief A transmission attempt on a cell, for the per-cell ETX of link-stats */
+struct tsch_cell_tx {
+  linkaddr_t addr; /* Destination of the packet */
+  uint16_t link_handle; /* Handle of the link used */
+  uint8_t status; /* MAC return code of the attempt */
+};
+
 /** \brief Stores data about an incoming packet */
 struct input_packet {
   uint8_t payload[TSCH_PACKET_MAX_LEN]; /* Packet payload */
@@ -89,6 +89,17 @@ struct eb_stat {
 NBR_TABLE(struct eb_stat, eb_stats);
 #endif /* TSCH_AUTOSELECT_TIME_SOURCE */
 
+#if TSCH_SCAN_LEARNED
+/* Channels on which we last heard EBs. Kept across disassociations
+ * (not reset in tsch_reset), and used to order the next scan */
+struct scan_hint {
+  clock_time_t last_heard; /* When we last heard an EB on this channel */
+  struct tsch_asn_t asn; /* ASN of that EB */
+  uint8_t channel; /* The channel, 0 for unused entries */
+};
+static struct scan_hint scan_hints[TSCH_SCAN_LEARNED_MAX_CHANNELS];
+#endif /* TSCH_SCAN_LEARNED */
+
 /* TSCH channel hopping sequence */
 uint8_t tsch_hopping_sequence[TSCH_HOPPING_SEQUENCE_MAX_LEN];
 struct tsch_asn_divisor_t tsch_hopping_sequence_length;
@@ -238,6 +249,65 @@ tsch_reset(void)
   tsch_set_eb_period(TSCH_EB_PERIOD);
   keepalive_status = KEEPALIVE_SCHEDULING_UNCHANGED;
 }
+#if TSCH_SCAN_LEARNED
+/*---------------------------------------------------------------------------*/
+/* Record that an EB was heard on a channel. Updates the existing entry for
+ * that channel, or else replaces a free or the least recently heard one */
+static void
+scan_hint_update(uint8_t channel, const struct tsch_asn_t *asn)
+{
+  int i;
+  clock_time_t now = clock_time();
+  struct scan_hint *hint = NULL;
+
+  for(i = 0; i < TSCH_SCAN_LEARNED_MAX_CHANNELS; i++) {
+    if(scan_hints[i].channel == channel) {
+      hint = &scan_hints[i];
+      break;
+    }
+  }
+  if(hint == NULL) {
+    hint = &scan_hints[0];
+    for(i = 1; i < TSCH_SCAN_LEARNED_MAX_CHANNELS && hint->channel != 0; i++) {
+      if(scan_hints[i].channel == 0
+         || now - scan_hints[i].last_heard > now - hint->last_heard) {
+        hint = &scan_hints[i];
+      }
+    }
+  }
+
+  hint->channel = channel;
+  hint->last_heard = now;
+  hint->asn = *asn;
+}
+/*---------------------------------------------------------------------------*/
+/* Fill in the channels on which EBs were heard recently, most recent first.
+ * Returns the number of channels */
+static uint8_t
+scan_hint_get_channels(uint8_t *channels)
+{
+  int i, j;
+  uint8_t count = 0;
+  clock_time_t now = clock_time();
+  clock_time_t ages[TSCH_SCAN_LEARNED_MAX_CHANNELS];
+
+  for(i = 0; i < TSCH_SCAN_LEARNED_MAX_CHANNELS; i++) {
+    clock_time_t age = now - scan_hints[i].last_heard;
+    if(scan_hints[i].channel == 0 || age > TSCH_SCAN_LEARNED_MAX_AGE) {
+      continue;
+    }
+    /* Insertion sort by age, the list is tiny */
+    for(j = count; j > 0 && ages[j - 1] > age; j--) {
+      ages[j] = ages[j - 1];
+      channels[j] = channels[j - 1];
+    }
+    ages[j] = age;
+    channels[j] = scan_hints[i].channel;
+    count++;
+  }
+  return count;
+}
+#endif /* TSCH_SCAN_LEARNED */
 /* TSCH keep-alive functions */
 
 /*---------------------------------------------------------------------------*/
@@ -397,6 +467,10 @@ eb_input(struct input_packet *current_input)
                           &frame, &eb_ies, NULL, 1)) {
     /* PAN ID check and authentication done at rx time */
 
+#if TSCH_SCAN_LEARNED
+    scan_hint_update(current_input->channel, &current_input->rx_asn);
+#endif /* TSCH_SCAN_LEARNED */
+
     /* Got an EB from a different neighbor than our time source, keep enough data
      * to switch to it in case we lose the link to our time source */
     struct tsch_neighbor *ts = tsch_queue_get_time_source();
@@ -535,6 +609,17 @@ tsch_tx_process_pending(void)
 {
   uint16_t num_packets_freed = 0;
   int16_t dequeued_index;
+#if LINK_STATS_PER_CELL_ETX
+  int16_t cell_tx_index;
+
+  /* Update the per-cell statistics first, for the ETX computed
+   * in link_stats_packet_sent */
+  while((cell_tx_index = ringbufindex_peek_get(&cell_tx_ringbuf)) != -1) {
+    struct tsch_cell_tx *cell_tx = &cell_tx_array[cell_tx_index];
+    link_stats_cell_packet_sent(&cell_tx->addr, cell_tx->link_handle, cell_tx->status);
+    ringbufindex_get(&cell_tx_ringbuf);
+  }
+#endif /* LINK_STATS_PER_CELL_ETX */
   /* Loop on accessing (without removing) a pending input packet */
   while((dequeued_index = ringbufindex_peek_get(&dequeued_ringbuf)) != -1) {
     struct tsch_packet *p = dequeued_array[dequeued_index];
@@ -786,11 +871,25 @@ PT_THREAD(tsch_scan(struct pt *pt))
   static struct etimer scan_timer;
   /* Time when we started scanning on current_channel */
   static clock_time_t current_channel_since;
+#if TSCH_SCAN_LEARNED
+  /* Channels to try first, and how many of them were tried already */
+  static uint8_t learned_channels[TSCH_SCAN_LEARNED_MAX_CHANNELS];
+  static uint8_t learned_count;
+  static uint8_t learned_index;
+#endif /* TSCH_SCAN_LEARNED */
 
   TSCH_ASN_INIT(tsch_current_asn, 0, 0);
 
   etimer_set(&scan_timer, MAX(1, CLOCK_SECOND / TSCH_ASSOCIATION_POLL_FREQUENCY));
   current_channel_since = clock_time();
+#if TSCH_SCAN_LEARNED
+  learned_count = scan_hint_get_channels(learned_channels);
+  learned_index = 0;
+  if(learned_count > 0) {
+    /* Switch to the first learned channel right away */
+    current_channel_since -= TSCH_CHANNEL_SCAN_DURATION + 1;
+  }
+#endif /* TSCH_SCAN_LEARNED */
 
   while(!tsch_is_associated && !tsch_is_coordinator) {
     /* Hop to any channel offset */
@@ -803,9 +902,18 @@ PT_THREAD(tsch_scan(struct pt *pt))
 
     /* Switch to a (new) channel for scanning */
     if(current_channel == 0 || now_time - current_channel_since > TSCH_CHANNEL_SCAN_DURATION) {
-      /* Pick a channel at random in TSCH_JOIN_HOPPING_SEQUENCE */
-      uint8_t scan_channel = TSCH_JOIN_HOPPING_SEQUENCE[
-          random_rand() % sizeof(TSCH_JOIN_HOPPING_SEQUENCE)];
+      uint8_t scan_channel;
+#if TSCH_SCAN_LEARNED
+      if(learned_index < learned_count) {
+        /* First try the channels we recently heard EBs on */
+        scan_channel = learned_channels[learned_index++];
+      } else
+#endif /* TSCH_SCAN_LEARNED */
+      {
+        /* Pick a channel at random in TSCH_JOIN_HOPPING_SEQUENCE */
+        scan_channel = TSCH_JOIN_HOPPING_SEQUENCE[
+            random_rand() % sizeof(TSCH_JOIN_HOPPING_SEQUENCE)];
+      }
 
       NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, scan_channel);
       current_channel = scan_channel;
@@ -840,6 +948,11 @@ PT_THREAD(tsch_scan(struct pt *pt))
         /* Sanity-check the timestamp */
         if(ABS(RTIMER_CLOCK_DIFF(t0, t1)) < 2ul * RTIMER_SECOND) {
           tsch_associate(&input_eb, t0);
+#if TSCH_SCAN_LEARNED
+          if(tsch_is_associated) {
+            scan_hint_update(current_channel, &tsch_current_asn);
+          }
+#endif /* TSCH_SCAN_LEARNED */
         } else {
           LOG_WARN("scan: dropping packet, timestamp too far from current time %u %u\n",
             (unsigned)t0,
@@ -870,6 +983,8 @@ PROCESS_THREAD(tsch_process, ev, data)
 
   PROCESS_BEGIN();
 
+  process_set_priority(&tsch_process, PROCESS_PRIORITY_HIGH);
+
   while(1) {
 
     while(!tsch_is_associated) {
@@ -1067,6 +1182,9 @@ tsch_init(void)
   tsch_log_init();
   ringbufindex_init(&input_ringbuf, TSCH_MAX_INCOMING_PACKETS);
   ringbufindex_init(&dequeued_ringbuf, TSCH_DEQUEUED_ARRAY_SIZE);
+#if LINK_STATS_PER_CELL_ETX
+  ringbufindex_init(&cell_tx_ringbuf, TSCH_CELL_TX_ARRAY_SIZE);
+#endif /* LINK_STATS_PER_CELL_ETX */
 
   mac_sequence_init();
   tsch_is_initialized = 1;
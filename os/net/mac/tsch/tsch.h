@@ -61,6 +61,8 @@ frequency hopping for enhanced reliability.
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/tsch/tsch-schedule.h"
 #include "net/mac/tsch/tsch-stats.h"
+#include "net/mac/tsch/tsch-latency.h"
+#include "net/mac/tsch/tsch-slot-timing.h"
 #include "net/mac/tsch/tsch-roots.h"
 #if UIP_CONF_IPV6_RPL
 #include "net/mac/tsch/tsch-rpl.h"
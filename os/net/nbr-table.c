@@ -70,6 +70,14 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_LLADDR_INDEX
+/* Open-addressing (linear probing) index over the keys, by link-layer
+ * address. Removal uses backward-shift deletion, so that no tombstones
+ * are needed as neighbors come and go. */
+#define LLADDR_INDEX_SIZE NBR_TABLE_LLADDR_INDEX_SIZE
+static nbr_table_key_t *lladdr_index[LLADDR_INDEX_SIZE];
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -114,17 +122,86 @@ key_from_item(const nbr_table_t *table, const nbr_table_item_t *item)
 {
   return key_from_index(index_from_item(table, item));
 }
+#if NBR_TABLE_WITH_LLADDR_INDEX
+/*---------------------------------------------------------------------------*/
+static uint16_t
+hash_lladdr(const linkaddr_t *lladdr)
+{
+  uint32_t h = 0;
+  uint8_t i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + lladdr->u8[i];
+  }
+  return h % LLADDR_INDEX_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+lladdr_index_add(nbr_table_key_t *key)
+{
+  uint16_t i = hash_lladdr(&key->lladdr);
+  while(lladdr_index[i] != NULL) {
+    i = (i + 1) % LLADDR_INDEX_SIZE;
+  }
+  lladdr_index[i] = key;
+}
+/*---------------------------------------------------------------------------*/
+static void
+lladdr_index_remove(nbr_table_key_t *key)
+{
+  uint16_t i = hash_lladdr(&key->lladdr);
+  uint16_t j;
+
+  /* Find the entry */
+  while(lladdr_index[i] != key) {
+    if(lladdr_index[i] == NULL) {
+      return;
+    }
+    i = (i + 1) % LLADDR_INDEX_SIZE;
+  }
+
+  /* Shift back the following entries of the cluster that would otherwise
+   * become unreachable from their home slot */
+  j = i;
+  while(1) {
+    uint16_t k;
+    j = (j + 1) % LLADDR_INDEX_SIZE;
+    if(lladdr_index[j] == NULL) {
+      break;
+    }
+    k = hash_lladdr(&lladdr_index[j]->lladdr);
+    /* Move entry j to i unless its home slot k lies cyclically in (i, j] */
+    if(i <= j ? (k <= i || k > j) : (k <= i && k > j)) {
+      lladdr_index[i] = lladdr_index[j];
+      i = j;
+    }
+  }
+  lladdr_index[i] = NULL;
+}
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
 /*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
   nbr_table_key_t *key;
+#if NBR_TABLE_WITH_LLADDR_INDEX
+  uint16_t i;
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_LLADDR_INDEX
+  i = hash_lladdr(lladdr);
+  while((key = lladdr_index[i]) != NULL) {
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
+      return index_from_key(key);
+    }
+    i = (i + 1) % LLADDR_INDEX_SIZE;
+  }
+#else /* NBR_TABLE_WITH_LLADDR_INDEX */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -132,6 +209,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -183,6 +261,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_WITH_LLADDR_INDEX
+  lladdr_index_remove(key);
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -430,6 +511,9 @@ nbr_table_add_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr,
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_LLADDR_INDEX
+    lladdr_index_add(key);
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   }
 
   /* Get item in the current table */
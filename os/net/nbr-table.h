@@ -55,6 +55,23 @@ typedef enum {
 
 #define NBR_TABLE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
 
+/* Maintain a hash index over the link-layer addresses of the neighbors,
+ * so that lookups by lladdr do not walk the neighbor list. Costs one
+ * pointer per index entry. Worth it with large neighbor tables. */
+#ifdef NBR_TABLE_CONF_WITH_LLADDR_INDEX
+#define NBR_TABLE_WITH_LLADDR_INDEX NBR_TABLE_CONF_WITH_LLADDR_INDEX
+#else /* NBR_TABLE_CONF_WITH_LLADDR_INDEX */
+#define NBR_TABLE_WITH_LLADDR_INDEX 0
+#endif /* NBR_TABLE_CONF_WITH_LLADDR_INDEX */
+
+/* Number of entries of the lladdr index. Keep it well above
+ * NBR_TABLE_MAX_NEIGHBORS for short probe sequences. */
+#ifdef NBR_TABLE_CONF_LLADDR_INDEX_SIZE
+#define NBR_TABLE_LLADDR_INDEX_SIZE NBR_TABLE_CONF_LLADDR_INDEX_SIZE
+#else /* NBR_TABLE_CONF_LLADDR_INDEX_SIZE */
+#define NBR_TABLE_LLADDR_INDEX_SIZE (2 * NBR_TABLE_MAX_NEIGHBORS + 1)
+#endif /* NBR_TABLE_CONF_LLADDR_INDEX_SIZE */
+
 #ifdef NBR_TABLE_CONF_GC_GET_WORST
 #define NBR_TABLE_GC_GET_WORST NBR_TABLE_CONF_GC_GET_WORST
 #else /* NBR_TABLE_CONF_GC_GET_WORST */
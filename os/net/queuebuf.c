@@ -79,8 +79,8 @@ struct queuebuf_data {
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
-MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
-MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+MEMB_FREE_LIST(bufmem, struct queuebuf, QUEUEBUF_NUM);
+MEMB_FREE_LIST(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
 
 #if WITH_SWAP
 
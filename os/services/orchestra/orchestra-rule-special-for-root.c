@@ -206,4 +206,5 @@ struct orchestra_rule special_for_root = {
   root_node_updated,
   "special for root",
   ORCHESTRA_ROOT_PERIOD,
+  0,
 };
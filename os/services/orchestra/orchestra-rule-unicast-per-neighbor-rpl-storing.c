@@ -262,6 +262,7 @@ struct orchestra_rule unicast_per_neighbor_rpl_storing = {
   NULL,
   "unicast per neighbor storing",
   ORCHESTRA_UNICAST_PERIOD,
+  0,
 };
 
 #endif /* UIP_MAX_ROUTES */
@@ -61,6 +61,8 @@ NETSTACK_SNIFFER(orchestra_sniffer, orchestra_packet_received, orchestra_packet_
 linkaddr_t orchestra_parent_linkaddr;
 /* Set to one only after getting an ACK for a DAO sent to our preferred parent */
 int orchestra_parent_knows_us = 0;
+/* Set once all rules are initialized, the callbacks do nothing until then */
+static uint8_t is_initialized = 0;
 
 /* The set of Orchestra rules in use */
 const struct orchestra_rule *all_rules[] = ORCHESTRA_RULES;
@@ -92,6 +94,10 @@ orchestra_callback_child_added(const linkaddr_t *addr)
 {
   /* Notify all Orchestra rules that a child was added */
   int i;
+
+  if(!is_initialized) {
+    return;
+  }
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->child_added != NULL) {
       all_rules[i]->child_added(addr);
@@ -104,6 +110,10 @@ orchestra_callback_child_removed(const linkaddr_t *addr)
 {
   /* Notify all Orchestra rules that a child was removed */
   int i;
+
+  if(!is_initialized) {
+    return;
+  }
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->child_removed != NULL) {
       all_rules[i]->child_removed(addr);
@@ -116,6 +126,10 @@ orchestra_callback_neighbor_updated(const linkaddr_t *addr, uint8_t is_added)
 {
   /* Notify all Orchestra rules that a neighbor was added or removed */
   int i;
+
+  if(!is_initialized) {
+    return;
+  }
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->neighbor_updated != NULL) {
       all_rules[i]->neighbor_updated(addr, is_added);
@@ -136,6 +150,10 @@ orchestra_callback_packet_ready(void)
   uint16_t channel_offset = 0xffff;
   int matched_rule = -1;
 
+  if(!is_initialized) {
+    return matched_rule;
+  }
+
   /* Loop over all rules until finding one able to handle the packet */
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->select_packet != NULL) {
@@ -164,6 +182,9 @@ orchestra_callback_new_time_source(const struct tsch_neighbor *old, const struct
    * */
 
   int i;
+  if(!is_initialized) {
+    return;
+  }
   if(new != old) {
     orchestra_parent_knows_us = 0;
   }
@@ -179,6 +200,9 @@ orchestra_callback_root_node_updated(const linkaddr_t *root, uint8_t is_added)
 {
   int i;
 
+  if(!is_initialized) {
+    return;
+  }
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->root_node_updated != NULL) {
       all_rules[i]->root_node_updated(root, is_added);
@@ -186,20 +210,63 @@ orchestra_callback_root_node_updated(const linkaddr_t *root, uint8_t is_added)
   }
 }
 /*---------------------------------------------------------------------------*/
-void
+static void
+remove_rule_slotframes(int num_rules, const uint16_t *handles)
+{
+  int i;
+  for(i = 0; i < num_rules; i++) {
+    /* The root rule also has a reception slotframe, see special-for-root */
+    tsch_schedule_remove_slotframe(tsch_schedule_get_slotframe_by_handle(handles[i]));
+    tsch_schedule_remove_slotframe(tsch_schedule_get_slotframe_by_handle(handles[i] | 0x8000));
+  }
+  tsch_schedule_release(ORCHESTRA_SCHEDULE_OWNER);
+}
+/*---------------------------------------------------------------------------*/
+int
 orchestra_init(void)
 {
   int i;
+  int num_handles = 0;
+  uint16_t handles[NUM_RULES];
   /* Snoop on packet transmission to know if our parent knows about us
    * (i.e. has ACKed at one of our DAOs since we decided to use it as a parent) */
   netstack_sniffer_add(&orchestra_sniffer);
   linkaddr_copy(&orchestra_parent_linkaddr, &linkaddr_null);
-  /* Initialize all Orchestra rules */
+  /* Initialize all Orchestra rules, each with a slotframe handle from the
+   * schedule registry. Rules come first, so they keep handles 0..NUM_RULES-1
+   * unless other slotframes (e.g. the 6TiSCH minimal one) are already there */
   for(i = 0; i < NUM_RULES; i++) {
-    LOG_INFO("Initializing rule %s (%u), size %d\n", all_rules[i]->name, i, all_rules[i]->slotframe_size);
+    uint16_t num_timeslots;
+    if(!tsch_schedule_allocate_slotframe_handle(ORCHESTRA_SCHEDULE_OWNER, &handles[i])) {
+      LOG_ERR("No slotframe handle for rule %s\n", all_rules[i]->name);
+      break;
+    }
+    num_handles++;
+    LOG_INFO("Initializing rule %s (%u), size %d\n", all_rules[i]->name, handles[i], all_rules[i]->slotframe_size);
     if(all_rules[i]->init != NULL) {
-      all_rules[i]->init(i);
+      all_rules[i]->init(handles[i]);
+    }
+    if(tsch_schedule_get_slotframe_by_handle(handles[i]) == NULL) {
+      LOG_ERR("No slotframe for rule %s\n", all_rules[i]->name);
+      break;
     }
+    /* Keep the cells of other owners (e.g. 6P SFs) clear of the rule's */
+    num_timeslots = all_rules[i]->reserved_timeslots > 0 ?
+      all_rules[i]->reserved_timeslots : all_rules[i]->slotframe_size;
+    if(!tsch_schedule_reserve_timeslots(ORCHESTRA_SCHEDULE_OWNER, handles[i], 0, num_timeslots)) {
+      LOG_ERR("Could not reserve the timeslots of rule %s\n", all_rules[i]->name);
+      break;
+    }
+  }
+  if(i < NUM_RULES) {
+    /* Do not run with a partial set of rules: undo the rules initialized
+     * so far and leave the schedule to others */
+    remove_rule_slotframes(num_handles, handles);
+    netstack_sniffer_remove(&orchestra_sniffer);
+    LOG_ERR("Initialization failed\n");
+    return 0;
   }
+  is_initialized = 1;
   LOG_INFO("Initialization done\n");
+  return 1;
 }
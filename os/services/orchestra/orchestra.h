@@ -41,6 +41,9 @@
 #include "net/mac/tsch/tsch.h"
 #include "orchestra-conf.h"
 
+/* Owner of the Orchestra slotframes in the TSCH schedule registry */
+#define ORCHESTRA_SCHEDULE_OWNER "orchestra"
+
 /* The structure of an Orchestra rule */
 struct orchestra_rule {
   void (* init)(uint16_t slotframe_handle);
@@ -52,6 +55,9 @@ struct orchestra_rule {
   void (* root_node_updated)(const linkaddr_t *addr, uint8_t is_added);
   const char *const name;
   const int16_t slotframe_size;
+  /* Timeslots 0..reserved_timeslots-1 of the slotframe are reserved in the
+   * schedule registry for the rule's cells, 0 for the whole slotframe */
+  const int16_t reserved_timeslots;
 };
 
 extern struct orchestra_rule eb_per_time_source;
@@ -64,8 +70,10 @@ extern struct orchestra_rule default_common;
 extern linkaddr_t orchestra_parent_linkaddr;
 extern int orchestra_parent_knows_us;
 
-/* Call from application to start Orchestra */
-void orchestra_init(void);
+/* Call from application to start Orchestra. Returns 1 on success, 0 if a
+ * rule failed to initialize: Orchestra then leaves the schedule untouched
+ * and its callbacks do nothing */
+int orchestra_init(void);
 /* Callbacks requied for Orchestra to operate */
 /* Set with #define TSCH_CALLBACK_PACKET_READY orchestra_callback_packet_ready */
 int orchestra_callback_packet_ready(void);
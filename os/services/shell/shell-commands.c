@@ -48,6 +48,9 @@
 #include "lib/list.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
+#if PROCESS_CONF_CPU_ACCOUNTING
+#include "sys/energest.h"
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uiplib.h"
 #include "net/ipv6/uip-icmp6.h"
@@ -488,6 +491,71 @@ PT_THREAD(cmd_macaddr(struct pt *pt, shell_output_func output, char *args))
 
   PT_END(pt);
 }
+#if PROCESS_CONF_CPU_ACCOUNTING
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_process_cpu(struct pt *pt, shell_output_func output, char *args))
+{
+  struct process *p;
+  uint64_t total;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL && !strcmp(args, "reset")) {
+    process_cpu_reset();
+    SHELL_OUTPUT(output, "Process CPU time cleared\n");
+    PT_EXIT(pt);
+  }
+
+  total = 0;
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    total += PROCESS_CPU_TICKS(p);
+  }
+
+  SHELL_OUTPUT(output, "Process CPU time (%lu ticks/s), total %lu ticks:\n",
+               (unsigned long)ENERGEST_SECOND, (unsigned long)total);
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    SHELL_OUTPUT(output, "-- %-20s: %4lu permil, events %lu in %lu ticks, polls %lu in %lu ticks, max %lu\n",
+                 PROCESS_NAME_STRING(p),
+                 (unsigned long)(total ? 1000 * PROCESS_CPU_TICKS(p) / total : 0),
+                 (unsigned long)p->cpu.events, (unsigned long)p->cpu.event_ticks,
+                 (unsigned long)p->cpu.polls, (unsigned long)p->cpu.poll_ticks,
+                 (unsigned long)p->cpu.max_ticks);
+  }
+
+  PT_END(pt);
+}
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+#if PROCESS_CONF_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_process_stats(struct pt *pt, shell_output_func output, char *args))
+{
+  struct process_stats stats;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL && !strcmp(args, "reset")) {
+    process_stats_reset();
+    SHELL_OUTPUT(output, "Event queue statistics cleared\n");
+    PT_EXIT(pt);
+  }
+
+  process_stats_get(&stats);
+  SHELL_OUTPUT(output, "Event queue: %u events now, max %u of %u, dropped %lu\n",
+               (unsigned)process_nevents(), (unsigned)stats.max_events,
+               (unsigned)(PROCESS_CONF_NUMEVENTS + PROCESS_CONF_PRIORITY_NUMEVENTS),
+               (unsigned long)stats.dropped_events);
+
+  PT_END(pt);
+}
+#endif /* PROCESS_CONF_STATS */
 #if NETSTACK_CONF_WITH_IPV6
 /*---------------------------------------------------------------------------*/
 static
@@ -836,7 +904,7 @@ PT_THREAD(cmd_tsch_schedule(struct pt *pt, shell_output_func output, char *args)
       while(l != NULL) {
         SHELL_OUTPUT(output, "---- Options %02x, type %u, timeslot %u, channel offset %u, address ",
                l->link_options, l->link_type, l->timeslot, l->channel_offset);
-        shell_output_lladdr(output, &l->addr);
+        shell_output_lladdr(output, tsch_schedule_get_link_addr(l));
         SHELL_OUTPUT(output, "\n");
         l = list_item_next(l);
       }
@@ -846,6 +914,148 @@ PT_THREAD(cmd_tsch_schedule(struct pt *pt, shell_output_func output, char *args)
   }
   PT_END(pt);
 }
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_tsch_cells(struct pt *pt, shell_output_func output, char *args))
+{
+  const tsch_schedule_cell_stats *c;
+  uint8_t i;
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "TSCH cell stats: %u cells, relocation threshold %u/1000\n",
+               tsch_stats_cell_count(), tsch_stats_get_relocate_thres());
+  SHELL_OUTPUT(output, "-- timeslot channel tx-total tx-success relevant\n");
+  for(i = 0; (c = tsch_stats_cell_at(i)) != NULL; i++) {
+    SHELL_OUTPUT(output, "-- %u %u %u %u %u\n", c->slotOffset, c->channelOffset,
+                 c->tx_total, c->tx_success, c->isStatisticallyRelevant);
+  }
+
+  PT_END(pt);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_tsch_relocate_thres(struct pt *pt, shell_output_func output, char *args))
+{
+  char *next_args;
+  char *end;
+  long value;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL) {
+    value = strtol(args, &end, 10);
+    if(*end != '\0' || value < 0 || value > 1000) {
+      SHELL_OUTPUT(output, "Invalid threshold: %s\n", args);
+      PT_EXIT(pt);
+    }
+    tsch_stats_set_relocate_thres(value);
+  }
+  SHELL_OUTPUT(output, "Relocation threshold: %u/1000\n", tsch_stats_get_relocate_thres());
+
+  PT_END(pt);
+}
+#if TSCH_WITH_LATENCY
+/*---------------------------------------------------------------------------*/
+static void
+output_latency_hist(shell_output_func output, const char *label,
+                    const struct tsch_latency_hist *h)
+{
+  uint8_t i;
+
+  SHELL_OUTPUT(output, "---- %s: count %lu, mean %lu, max %u, bins",
+               label, (unsigned long)tsch_latency_hist_count(h),
+               (unsigned long)tsch_latency_hist_mean(h), h->max);
+  for(i = 0; i < TSCH_LATENCY_NUM_BINS; i++) {
+    SHELL_OUTPUT(output, " %u", h->bins[i]);
+  }
+  SHELL_OUTPUT(output, "\n");
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_tsch_latency(struct pt *pt, shell_output_func output, char *args))
+{
+  struct tsch_neighbor *n;
+  const struct tsch_latency_cell *c;
+  uint8_t i;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL && !strcmp(args, "reset")) {
+    tsch_latency_reset();
+    SHELL_OUTPUT(output, "TSCH latency histograms cleared\n");
+    PT_EXIT(pt);
+  }
+
+  if(tsch_is_locked()) {
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "TSCH latency in timeslots (bin i >= 2^(i-1) slots):\n");
+  for(n = tsch_queue_first_nbr(); n != NULL; n = tsch_queue_next_nbr(n)) {
+    SHELL_OUTPUT(output, "-- Neighbor ");
+    shell_output_lladdr(output, tsch_queue_get_nbr_address(n));
+    SHELL_OUTPUT(output, "\n");
+    output_latency_hist(output, "queue", &n->queue_latency);
+    output_latency_hist(output, "ack", &n->ack_latency);
+  }
+  for(i = 0; (c = tsch_latency_cell_at(i)) != NULL; i++) {
+    SHELL_OUTPUT(output, "-- Cell: slotframe %u, timeslot %u\n",
+                 c->slotframe_handle, c->timeslot);
+    output_latency_hist(output, "ack", &c->hist);
+  }
+
+  PT_END(pt);
+}
+#endif /* TSCH_WITH_LATENCY */
+#if TSCH_WITH_SLOT_TIMING
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_tsch_timing(struct pt *pt, shell_output_func output, char *args))
+{
+  const struct tsch_slot_timing_hist *h;
+  uint8_t phase;
+  uint8_t i;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL && !strcmp(args, "reset")) {
+    tsch_slot_timing_reset();
+    SHELL_OUTPUT(output, "TSCH slot timing histograms cleared\n");
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "TSCH slot timing, margin to the next deadline: min and mean in us, bins by lower bound in us:\n");
+  SHELL_OUTPUT(output, "-- %-11s:", "bins from");
+  for(i = 0; i < TSCH_SLOT_TIMING_NUM_BINS; i++) {
+    SHELL_OUTPUT(output, " %lu",
+                 (unsigned long)RTIMERTICKS_TO_US_64(TSCH_SLOT_TIMING_BIN_MIN(i)));
+  }
+  SHELL_OUTPUT(output, "\n");
+  for(phase = 0; phase < TSCH_SLOT_NUM_PHASES; phase++) {
+    h = tsch_slot_timing_get(phase);
+    SHELL_OUTPUT(output, "-- %-11s: count %lu, misses %lu, min %ld, mean %lu, bins",
+                 tsch_slot_timing_phase_name(phase),
+                 (unsigned long)h->count, (unsigned long)h->misses,
+                 (long)RTIMERTICKS_TO_US((int32_t)h->min_margin),
+                 (unsigned long)RTIMERTICKS_TO_US(tsch_slot_timing_hist_mean(h)));
+    for(i = 0; i < TSCH_SLOT_TIMING_NUM_BINS; i++) {
+      SHELL_OUTPUT(output, " %u", h->bins[i]);
+    }
+    SHELL_OUTPUT(output, "\n");
+  }
+
+  PT_END(pt);
+}
+#endif /* TSCH_WITH_SLOT_TIMING */
 #endif /* MAC_CONF_WITH_TSCH */
 /*---------------------------------------------------------------------------*/
 #if TSCH_WITH_SIXTOP
@@ -998,6 +1208,12 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if PROCESS_CONF_CPU_ACCOUNTING
+  { "process-cpu",          cmd_process_cpu,          "'> process-cpu [reset]': Shows (or clears) the CPU time spent in every process" },
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+#if PROCESS_CONF_STATS
+  { "process-stats",        cmd_process_stats,        "'> process-stats [reset]': Shows (or clears) the event queue high-water mark and dropped events" },
+#endif /* PROCESS_CONF_STATS */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
@@ -1024,6 +1240,14 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "tsch-set-coordinator", cmd_tsch_set_coordinator, "'> tsch-set-coordinator 0/1 [0/1]': Sets node as coordinator (1) or not (0). Second, optional parameter: enable (1) or disable (0) security." },
   { "tsch-schedule",        cmd_tsch_schedule,        "'> tsch-schedule': Shows the current TSCH schedule" },
   { "tsch-status",          cmd_tsch_status,          "'> tsch-status': Shows a summary of the current TSCH state" },
+  { "tsch-cells",           cmd_tsch_cells,           "'> tsch-cells': Shows the per-cell transmission statistics" },
+  { "tsch-relocate-thres",  cmd_tsch_relocate_thres,  "'> tsch-relocate-thres [permille]': Shows or sets the failure ratio above which a cell is relocated" },
+#if TSCH_WITH_LATENCY
+  { "tsch-latency",         cmd_tsch_latency,         "'> tsch-latency [reset]': Shows (or clears) the per-neighbor and per-cell packet latency histograms" },
+#endif /* TSCH_WITH_LATENCY */
+#if TSCH_WITH_SLOT_TIMING
+  { "tsch-timing",          cmd_tsch_timing,          "'> tsch-timing [reset]': Shows (or clears) the slot timing profile: margins to the deadlines of every slot phase" },
+#endif /* TSCH_WITH_SLOT_TIMING */
 #endif /* MAC_CONF_WITH_TSCH */
 #if TSCH_WITH_SIXTOP
   { "6top",                 cmd_6top,                 "'> 6top help': Shows 6top command usage" },
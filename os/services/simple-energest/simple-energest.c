@@ -70,6 +70,43 @@ log_energest(const char *name, uint64_t delta, uint64_t delta_time)
            name, delta, delta_time, to_permil(delta, delta_time));
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CPU_ACCOUNTING
+static void
+log_process_cpu(uint64_t delta_time)
+{
+  struct process *p;
+  uint64_t ticks;
+
+  /* Report the time since the previous period, so that the figures are
+   * relative to the same period as the totals above. The totals are left
+   * alone for the process-cpu shell command. */
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    ticks = PROCESS_CPU_TICKS_SINCE_MARK(p);
+    if(ticks > 0) {
+      LOG_INFO("Process %-20s: %10"PRIu64"/%10"PRIu64" (%"PRIu64" permil), %"PRIu32" events, %"PRIu32" polls\n",
+               PROCESS_NAME_STRING(p), ticks, delta_time,
+               to_permil(ticks, delta_time),
+               p->cpu.events - p->cpu.mark_events,
+               p->cpu.polls - p->cpu.mark_polls);
+    }
+  }
+  process_cpu_mark();
+}
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+static void
+log_process_stats(void)
+{
+  struct process_stats stats;
+
+  /* Since boot: a queue that once overflowed is worth knowing about */
+  process_stats_get(&stats);
+  LOG_INFO("Event queue : max %u, dropped %"PRIu32"\n",
+           (unsigned)stats.max_events, stats.dropped_events);
+}
+#endif /* PROCESS_CONF_STATS */
+/*---------------------------------------------------------------------------*/
 static void
 simple_energest_step(void)
 {
@@ -98,6 +135,12 @@ simple_energest_step(void)
   log_energest("Radio Rx", curr_rx - last_rx, delta_time);
   log_energest("Radio total", curr_tx - last_tx + curr_rx - last_rx,
                delta_time);
+#if PROCESS_CONF_CPU_ACCOUNTING
+  log_process_cpu(delta_time);
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+#if PROCESS_CONF_STATS
+  log_process_stats();
+#endif /* PROCESS_CONF_STATS */
 
   last_time = curr_time;
   last_cpu = curr_cpu;
@@ -131,6 +174,9 @@ simple_energest_init(void)
   last_deep_lpm = energest_type_time(ENERGEST_TYPE_DEEP_LPM);
   last_tx = energest_type_time(ENERGEST_TYPE_TRANSMIT);
   last_rx = energest_type_time(ENERGEST_TYPE_LISTEN);
+#if PROCESS_CONF_CPU_ACCOUNTING
+  process_cpu_mark();
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
   process_start(&simple_energest_process, NULL);
 }
 
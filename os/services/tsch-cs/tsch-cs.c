@@ -38,6 +38,7 @@
 #include "tsch-stats.h"
 #include "tsch-cs.h"
 
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
 #if ! TSCH_STATS_ON
 #error tsch-cs requires tsch-stats. Please enable TSCH_STATS_CONF_ON.
 #endif /* ! TSCH_STATS_ON */
@@ -45,6 +46,7 @@
 #if ! TSCH_STATS_SAMPLE_NOISE_RSSI
 #error tsch-cs requires periodic RSSI sampling. Please enable TSCH_STATS_CONF_SAMPLE_NOISE_RSSI.
 #endif /* ! TSCH_STATS_SAMPLE_NOISE_RSSI */
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
 
 /* Log configuration */
 #include "sys/log.h"
@@ -65,11 +67,13 @@
 /* After removing a channel from the sequence, do not add it back at least this time */
 #define TSCH_CS_BLACKLIST_DURATION_SEC (5 * 60)
 
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
 /* A potential for change detected? */
 static bool recaculation_requested;
 
 /* Time (in seconds) when channels were marked as busy; 0 if they are not busy */
 static uint32_t tsch_cs_busy_since[TSCH_STATS_NUM_CHANNELS];
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
 
 /*
  * The following variables are kept in order to avoid completely migrating away
@@ -81,13 +85,18 @@ static tsch_cs_bitmap_t tsch_cs_initial_bitmap;
 /* The bitmap with the current channels */
 static tsch_cs_bitmap_t tsch_cs_current_bitmap;
 
-/* structure for sorting */
+/* structure for ranking */
 struct tsch_cs_quality {
   /* channel number */
   uint8_t channel;
   /* the higher, the better */
   tsch_stat_t metric;
 };
+
+/* Cells found bad, oldest first; the oldest is dropped when full */
+static struct tsch_cs_cell cell_blacklist[TSCH_CS_CELL_BLACKLIST_SIZE];
+static uint8_t cell_blacklist_head;
+static uint8_t cell_blacklist_count;
 /*---------------------------------------------------------------------------*/
 static inline bool
 tsch_cs_bitmap_contains(tsch_cs_bitmap_t bitmap, uint8_t channel)
@@ -117,30 +126,40 @@ tsch_cs_adaptations_init(void)
 {
   tsch_cs_initial_bitmap = tsch_cs_bitmap_calc();
   tsch_cs_current_bitmap = tsch_cs_initial_bitmap;
+  tsch_cs_cell_blacklist_clear();
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
+/* Ranking order: higher metric first, lower channel first among equals */
+static inline bool
+tsch_cs_is_better(const struct tsch_cs_quality *a, const struct tsch_cs_quality *b)
+{
+  return a->metric > b->metric || (a->metric == b->metric && a->channel < b->channel);
 }
 /*---------------------------------------------------------------------------*/
-/* Sort the elements to that the channels with the best metrics are in the front */
+/* Rank the channels, best first, from a copy of the channel statistics */
 static void
-tsch_cs_bubble_sort(struct tsch_cs_quality *qualities)
+tsch_cs_rank(struct tsch_cs_quality *qualities, const tsch_stat_t *channel_free_ewma)
 {
-  int i, j;
-  struct tsch_cs_quality tmp;
-
+  int i;
   for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
-    for(j = 0; j + 1 < TSCH_STATS_NUM_CHANNELS; ++j) {
-      if(qualities[j].metric < qualities[j+1].metric){
-        tmp = qualities[j];
-        qualities[j] = qualities[j+1];
-        qualities[j+1] = tmp;
-      }
+    struct tsch_cs_quality q;
+    int j = i;
+    q.channel = i + TSCH_STATS_FIRST_CHANNEL;
+    q.metric = channel_free_ewma[i];
+    /* insertion sort */
+    while(j > 0 && tsch_cs_is_better(&q, &qualities[j - 1])) {
+      qualities[j] = qualities[j - 1];
+      --j;
     }
+    qualities[j] = q;
   }
 }
 /*---------------------------------------------------------------------------*/
 /* Select a single, currently unused, good enough channel. Returns 0xff on failure. */
 static uint8_t
 tsch_cs_select_replacement(uint8_t old_channel, tsch_stat_t old_ewma,
-                      struct tsch_cs_quality *qualities, uint8_t is_in_sequence[])
+                      const struct tsch_cs_quality *qualities, uint8_t is_in_sequence[])
 {
   int i;
   uint32_t now = clock_seconds();
@@ -204,6 +223,7 @@ tsch_cs_process(void)
   bool try_replace;
   bool has_replaced;
   struct tsch_cs_quality qualities[TSCH_STATS_NUM_CHANNELS];
+  tsch_stat_t channel_free_ewma[TSCH_STATS_NUM_CHANNELS];
   uint8_t is_channel_busy[TSCH_STATS_NUM_CHANNELS];
   uint8_t is_in_sequence[TSCH_STATS_NUM_CHANNELS];
   static uint32_t last_time_changed;
@@ -218,20 +238,23 @@ tsch_cs_process(void)
     return false;
   }
 
+  /* copy the statistics: the slot operation updates them */
+  if(!tsch_get_lock()) {
+    /* try again next time */
+    return false;
+  }
+  memcpy(channel_free_ewma, tsch_stats.channel_free_ewma, sizeof(channel_free_ewma));
+  tsch_release_lock();
+
   /* reset the flag */
   recaculation_requested = false;
 
-  for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
-    qualities[i].channel = i + TSCH_STATS_FIRST_CHANNEL;
-    qualities[i].metric = tsch_stats.channel_free_ewma[i];
-  }
-
-  /* bubble sort the channels */
-  tsch_cs_bubble_sort(qualities);
+  /* rank the channels, best first */
+  tsch_cs_rank(qualities, channel_free_ewma);
 
   /* start with the threshold values */
   for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
-    is_channel_busy[i] = (tsch_stats.channel_free_ewma[i] < TSCH_CS_FREE_THRESHOLD);
+    is_channel_busy[i] = (channel_free_ewma[i] < TSCH_CS_FREE_THRESHOLD);
   }
   memset(is_in_sequence, 0xff, sizeof(is_in_sequence));
   for(i = 0; i < tsch_hopping_sequence_length.val; ++i) {
@@ -334,3 +357,139 @@ tsch_cs_channel_stats_updated(uint8_t updated_channel, uint16_t old_busyness_met
     }
   }
 }
+#else /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
+/*---------------------------------------------------------------------------*/
+bool
+tsch_cs_process(void)
+{
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_cs_channel_stats_updated(uint8_t updated_channel, uint16_t old_busyness_metric)
+{
+}
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
+/*---------------------------------------------------------------------------*/
+/* Is a channel of the hopping sequence bad for everybody (noise), or for
+ * the transmissions to a neighbor on all of its cells? */
+static bool
+tsch_cs_is_channel_bad(uint8_t channel, struct tsch_neighbor *n)
+{
+  uint8_t index = tsch_stats_channel_to_index(channel);
+  if(index >= TSCH_STATS_NUM_CHANNELS) {
+    return false;
+  }
+#if TSCH_STATS_ON && TSCH_STATS_SAMPLE_NOISE_RSSI
+  if(tsch_stats.channel_free_ewma[index] < TSCH_CS_FREE_THRESHOLD) {
+    return true;
+  }
+#endif /* TSCH_STATS_ON && TSCH_STATS_SAMPLE_NOISE_RSSI */
+#if TSCH_STATS_ON
+  if(n != NULL) {
+    struct tsch_neighbor_stats *stats = tsch_stats_get_from_neighbor(n);
+    if(stats != NULL
+       && stats->channel_stats[index].p_tx_success < TSCH_CS_TX_THRESHOLD) {
+      return true;
+    }
+  }
+#endif /* TSCH_STATS_ON */
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+enum tsch_cs_cell_action
+tsch_cs_bad_cell_action(struct tsch_neighbor *n, uint16_t timeslot, uint16_t channel_offset)
+{
+  tsch_cs_bitmap_t bad = 0;
+  tsch_cs_bitmap_t all = 0;
+  uint8_t num_bad = 0;
+  uint8_t num_all = 0;
+  int i;
+
+  /* A cell hops over the whole sequence: per-cell failures can only be
+   * blamed on a channel if that channel is also bad on the other cells
+   * (per-neighbor Tx statistics) or for everybody (noise). If most of the
+   * sequence looks bad, no single channel is to blame either. */
+  for(i = 0; i < tsch_hopping_sequence_length.val; ++i) {
+    uint8_t channel = tsch_hopping_sequence[i];
+    if(tsch_cs_bitmap_contains(all, channel)) {
+      continue;
+    }
+    all = tsch_cs_bitmap_set(all, channel);
+    num_all++;
+    if(tsch_cs_is_channel_bad(channel, n)) {
+      bad = tsch_cs_bitmap_set(bad, channel);
+      num_bad++;
+    }
+  }
+
+  if(num_bad > 0 && 2 * num_bad <= num_all) {
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
+    /* Only the coordinator changes the sequence, for the whole network */
+    if(tsch_is_coordinator) {
+      LOG_INFO("cell %u/%u: %u of %u channels bad (%04x), replace channel\n",
+               timeslot, channel_offset, num_bad, num_all, bad);
+      recaculation_requested = true;
+      return TSCH_CS_REPLACE_CHANNEL;
+    }
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
+    /* Nothing would replace the channel: relocating the cell is the only
+     * way to get it out of the bad state */
+    LOG_INFO("cell %u/%u: %u of %u channels bad (%04x), "
+             "no channel adaptation here, relocate cell\n",
+             timeslot, channel_offset, num_bad, num_all, bad);
+    return TSCH_CS_RELOCATE_CELL;
+  }
+
+  LOG_INFO("cell %u/%u: no channel to blame, relocate cell\n",
+           timeslot, channel_offset);
+  return TSCH_CS_RELOCATE_CELL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_cs_cell_blacklist_add(uint16_t timeslot, uint16_t channel_offset)
+{
+  uint8_t tail = (cell_blacklist_head + cell_blacklist_count) % TSCH_CS_CELL_BLACKLIST_SIZE;
+  if(cell_blacklist_count == TSCH_CS_CELL_BLACKLIST_SIZE) {
+    cell_blacklist_head = (cell_blacklist_head + 1) % TSCH_CS_CELL_BLACKLIST_SIZE;
+  } else {
+    cell_blacklist_count++;
+  }
+  cell_blacklist[tail].timeslot = timeslot;
+  cell_blacklist[tail].channel_offset = channel_offset;
+}
+/*---------------------------------------------------------------------------*/
+bool
+tsch_cs_cell_is_blacklisted(uint16_t timeslot, uint16_t channel_offset)
+{
+  uint8_t i;
+  for(i = 0; i < cell_blacklist_count; ++i) {
+    const struct tsch_cs_cell *c = tsch_cs_cell_blacklist_get(i);
+    if(c->timeslot == timeslot && c->channel_offset == channel_offset) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+tsch_cs_cell_blacklist_count(void)
+{
+  return cell_blacklist_count;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_cs_cell *
+tsch_cs_cell_blacklist_get(uint8_t i)
+{
+  if(i >= cell_blacklist_count) {
+    return NULL;
+  }
+  return &cell_blacklist[(cell_blacklist_head + i) % TSCH_CS_CELL_BLACKLIST_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_cs_cell_blacklist_clear(void)
+{
+  cell_blacklist_head = 0;
+  cell_blacklist_count = 0;
+}
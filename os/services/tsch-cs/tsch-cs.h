@@ -50,6 +50,48 @@
 
 #define TSCH_CS_LEARNING_PERIOD_SEC 30
 
+/* Adapt the hopping sequence to per-channel noise (coordinator only).
+ * Requires TSCH_STATS_CONF_ON and TSCH_STATS_CONF_SAMPLE_NOISE_RSSI. When
+ * disabled, only the per-cell part of the service is available */
+#ifdef TSCH_CS_CONF_WITH_CHANNEL_ADAPTATION
+#define TSCH_CS_WITH_CHANNEL_ADAPTATION TSCH_CS_CONF_WITH_CHANNEL_ADAPTATION
+#else
+#define TSCH_CS_WITH_CHANNEL_ADAPTATION 1
+#endif
+
+/* If the Tx success EWMA to a neighbor on a channel is less than this, the
+ * channel is considered bad for that neighbor */
+#ifdef TSCH_CS_CONF_TX_THRESHOLD
+#define TSCH_CS_TX_THRESHOLD TSCH_CS_CONF_TX_THRESHOLD
+#else
+/* < 50% success */
+#define TSCH_CS_TX_THRESHOLD ((tsch_stat_t)(50ul * TSCH_STATS_BINARY_SCALING_FACTOR / 100))
+#endif
+
+/* Number of blacklisted cells */
+#ifdef TSCH_CS_CONF_CELL_BLACKLIST_SIZE
+#define TSCH_CS_CELL_BLACKLIST_SIZE TSCH_CS_CONF_CELL_BLACKLIST_SIZE
+#else
+#define TSCH_CS_CELL_BLACKLIST_SIZE 5
+#endif
+
+/* What to do about a cell with a bad delivery ratio */
+enum tsch_cs_cell_action {
+  /* The interference is specific to the cell: move it elsewhere */
+  TSCH_CS_RELOCATE_CELL,
+  /* A channel of the hopping sequence is to blame: relocating the cell
+   * would not help, the channel is to be replaced network-wide */
+  TSCH_CS_REPLACE_CHANNEL,
+};
+
+/* A cell, by its offsets */
+struct tsch_cs_cell {
+  uint16_t timeslot;
+  uint16_t channel_offset;
+};
+
+struct tsch_neighbor; /* Forward declaration */
+
 /**
  * \brief Initializes the TSCH hopping sequence selection module.
  */
@@ -69,6 +111,50 @@ void tsch_cs_channel_stats_updated(uint8_t updated_channel, uint16_t old_busynes
 bool tsch_cs_process(void);
 
 
+/**
+ * \brief Decide what to do about a cell with a bad delivery ratio, from the
+ * per-channel statistics: noise on every channel of the hopping sequence,
+ * and the Tx success to the neighbor on every channel. A channel is only
+ * blamed where it can be replaced, i.e. on the coordinator with
+ * TSCH_CS_CONF_WITH_CHANNEL_ADAPTATION, and this triggers the hopping
+ * sequence update. Elsewhere, bad cells are always to be relocated.
+ * \param n              The neighbor of the cell, NULL if unknown
+ * \param timeslot       The timeslot of the cell
+ * \param channel_offset The channel offset of the cell
+ * \return TSCH_CS_RELOCATE_CELL or TSCH_CS_REPLACE_CHANNEL
+ */
+enum tsch_cs_cell_action tsch_cs_bad_cell_action(struct tsch_neighbor *n,
+                                                 uint16_t timeslot,
+                                                 uint16_t channel_offset);
+
+/**
+ * \brief Blacklist a cell, e.g. one found bad or interfered with, so that it
+ * is not selected again. The oldest entry is dropped when the list is full.
+ */
+void tsch_cs_cell_blacklist_add(uint16_t timeslot, uint16_t channel_offset);
+
+/**
+ * \brief Tell whether a cell is blacklisted
+ */
+bool tsch_cs_cell_is_blacklisted(uint16_t timeslot, uint16_t channel_offset);
+
+/**
+ * \brief The number of blacklisted cells
+ */
+uint8_t tsch_cs_cell_blacklist_count(void);
+
+/**
+ * \brief Access a blacklisted cell, oldest first
+ * \param i The position in the blacklist
+ * \return The cell, NULL if i is out of range
+ */
+const struct tsch_cs_cell *tsch_cs_cell_blacklist_get(uint8_t i);
+
+/**
+ * \brief Empty the cell blacklist
+ */
+void tsch_cs_cell_blacklist_clear(void);
+
 /* A bit corresponds to a channel; `uint16_t` value is OK for up to 16 channels. */
 typedef uint16_t tsch_cs_bitmap_t;
 
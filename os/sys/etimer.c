@@ -52,8 +52,116 @@
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
+#if ETIMER_HEAP_SIZE
+/* Binary min-heap of the pending timers, ordered by remaining time.
+   The list above only holds the timers that do not fit in it. */
+static struct etimer *heap[ETIMER_HEAP_SIZE];
+static uint16_t heap_count;
+#endif /* ETIMER_HEAP_SIZE */
+
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP_SIZE
+/* Time until the expiration of a timer, 0 if it has expired */
+static clock_time_t
+time_left(const struct etimer *t, clock_time_t now)
+{
+  clock_time_t elapsed = now - t->timer.start;
+
+  return elapsed >= t->timer.interval ? 0 : t->timer.interval - elapsed;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+in_heap(const struct etimer *t)
+{
+  /* The index of a timer that is not in the heap may be garbage */
+  return t->heap_index < heap_count && heap[t->heap_index] == t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_place(struct etimer *t, uint16_t i)
+{
+  heap[i] = t;
+  t->heap_index = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_up(uint16_t i, clock_time_t now)
+{
+  struct etimer *t = heap[i];
+  clock_time_t left = time_left(t, now);
+
+  while(i > 0) {
+    uint16_t parent = (i - 1) / 2;
+    if(time_left(heap[parent], now) <= left) {
+      break;
+    }
+    heap_place(heap[parent], i);
+    i = parent;
+  }
+  heap_place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_down(uint16_t i, clock_time_t now)
+{
+  struct etimer *t = heap[i];
+  clock_time_t left = time_left(t, now);
+
+  while(2 * i + 1 < heap_count) {
+    uint16_t child = 2 * i + 1;
+    if(child + 1 < heap_count &&
+       time_left(heap[child + 1], now) < time_left(heap[child], now)) {
+      child++;
+    }
+    if(left <= time_left(heap[child], now)) {
+      break;
+    }
+    heap_place(heap[child], i);
+    i = child;
+  }
+  heap_place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+/* Restores the heap order around a timer whose expiration time changed */
+static void
+heap_update(uint16_t i, clock_time_t now)
+{
+  struct etimer *t = heap[i];
+
+  sift_up(i, now);
+  sift_down(t->heap_index, now);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(uint16_t i, clock_time_t now)
+{
+  heap_count--;
+  if(i < heap_count) {
+    heap_place(heap[heap_count], i);
+    heap_update(i, now);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Removes the timers of an exited process, and rebuilds the heap */
+static void
+heap_remove_process(struct process *p)
+{
+  clock_time_t now = clock_time();
+  uint16_t n = 0;
+
+  for(uint16_t i = 0; i < heap_count; i++) {
+    if(heap[i]->p != p) {
+      heap_place(heap[i], n++);
+    }
+  }
+  heap_count = n;
+  for(uint16_t i = heap_count / 2; i-- > 0;) {
+    sift_down(i, now);
+  }
+}
+#endif /* ETIMER_HEAP_SIZE */
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -61,14 +169,24 @@ update_time(void)
   clock_time_t now;
   struct etimer *t;
 
-  if(timerlist == NULL) {
+  if(!etimer_pending()) {
     next_expiration = 0;
   } else {
     now = clock_time();
-    t = timerlist;
+#if ETIMER_HEAP_SIZE
+    if(heap_count > 0) {
+      /* The top of the heap expires first, unless a listed timer does */
+      tdist = heap[0]->timer.start + heap[0]->timer.interval - now;
+      t = timerlist;
+    } else
+#endif /* ETIMER_HEAP_SIZE */
+    {
+      t = timerlist;
+      tdist = t->timer.start + t->timer.interval - now;
+      t = t->next;
+    }
     /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
+    for(; t != NULL; t = t->next) {
       if(t->timer.start + t->timer.interval - now < tdist) {
         tdist = t->timer.start + t->timer.interval - now;
       }
@@ -91,6 +209,10 @@ PROCESS_THREAD(etimer_process, ev, data)
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
+#if ETIMER_HEAP_SIZE
+      heap_remove_process(p);
+#endif /* ETIMER_HEAP_SIZE */
+
       while(timerlist != NULL && timerlist->p == p) {
         timerlist = timerlist->next;
       }
@@ -112,6 +234,20 @@ PROCESS_THREAD(etimer_process, ev, data)
 
 again:
 
+#if ETIMER_HEAP_SIZE
+    /* Timers expire in order from the top of the heap */
+    while(heap_count > 0 && timer_expired(&heap[0]->timer)) {
+      t = heap[0];
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+        etimer_request_poll();
+        break;
+      }
+      t->p = PROCESS_NONE;
+      heap_remove(0, clock_time());
+      update_time();
+    }
+#endif /* ETIMER_HEAP_SIZE */
+
     u = NULL;
 
     for(t = timerlist; t != NULL; t = t->next) {
@@ -154,6 +290,16 @@ add_timer(struct etimer *timer)
 
   etimer_request_poll();
 
+#if ETIMER_HEAP_SIZE
+  if(in_heap(timer)) {
+    /* Timer already in the heap, move it to its new position. */
+    timer->p = PROCESS_CURRENT();
+    heap_update(timer->heap_index, clock_time());
+    update_time();
+    return;
+  }
+#endif /* ETIMER_HEAP_SIZE */
+
   if(timer->p != PROCESS_NONE) {
     for(t = timerlist; t != NULL; t = t->next) {
       if(t == timer) {
@@ -167,6 +313,14 @@ add_timer(struct etimer *timer)
 
   /* Timer not on list. */
   timer->p = PROCESS_CURRENT();
+#if ETIMER_HEAP_SIZE
+  if(heap_count < ETIMER_HEAP_SIZE) {
+    heap_place(timer, heap_count++);
+    sift_up(timer->heap_index, clock_time());
+    update_time();
+    return;
+  }
+#endif /* ETIMER_HEAP_SIZE */
   timer->next = timerlist;
   timerlist = timer;
 
@@ -206,6 +360,11 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+#if ETIMER_HEAP_SIZE
+  if(in_heap(et)) {
+    heap_update(et->heap_index, clock_time());
+  }
+#endif /* ETIMER_HEAP_SIZE */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -224,6 +383,11 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_HEAP_SIZE
+  if(heap_count > 0) {
+    return 1;
+  }
+#endif /* ETIMER_HEAP_SIZE */
   return timerlist != NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -238,6 +402,12 @@ etimer_stop(struct etimer *et)
 {
   struct etimer *t;
 
+#if ETIMER_HEAP_SIZE
+  if(in_heap(et)) {
+    heap_remove(et->heap_index, clock_time());
+    update_time();
+  } else
+#endif /* ETIMER_HEAP_SIZE */
   /* First check if et is the first event timer on the list. */
   if(et == timerlist) {
     timerlist = timerlist->next;
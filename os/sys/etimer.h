@@ -57,6 +57,12 @@
  * \sa \ref clock "Clock library" (used by the timer library)
  *
  * It is \e not safe to manipulate event timers within an interrupt context.
+ *
+ * Pending event timers are kept in a list, which is scanned whenever a
+ * timer is set, stopped or expires. With ETIMER_CONF_HEAP_SIZE set to
+ * a non-zero value, up to that many timers are kept in a binary heap
+ * instead, ordered by expiration time, so that these operations take
+ * O(log n) time. Further timers go to the list.
  * @{
  */
 
@@ -68,6 +74,13 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/* Capacity of the heap of pending event timers, 0 to disable it */
+#ifdef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_HEAP_SIZE ETIMER_CONF_HEAP_SIZE
+#else
+#define ETIMER_HEAP_SIZE 0
+#endif
+
 /**
  * A timer.
  *
@@ -80,6 +93,9 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP_SIZE
+  uint16_t heap_index;
+#endif /* ETIMER_HEAP_SIZE */
 };
 
 /**
@@ -82,8 +82,22 @@
 #define LOG_WITH_ANNOTATE 0
 #endif /* LOG_CONF_WITH_ANNOTATE */
 
+/* Record logs in binary form, to be written out later and formatted on
+ * the host (see sys/log-deferred.h). Disabled by default */
+#ifdef LOG_CONF_DEFERRED
+#define LOG_DEFERRED LOG_CONF_DEFERRED
+#else /* LOG_CONF_DEFERRED */
+#define LOG_DEFERRED 0
+#endif /* LOG_CONF_DEFERRED */
+
 /* Custom output function -- default is printf */
-#ifdef LOG_CONF_OUTPUT
+#if LOG_DEFERRED
+/* Only string literals are sure to be found in the firmware image by the
+ * decoder: other format strings are formatted right away */
+#define LOG_OUTPUT(fmt, ...) \
+  (__builtin_constant_p(fmt) ? log_deferred(fmt, ##__VA_ARGS__) \
+                             : log_deferred_formatted(fmt, ##__VA_ARGS__))
+#elif defined(LOG_CONF_OUTPUT)
 #define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
 #else /* LOG_CONF_OUTPUT */
 #define LOG_OUTPUT(...) printf(__VA_ARGS__)
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup log
+ * @{
+ */
+
+/**
+ * \file
+ *         Deferred, binary backend of the logging system
+ */
+
+#include "contiki.h"
+#include "sys/log.h"
+#include "sys/log-deferred.h"
+#include "sys/critical.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if LOG_DEFERRED
+
+static_assert(LOG_DEFERRED_BUF_SIZE <= 32768 &&
+  !(LOG_DEFERRED_BUF_SIZE & (LOG_DEFERRED_BUF_SIZE - 1)),
+  "LOG_DEFERRED_CONF_BUF_SIZE must be a power of 2 of at most 32768.");
+
+/* Longest record, kind included */
+#define MAX_RECORD_LEN 96
+
+/* The decoder finds the load address of the firmware from the address
+ * of this symbol */
+const char log_deferred_anchor[] = "log-deferred";
+
+/* Records, each preceded by its length. The indices run freely and are
+ * reduced modulo the buffer size on access. */
+static uint8_t ring[LOG_DEFERRED_BUF_SIZE];
+static uint16_t head;
+static uint16_t tail;
+static uint16_t lost;
+static uint8_t since_sync;
+static bool continue_posted;
+
+PROCESS(log_deferred_process, "Deferred log");
+/*---------------------------------------------------------------------------*/
+static void
+ring_put(const uint8_t *data, uint8_t len)
+{
+  ring[head++ & (LOG_DEFERRED_BUF_SIZE - 1)] = len;
+  while(len-- > 0) {
+    ring[head++ & (LOG_DEFERRED_BUF_SIZE - 1)] = *data++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Queues a record, or counts it as lost if data is NULL or the buffer
+ * is full */
+static void
+record(const uint8_t *data, uint8_t len)
+{
+  int_master_status_t status;
+  uint8_t lost_record[1 + sizeof(lost)];
+  uint16_t needed;
+
+  status = critical_enter();
+  needed = 1 + len + (lost > 0 ? 1 + sizeof(lost_record) : 0);
+  if(data == NULL ||
+     LOG_DEFERRED_BUF_SIZE - (uint16_t)(head - tail) < needed) {
+    if(lost < UINT16_MAX) {
+      lost++;
+    }
+    critical_exit(status);
+    return;
+  }
+  if(lost > 0) {
+    lost_record[0] = LOG_DEFERRED_LOST;
+    memcpy(lost_record + 1, &lost, sizeof(lost));
+    ring_put(lost_record, sizeof(lost_record));
+    lost = 0;
+  }
+  ring_put(data, len);
+  critical_exit(status);
+
+  process_poll(&log_deferred_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred(const char *fmt, ...)
+{
+  uint8_t buf[MAX_RECORD_LEN];
+  uint8_t *p = buf;
+  uint8_t *const end = buf + sizeof(buf);
+  const char *f;
+  const char *s;
+  size_t len;
+  va_list ap;
+
+/* Copies the next argument, of the given type, into the record */
+#define PUT_ARG(type) do { \
+    type v = va_arg(ap, type); \
+    if(p + sizeof(v) > end) { \
+      goto overflow; \
+    } \
+    memcpy(p, &v, sizeof(v)); \
+    p += sizeof(v); \
+  } while(0)
+
+  *p++ = LOG_DEFERRED_FORMAT;
+  memcpy(p, &fmt, sizeof(fmt));
+  p += sizeof(fmt);
+
+  va_start(ap, fmt);
+  /* Only the argument types are parsed out of the format string, the
+   * rest is left to the decoder */
+  for(f = fmt; *f != '\0'; f++) {
+    if(*f != '%') {
+      continue;
+    }
+    f++;
+    while(*f != '\0' && strchr("-+ #0", *f) != NULL) {
+      f++;
+    }
+    /* Width and precision */
+    while((*f >= '0' && *f <= '9') || *f == '.' || *f == '*') {
+      if(*f == '*') {
+        PUT_ARG(int);
+      }
+      f++;
+    }
+    /* Length modifier */
+    switch(*f) {
+    case 'h':
+      f += f[1] == 'h' ? 2 : 1;
+      break;
+    case 'l':
+      if(f[1] == 'l') {
+        f += 2;
+        if(strchr("diouxX", *f) != NULL) {
+          PUT_ARG(long long);
+        }
+        continue;
+      }
+      f++;
+      if(strchr("diouxX", *f) != NULL) {
+        PUT_ARG(long);
+        continue;
+      }
+      break;
+    case 'z':
+    case 't':
+      f++;
+      if(strchr("diouxX", *f) != NULL) {
+        PUT_ARG(size_t);
+      }
+      continue;
+    case 'j':
+      f++;
+      if(strchr("diouxX", *f) != NULL) {
+        PUT_ARG(long long);
+      }
+      continue;
+    case 'L':
+      f++;
+      if(*f != '\0' && strchr("fFeEgGaA", *f) != NULL) {
+        long double v = va_arg(ap, long double);
+        double d = (double)v;
+        if(p + sizeof(d) > end) {
+          goto overflow;
+        }
+        memcpy(p, &d, sizeof(d));
+        p += sizeof(d);
+      }
+      continue;
+    }
+
+    switch(*f) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+      PUT_ARG(int);
+      break;
+    case 'p':
+      PUT_ARG(void *);
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      PUT_ARG(double);
+      break;
+    case 's':
+      s = va_arg(ap, const char *);
+      if(s == NULL) {
+        s = "(null)";
+      }
+      len = strnlen(s, LOG_DEFERRED_MAX_STRLEN);
+      if(p + len + 1 > end) {
+        if(p + 1 > end) {
+          goto overflow;
+        }
+        len = end - p - 1;
+      }
+      memcpy(p, s, len);
+      p += len;
+      *p++ = '\0';
+      break;
+    case '\0':
+      /* Stray % at the end */
+      f--;
+      break;
+    default:
+      /* %% and %n take no argument worth recording */
+      break;
+    }
+  }
+  va_end(ap);
+
+  record(buf, p - buf);
+  return;
+
+overflow:
+  va_end(ap);
+  /* Counted as lost, rather than recorded with missing arguments */
+  record(NULL, 0);
+#undef PUT_ARG
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_formatted(const char *fmt, ...)
+{
+  char buf[MAX_RECORD_LEN];
+  va_list ap;
+  int len;
+
+  va_start(ap, fmt);
+  len = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+
+  if(len > 0) {
+    /* One record at most, kind included */
+    log_deferred_data(LOG_DEFERRED_STRING, buf,
+                      MIN((size_t)len, sizeof(buf) - 1));
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_data(uint8_t kind, const void *data, size_t len)
+{
+  uint8_t buf[MAX_RECORD_LEN];
+  const uint8_t *d = data;
+  size_t chunk;
+
+  buf[0] = kind;
+  /* Long data is split over several records */
+  do {
+    chunk = MIN(len, sizeof(buf) - 1);
+    memcpy(buf + 1, d, chunk);
+    record(buf, 1 + chunk);
+    d += chunk;
+    len -= chunk;
+    if(len > 0 && kind == LOG_DEFERRED_BYTES_SPACED) {
+      log_deferred(" ");
+    }
+  } while(len > 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+output(const uint8_t *data, uint8_t len)
+{
+  static const char hex[] = "0123456789abcdef";
+  char line[sizeof(LOG_DEFERRED_PREFIX) + 2 * MAX_RECORD_LEN + 1];
+  char *p;
+
+  memcpy(line, LOG_DEFERRED_PREFIX, sizeof(LOG_DEFERRED_PREFIX) - 1);
+  p = line + sizeof(LOG_DEFERRED_PREFIX) - 1;
+  while(len-- > 0) {
+    *p++ = hex[*data >> 4];
+    *p++ = hex[*data & 0xf];
+    data++;
+  }
+  *p++ = '\n';
+  *p = '\0';
+  printf("%s", line);
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_sync(void)
+{
+  const uint16_t one = 1;
+  const char *anchor = log_deferred_anchor;
+  uint8_t buf[6 + sizeof(anchor)];
+
+  buf[0] = LOG_DEFERRED_SYNC;
+  buf[1] = sizeof(int);
+  buf[2] = sizeof(long);
+  buf[3] = sizeof(size_t);
+  buf[4] = sizeof(void *);
+  buf[5] = *(const uint8_t *)&one;
+  memcpy(buf + 6, &anchor, sizeof(anchor));
+  output(buf, sizeof(buf));
+  since_sync = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Writes out the oldest record, returns false if there is none */
+static bool
+flush_one(void)
+{
+  uint8_t buf[MAX_RECORD_LEN];
+  int_master_status_t status;
+  uint8_t len;
+  uint8_t i;
+
+  status = critical_enter();
+  if(head == tail) {
+    critical_exit(status);
+    return false;
+  }
+  len = ring[tail++ & (LOG_DEFERRED_BUF_SIZE - 1)];
+  for(i = 0; i < len; i++) {
+    buf[i] = ring[tail++ & (LOG_DEFERRED_BUF_SIZE - 1)];
+  }
+  critical_exit(status);
+
+  if(since_sync >= LOG_DEFERRED_SYNC_PERIOD) {
+    output_sync();
+  }
+  output(buf, len);
+  since_sync++;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_flush(void)
+{
+  while(flush_one());
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_deferred_process, ev, data)
+{
+  uint8_t i;
+
+  PROCESS_BEGIN();
+
+  output_sync();
+
+  while(1) {
+    /* Write a batch of records at a time, then go to the back of the
+     * event queue to let other processes run */
+    for(i = 0; i < LOG_DEFERRED_FLUSH_BATCH && flush_one(); i++);
+    if(head != tail && !continue_posted) {
+      continue_posted = process_post(PROCESS_CURRENT(),
+                                     PROCESS_EVENT_CONTINUE, NULL) == PROCESS_ERR_OK;
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL ||
+                             ev == PROCESS_EVENT_CONTINUE);
+    if(ev == PROCESS_EVENT_CONTINUE) {
+      continue_posted = false;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+log_deferred_init(void)
+{
+  process_start(&log_deferred_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_DEFERRED */
+/** @} */
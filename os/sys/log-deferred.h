@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup log
+ * @{
+ */
+
+/**
+ * \file
+ *         Deferred, binary backend of the logging system
+ *
+ * With LOG_CONF_DEFERRED, LOG_OUTPUT does not format anything. It stores
+ * the address of the format string and the raw arguments in a ring
+ * buffer, which a process of its own writes out when the system is
+ * otherwise idle. Every record is printed as a line "#L" followed by its
+ * hex encoding, and tools/log-decoder/log-decoder.py rebuilds the text on
+ * the host, reading the format strings from the firmware ELF file.
+ *
+ * Records (multi-byte fields in the byte order of the node):
+ *
+ * - sync: 0x00, sizeof(int), sizeof(long), sizeof(size_t),
+ *   sizeof(void *), 1 if little-endian, address of log_deferred_anchor
+ * - format: 0x01, format string address, arguments. Integers and
+ *   pointers are stored with their size, floating-point values as
+ *   double and strings as a copy, zero-terminated.
+ * - lost: 0x02, number of records dropped on a full buffer (uint16)
+ * - link-layer address, IPv6 address, bytes, bytes separated by spaces,
+ *   string: 0x03 to 0x07, raw data
+ *
+ * The sync record lets the decoder map addresses of relocated firmware
+ * (native, Cooja) to the ELF file. It is sent when logging starts and
+ * every LOG_DEFERRED_SYNC_PERIOD records.
+ *
+ * Only the address of the format string is recorded, so the decoder
+ * needs the string at that address in the ELF file, in its original
+ * form. This holds for string literals, which LOG_OUTPUT passes to
+ * log_deferred(). Any other format string may have been built at run
+ * time, in RAM: LOG_OUTPUT formats it right away, with
+ * log_deferred_formatted(), and records the resulting text instead.
+ */
+
+#ifndef LOG_DEFERRED_H_
+#define LOG_DEFERRED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of the ring buffer, a power of 2 of at most 32768 bytes */
+#ifdef LOG_DEFERRED_CONF_BUF_SIZE
+#define LOG_DEFERRED_BUF_SIZE LOG_DEFERRED_CONF_BUF_SIZE
+#else /* LOG_DEFERRED_CONF_BUF_SIZE */
+#define LOG_DEFERRED_BUF_SIZE 1024
+#endif /* LOG_DEFERRED_CONF_BUF_SIZE */
+
+/* Maximum number of records written per run of the flushing process */
+#ifdef LOG_DEFERRED_CONF_FLUSH_BATCH
+#define LOG_DEFERRED_FLUSH_BATCH LOG_DEFERRED_CONF_FLUSH_BATCH
+#else /* LOG_DEFERRED_CONF_FLUSH_BATCH */
+#define LOG_DEFERRED_FLUSH_BATCH 8
+#endif /* LOG_DEFERRED_CONF_FLUSH_BATCH */
+
+/* Longest string argument copied into a record */
+#ifdef LOG_DEFERRED_CONF_MAX_STRLEN
+#define LOG_DEFERRED_MAX_STRLEN LOG_DEFERRED_CONF_MAX_STRLEN
+#else /* LOG_DEFERRED_CONF_MAX_STRLEN */
+#define LOG_DEFERRED_MAX_STRLEN 32
+#endif /* LOG_DEFERRED_CONF_MAX_STRLEN */
+
+/* Number of records written between two sync records */
+#define LOG_DEFERRED_SYNC_PERIOD 32
+
+/* Record prefix on the log output */
+#define LOG_DEFERRED_PREFIX "#L"
+
+/** Record kinds */
+enum {
+  LOG_DEFERRED_SYNC,
+  LOG_DEFERRED_FORMAT,
+  LOG_DEFERRED_LOST,
+  LOG_DEFERRED_LLADDR,
+  LOG_DEFERRED_6ADDR,
+  LOG_DEFERRED_BYTES,
+  LOG_DEFERRED_BYTES_SPACED,
+  LOG_DEFERRED_STRING,
+};
+
+/**
+ * Starts the process that writes out the records. Records logged
+ * earlier are kept until then.
+ */
+void log_deferred_init(void);
+
+/**
+ * Records a format string and its arguments, as LOG_OUTPUT.
+ * \param fmt The format string. It must be a string literal or
+ * otherwise be in the firmware image, unchanged.
+ */
+void log_deferred(const char *fmt, ...)
+  __attribute__((__format__ (__printf__, 1, 2)));
+
+/**
+ * Formats now and records the resulting text, for format strings that
+ * may not be in the firmware image. The text is truncated to the size
+ * of a record.
+ * \param fmt The format string
+ */
+void log_deferred_formatted(const char *fmt, ...)
+  __attribute__((__format__ (__printf__, 1, 2)));
+
+/**
+ * Records raw data, to be formatted on the host.
+ * \param kind The record kind, from LOG_DEFERRED_LLADDR on
+ * \param data The data
+ * \param len The data length, truncated to fit in a record
+ */
+void log_deferred_data(uint8_t kind, const void *data, size_t len);
+
+/**
+ * Writes out all pending records now, e.g. before a reboot.
+ */
+void log_deferred_flush(void);
+
+#endif /* LOG_DEFERRED_H_ */
+/** @} */
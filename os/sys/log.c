@@ -92,6 +92,12 @@ struct log_module all_modules[] = {
 void
 log_6addr(const uip_ipaddr_t *ipaddr)
 {
+#if LOG_DEFERRED
+  if(ipaddr != NULL) {
+    log_deferred_data(LOG_DEFERRED_6ADDR, ipaddr, sizeof(uip_ipaddr_t));
+    return;
+  }
+#endif /* LOG_DEFERRED */
   char buf[UIPLIB_IPV6_MAX_STR_LEN];
   uiplib_ipaddr_snprint(buf, sizeof(buf), ipaddr);
   LOG_OUTPUT("%s", buf);
@@ -135,6 +141,9 @@ log_lladdr(const linkaddr_t *lladdr)
     LOG_OUTPUT("(NULL LL addr)");
     return;
   } else {
+#if LOG_DEFERRED
+    log_deferred_data(LOG_DEFERRED_LLADDR, lladdr, LINKADDR_SIZE);
+#else /* LOG_DEFERRED */
     unsigned int i;
     for(i = 0; i < LINKADDR_SIZE; i++) {
       if(i > 0 && i % 2 == 0) {
@@ -142,6 +151,7 @@ log_lladdr(const linkaddr_t *lladdr)
       }
       LOG_OUTPUT("%02x", lladdr->u8[i]);
     }
+#endif /* LOG_DEFERRED */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -166,6 +176,10 @@ log_lladdr_compact(const linkaddr_t *lladdr)
 void
 log_bytes(const void *data, size_t length)
 {
+#if LOG_DEFERRED
+  log_deferred_data(LOG_WITH_COMPACT_BYTES ? LOG_DEFERRED_BYTES
+                    : LOG_DEFERRED_BYTES_SPACED, data, length);
+#else /* LOG_DEFERRED */
   const uint8_t *u8data = (const uint8_t *)data;
   for(size_t i = 0; i < length; ++i) {
     if(LOG_WITH_COMPACT_BYTES) {
@@ -174,6 +188,7 @@ log_bytes(const void *data, size_t length)
       LOG_OUTPUT(i == 0 ? "%02x" : " %02x", u8data[i]);
     }
   }
+#endif /* LOG_DEFERRED */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -184,9 +199,13 @@ log_string(const char *text, size_t len)
     return;
   }
 
+#if LOG_DEFERRED
+  log_deferred_data(LOG_DEFERRED_STRING, text, strnlen(text, len));
+#else /* LOG_DEFERRED */
   for(int i = 0; i < len && *text != '\0'; i++, text++) {
     LOG_OUTPUT("%c", *text);
   }
+#endif /* LOG_DEFERRED */
 }
 /*---------------------------------------------------------------------------*/
 void
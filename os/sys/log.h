@@ -54,6 +54,9 @@
 #include <stdio.h>
 #include "net/linkaddr.h"
 #include "sys/log-conf.h"
+#if LOG_DEFERRED
+#include "sys/log-deferred.h"
+#endif /* LOG_DEFERRED */
 #if NETSTACK_CONF_WITH_IPV6
 #include "net/ipv6/uip.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Experiment metrics: compact records on the log output
+ */
+
+#include "contiki.h"
+#include "sys/metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if METRICS_ENABLED
+
+/* Longest metric name sent in a descriptor */
+#define MAX_NAME_LEN 32
+#define SAMPLE_LEN 12
+
+static uint8_t last_id;
+/*---------------------------------------------------------------------------*/
+static void
+output(const uint8_t *buf, int len)
+{
+  static const char hex[] = "0123456789abcdef";
+  char line[sizeof(METRICS_PREFIX) + 2 * (3 + MAX_NAME_LEN) + 1];
+  char *p;
+  int i;
+
+  memcpy(line, METRICS_PREFIX, sizeof(METRICS_PREFIX) - 1);
+  p = line + sizeof(METRICS_PREFIX) - 1;
+  for(i = 0; i < len; i++) {
+    *p++ = hex[buf[i] >> 4];
+    *p++ = hex[buf[i] & 0xf];
+  }
+  *p++ = '\n';
+  *p = '\0';
+  printf("%s", line);
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_u32(uint8_t *p, uint32_t v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+now_ms(void)
+{
+  return (uint32_t)((uint64_t)clock_time() * 1000 / CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static void
+report(struct metrics_metric *m, uint16_t index, int32_t value, uint32_t time)
+{
+  uint8_t buf[3 + MAX_NAME_LEN];
+
+  if(m->id == 0) {
+    size_t len = strlen(m->name);
+
+    if(last_id == 0xff) {
+      /* Out of IDs */
+      return;
+    }
+    m->id = ++last_id;
+    if(len > MAX_NAME_LEN) {
+      len = MAX_NAME_LEN;
+    }
+    buf[0] = 0;
+    buf[1] = m->id;
+    buf[2] = m->type;
+    memcpy(buf + 3, m->name, len);
+    output(buf, 3 + len);
+  }
+
+  buf[0] = m->type;
+  buf[1] = m->id;
+  buf[2] = index >> 8;
+  buf[3] = index;
+  put_u32(buf + 4, (uint32_t)value);
+  put_u32(buf + 8, time);
+  output(buf, SAMPLE_LEN);
+}
+/*---------------------------------------------------------------------------*/
+void
+metrics_counter_add(struct metrics_metric *m, int32_t n)
+{
+  m->value += n;
+  report(m, 0, m->value, now_ms());
+}
+/*---------------------------------------------------------------------------*/
+void
+metrics_gauge_set_at(struct metrics_metric *m, uint16_t index, int32_t value)
+{
+  m->value = value;
+  report(m, index, value, now_ms());
+}
+/*---------------------------------------------------------------------------*/
+void
+metrics_timestamp_at(struct metrics_metric *m, uint16_t index)
+{
+  uint32_t t = now_ms();
+
+  m->value = t;
+  report(m, index, t, t);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* METRICS_ENABLED */
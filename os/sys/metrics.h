@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup sys
+ * @{
+ */
+
+/**
+ * \defgroup metrics Experiment metrics
+ *
+ * Counters, gauges and timestamps reported as compact, machine-readable
+ * records on the log output, to be decoded on the host by
+ * tools/metrics/metrics-collector.py instead of scraping free-form logs.
+ *
+ * Every record is a line "#M" followed by the hex encoding of a fixed
+ * binary record. The first record of a metric is a descriptor carrying
+ * its name; later records only carry the metric's one-byte ID:
+ *
+ * - descriptor: 0x00, id, type, name (no terminator)
+ * - sample: type, id, index (uint16), value (int32), time in ms (uint32)
+ *
+ * Multi-byte fields are big-endian. The index lets a single metric
+ * describe an array, e.g. one value per cell, indexed by timeslot.
+ *
+ * @{
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include "contiki.h"
+
+/* Disabled by default; if disabled, updates are compiled out */
+#ifdef METRICS_CONF_ENABLED
+#define METRICS_ENABLED METRICS_CONF_ENABLED
+#else
+#define METRICS_ENABLED 0
+#endif
+
+/* Record prefix on the log output */
+#define METRICS_PREFIX "#M"
+
+/** Metric types, as encoded in records */
+typedef enum {
+  METRICS_TYPE_COUNTER = 1,   /**< Cumulative count, sent on every update */
+  METRICS_TYPE_GAUGE = 2,     /**< Value that is set */
+  METRICS_TYPE_TIMESTAMP = 3, /**< Time at which an event happened */
+} metrics_type_t;
+
+/** A metric. Declare with METRICS_COUNTER/GAUGE/TIMESTAMP. */
+struct metrics_metric {
+  const char *name;
+  int32_t value;
+  uint8_t type;
+  uint8_t id; /* Assigned on first use, 0 until then */
+};
+
+/**
+ * \brief Declares a metric
+ * \param var The variable name
+ * \param name The metric name, as written by the host collector
+ */
+#define METRICS_COUNTER(var, name) \
+  static struct metrics_metric var = { name, 0, METRICS_TYPE_COUNTER, 0 }
+#define METRICS_GAUGE(var, name) \
+  static struct metrics_metric var = { name, 0, METRICS_TYPE_GAUGE, 0 }
+#define METRICS_TIMESTAMP(var, name) \
+  static struct metrics_metric var = { name, 0, METRICS_TYPE_TIMESTAMP, 0 }
+
+#if METRICS_ENABLED
+
+/**
+ * \brief Adds to a counter and reports its new total
+ * \param m The counter
+ * \param n The increment
+ */
+void metrics_counter_add(struct metrics_metric *m, int32_t n);
+
+/**
+ * \brief Sets a gauge, or one element of a gauge array, and reports it
+ * \param m The gauge
+ * \param index The element index, 0 for scalars
+ * \param value The new value
+ */
+void metrics_gauge_set_at(struct metrics_metric *m, uint16_t index, int32_t value);
+
+/**
+ * \brief Reports that an event happened now
+ * \param m The timestamp metric
+ * \param index The element index, 0 for scalars
+ *
+ * The sample value is the current time in milliseconds.
+ */
+void metrics_timestamp_at(struct metrics_metric *m, uint16_t index);
+
+#else /* METRICS_ENABLED */
+
+#define metrics_counter_add(m, n) ((void)(m))
+#define metrics_gauge_set_at(m, index, value) ((void)(m))
+#define metrics_timestamp_at(m, index) ((void)(m))
+
+#endif /* METRICS_ENABLED */
+
+#define metrics_gauge_set(m, value) metrics_gauge_set_at(m, 0, value)
+#define metrics_timestamp(m) metrics_timestamp_at(m, 0)
+
+#endif /* METRICS_H_ */
+/** @} */
+/** @} */
@@ -44,9 +44,13 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "contiki.h"
 #include "sys/process.h"
+#if PROCESS_CONF_CPU_ACCOUNTING
+#include "sys/energest.h"
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
 
 #include "sys/log.h"
 #define LOG_MODULE "Process"
@@ -65,6 +69,14 @@ static_assert(PROCESS_CONF_NUMEVENTS > 0 && PROCESS_CONF_NUMEVENTS <= 128,
 static_assert(!(PROCESS_CONF_NUMEVENTS & (PROCESS_CONF_NUMEVENTS - 1)),
   "PROCESS_CONF_NUMEVENTS must be a power of 2.");
 
+/* The sum of the queue sizes must fit in a process_num_events_t too. */
+static_assert(PROCESS_CONF_PRIORITY_NUMEVENTS <= 64 &&
+  !(PROCESS_CONF_PRIORITY_NUMEVENTS & (PROCESS_CONF_PRIORITY_NUMEVENTS - 1)),
+  "PROCESS_CONF_PRIORITY_NUMEVENTS must be a power of 2 of at most 64.");
+
+static_assert(PROCESS_CONF_EVENTS_PER_RUN > 0,
+  "PROCESS_CONF_EVENTS_PER_RUN must be positive.");
+
 /*
  * A configurable function called after a process poll been requested.
  */
@@ -92,13 +104,39 @@ struct event_data {
   process_event_t ev;
 };
 
-static process_num_events_t nevents, fevent;
+/*
+ * A ring buffer of events. The size is a power of 2.
+ */
+struct event_queue {
+  struct event_data *events;
+  process_num_events_t size;
+  process_num_events_t first;
+  process_num_events_t count;
+};
+
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+static struct event_queue queue = { events, PROCESS_CONF_NUMEVENTS, 0, 0 };
+
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+static struct event_data priority_events[PROCESS_CONF_PRIORITY_NUMEVENTS];
+static struct event_queue priority_queue = {
+  priority_events, PROCESS_CONF_PRIORITY_NUMEVENTS, 0, 0
+};
+#define NEVENTS() (queue.count + priority_queue.count)
+#else
+#define NEVENTS() (queue.count)
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+static uint32_t process_dropped_events;
 #endif
 
+#if PROCESS_CONF_CPU_ACCOUNTING
+/* Time spent in the processes called from the one being measured */
+static uint64_t nested_ticks;
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+
 static volatile bool poll_requested;
 
 #define PROCESS_STATE_NONE        0
@@ -195,9 +233,60 @@ exit_process(struct process *p, const struct process *fromprocess)
   process_current = old_current;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CPU_ACCOUNTING
+static void
+account_cpu(struct process *p, process_event_t ev,
+            ENERGEST_TIME_T start, uint64_t outer_nested_ticks)
+{
+  ENERGEST_TIME_T elapsed = (ENERGEST_TIME_T)(ENERGEST_CURRENT_TIME() - start);
+  uint64_t self = elapsed > nested_ticks ? elapsed - nested_ticks : 0;
+
+  if(ev == PROCESS_EVENT_POLL) {
+    p->cpu.poll_ticks += self;
+    p->cpu.polls++;
+  } else {
+    p->cpu.event_ticks += self;
+    p->cpu.events++;
+  }
+  if(self > p->cpu.max_ticks) {
+    p->cpu.max_ticks = self > UINT32_MAX ? UINT32_MAX : (uint32_t)self;
+  }
+
+  /* The whole call is nested time for the calling process, if any */
+  nested_ticks = outer_nested_ticks + elapsed;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_cpu_reset(void)
+{
+  struct process *p;
+
+  for(p = process_list; p != NULL; p = p->next) {
+    memset(&p->cpu, 0, sizeof(p->cpu));
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+process_cpu_mark(void)
+{
+  struct process *p;
+
+  for(p = process_list; p != NULL; p = p->next) {
+    p->cpu.mark_ticks = PROCESS_CPU_TICKS(p);
+    p->cpu.mark_events = p->cpu.events;
+    p->cpu.mark_polls = p->cpu.polls;
+  }
+}
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+/*---------------------------------------------------------------------------*/
 static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
+#if PROCESS_CONF_CPU_ACCOUNTING
+  ENERGEST_TIME_T start;
+  uint64_t outer_nested_ticks;
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+
   if(p->state == PROCESS_STATE_CALLED) {
     LOG_DBG("process '%s' called again with event %d\n",
             PROCESS_NAME_STRING(p), ev);
@@ -209,7 +298,15 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
             PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_CONF_CPU_ACCOUNTING
+    outer_nested_ticks = nested_ticks;
+    nested_ticks = 0;
+    start = ENERGEST_CURRENT_TIME();
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
     int ret = p->thread(&p->pt, ev, data);
+#if PROCESS_CONF_CPU_ACCOUNTING
+    account_cpu(p, ev, start, outer_nested_ticks);
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
     if(ret == PT_EXITED || ret == PT_ENDED || ev == PROCESS_EVENT_EXIT) {
       exit_process(p, p);
     } else {
@@ -256,6 +353,15 @@ do_poll(void)
 static void
 do_event(void)
 {
+  struct event_queue *q = &queue;
+
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  /* Events to processes of high priority go first. */
+  if(priority_queue.count > 0) {
+    q = &priority_queue;
+  }
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
   /*
    * If there are any events in the queue, take the first one and walk
    * through the list of processes to see if the event should be
@@ -263,17 +369,17 @@ do_event(void)
    * function for the process. We only process one event at a time and
    * call the poll handlers inbetween.
    */
-  if(nevents > 0) {
+  if(q->count > 0) {
 
     /* There are events that we should deliver. */
-    process_event_t ev = events[fevent].ev;
-    process_data_t data = events[fevent].data;
-    struct process *receiver = events[fevent].p;
+    process_event_t ev = q->events[q->first].ev;
+    process_data_t data = q->events[q->first].data;
+    struct process *receiver = q->events[q->first].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
-    --nevents;
+    q->first = (q->first + 1) & (q->size - 1);
+    --q->count;
 
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
@@ -304,49 +410,80 @@ do_event(void)
 process_num_events_t
 process_run(void)
 {
-  /* Process poll events. */
-  if(poll_requested) {
-    do_poll();
-  }
+  unsigned n = 0;
 
-  /* Process one event from the queue */
-  do_event();
+  do {
+    /* Process poll events. */
+    if(poll_requested) {
+      do_poll();
+    }
 
-  return nevents + poll_requested;
+    /* Process one event from the queue */
+    do_event();
+  } while(++n < PROCESS_CONF_EVENTS_PER_RUN && NEVENTS() > 0);
+
+  return NEVENTS() + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
 process_num_events_t
 process_nevents(void)
 {
-  return nevents + poll_requested;
+  return NEVENTS() + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+void
+process_stats_get(struct process_stats *stats)
+{
+  stats->max_events = process_maxevents;
+  stats->dropped_events = process_dropped_events;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_stats_reset(void)
+{
+  process_maxevents = NEVENTS();
+  process_dropped_events = 0;
+}
+#endif /* PROCESS_CONF_STATS */
+/*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  struct event_queue *q = &queue;
+
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  if(p != PROCESS_BROADCAST && p->priority != PROCESS_PRIORITY_NORMAL) {
+    q = &priority_queue;
+  }
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
+  if(q->count == q->size) {
     LOG_WARN("Cannot post event %d to %s from %s because the queue is full\n",
              ev,
              p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p),
              PROCESS_NAME_STRING(process_current));
+#if PROCESS_CONF_STATS
+    process_dropped_events++;
+#endif /* PROCESS_CONF_STATS */
     return PROCESS_ERR_FULL;
   }
 
   LOG_DBG("Process '%s' posts event %d to process '%s', nevents %d\n",
           PROCESS_NAME_STRING(PROCESS_CURRENT()),
           ev, p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p),
-          nevents);
+          NEVENTS());
 
   process_num_events_t snum =
-    (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
-  ++nevents;
+    (process_num_events_t)(q->first + q->count) & (q->size - 1);
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->count;
 
 #if PROCESS_CONF_STATS
-  if(nevents > process_maxevents) {
-    process_maxevents = nevents;
+  if(NEVENTS() > process_maxevents) {
+    process_maxevents = NEVENTS();
   }
 #endif /* PROCESS_CONF_STATS */
 
@@ -90,6 +90,34 @@ typedef uint8_t       process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * Size of a second event queue, for the events posted to processes of
+ * high priority (see process_set_priority()). Events in this queue are
+ * delivered before those of the main queue. 0 disables priorities.
+ */
+#ifndef PROCESS_CONF_PRIORITY_NUMEVENTS
+#define PROCESS_CONF_PRIORITY_NUMEVENTS 0
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
+/* Maximum number of events delivered by one call to process_run() */
+#ifndef PROCESS_CONF_EVENTS_PER_RUN
+#define PROCESS_CONF_EVENTS_PER_RUN 1
+#endif /* PROCESS_CONF_EVENTS_PER_RUN */
+
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+
+/*
+ * Per-process CPU time accounting: the time spent in every call of a
+ * process thread is measured with the Energest time source
+ * (ENERGEST_CURRENT_TIME) and accumulated in the process structure,
+ * separately for polls and for events. Time spent in processes called
+ * synchronously from a process is only accounted to the callee.
+ */
+#ifndef PROCESS_CONF_CPU_ACCOUNTING
+#define PROCESS_CONF_CPU_ACCOUNTING 0
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -313,6 +341,22 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+#if PROCESS_CONF_CPU_ACCOUNTING
+/** CPU time spent in a process, in ENERGEST_CURRENT_TIME ticks */
+struct process_cpu {
+  uint64_t event_ticks;
+  uint64_t poll_ticks;
+  uint32_t events;
+  uint32_t polls;
+  /* Longest single call */
+  uint32_t max_ticks;
+  /* Totals at the last process_cpu_mark(), for periodic reports */
+  uint64_t mark_ticks;
+  uint32_t mark_events;
+  uint32_t mark_polls;
+};
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -325,6 +369,12 @@ struct process {
   struct pt pt;
   uint8_t state;
   bool needspoll;
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  uint8_t priority;
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+#if PROCESS_CONF_CPU_ACCOUNTING
+  struct process_cpu cpu;
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
 };
 
 /**
@@ -366,6 +416,27 @@ void process_start(struct process *p, process_data_t data);
  */
 int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Set the priority of a process.
+ *
+ * Events posted to a process of priority PROCESS_PRIORITY_HIGH go to a
+ * separate queue, which is emptied before the main one, so that they
+ * do not wait behind broadcasts and timer events of other processes.
+ * Meant for the processes of the network stack. Has no effect unless
+ * PROCESS_CONF_PRIORITY_NUMEVENTS is non-zero.
+ *
+ * \param p The process.
+ *
+ * \param prio PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+#define process_set_priority(p, prio) ((p)->priority = (prio))
+#else
+#define process_set_priority(p, prio)
+#endif
+
 /**
  * Post a synchronous event to a process.
  *
@@ -497,7 +568,9 @@ void process_init(void);
  *
  * This function should be called repeatedly from the main() program
  * to actually run the Contiki system. It calls the necessary poll
- * handlers, and processes one event. The function returns the number
+ * handlers, and processes one event, or up to
+ * PROCESS_CONF_EVENTS_PER_RUN events with poll handlers called in
+ * between. The function returns the number
  * of events that are waiting in the event queue so that the caller
  * may choose to put the CPU to sleep when there are no pending
  * events.
@@ -527,6 +600,60 @@ bool process_is_running(struct process *p);
  */
 process_num_events_t process_nevents(void);
 
+#if PROCESS_CONF_STATS
+/** Statistics of the event queues */
+struct process_stats {
+  /** Highest number of events that have been queued at the same time */
+  process_num_events_t max_events;
+  /** Number of events that could not be posted because of a full queue */
+  uint32_t dropped_events;
+};
+
+/**
+ * Get the statistics of the event queues since boot, or since the last
+ * call to process_stats_reset().
+ *
+ * \param stats Where to store the statistics.
+ */
+void process_stats_get(struct process_stats *stats);
+
+/**
+ * Clear the statistics of the event queues.
+ */
+void process_stats_reset(void);
+#endif /* PROCESS_CONF_STATS */
+
+#if PROCESS_CONF_CPU_ACCOUNTING
+/**
+ * Total CPU time of a process, polls and events included.
+ *
+ * \param p The process.
+ * \return The number of ENERGEST_CURRENT_TIME ticks spent in the process.
+ */
+#define PROCESS_CPU_TICKS(p) ((p)->cpu.event_ticks + (p)->cpu.poll_ticks)
+
+/**
+ * Clear the CPU time accounted to all running processes.
+ */
+void process_cpu_reset(void);
+
+/**
+ * CPU time of a process since the last process_cpu_mark().
+ *
+ * \param p The process.
+ * \return The number of ENERGEST_CURRENT_TIME ticks spent in the process
+ * since the last call to process_cpu_mark().
+ */
+#define PROCESS_CPU_TICKS_SINCE_MARK(p) \
+  (PROCESS_CPU_TICKS(p) - (p)->cpu.mark_ticks)
+
+/**
+ * Record the current totals of all running processes, so that periodic
+ * reports can show the time spent since without clearing the totals.
+ */
+void process_cpu_mark(void);
+#endif /* PROCESS_CONF_CPU_ACCOUNTING */
+
 /** @} */
 
 extern struct process *process_list;
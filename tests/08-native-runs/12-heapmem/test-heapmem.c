@@ -67,6 +67,18 @@
 #define TEST_MAX_SIZE       200
 #endif
 /*****************************************************************************/
+/* Configuration for the Fragmentation stress test. */
+
+/* Total number of allocations. */
+#ifdef TEST_CONF_STRESS_LIMIT
+#define TEST_STRESS_LIMIT TEST_CONF_STRESS_LIMIT
+#else
+#define TEST_STRESS_LIMIT 1000000
+#endif
+
+/* Maximum number of concurrent allocations. */
+#define TEST_STRESS_CONCURRENT 64
+/*****************************************************************************/
 PROCESS(test_heapmem_process, "Heapmem test process");
 AUTOSTART_PROCESSES(&test_heapmem_process);
 /*****************************************************************************/
@@ -292,6 +304,71 @@ UNIT_TEST(stats_check)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+UNIT_TEST_REGISTER(fragmentation_stress, "Fragmentation stress");
+UNIT_TEST(fragmentation_stress)
+{
+  UNIT_TEST_BEGIN();
+
+  char *ptrs[TEST_STRESS_CONCURRENT] = { NULL };
+  unsigned failed_allocations = 0;
+  unsigned max_fragmentation = 0;
+  heapmem_stats_t stats;
+
+  /*
+   * Mimic the churn of protocol buffers: mostly small objects, mixed
+   * with block buffers of up to 1 KiB, freed in random order.
+   */
+  rtimer_clock_t start = RTIMER_NOW();
+  for(unsigned count = 0; count < TEST_STRESS_LIMIT; count++) {
+    unsigned alloc_index = rand() % TEST_STRESS_CONCURRENT;
+    if(ptrs[alloc_index] != NULL) {
+      heapmem_free(ptrs[alloc_index]);
+    }
+
+    size_t alloc_size = (rand() % 4) ? 8 + rand() % 56 : 256 + rand() % 769;
+    ptrs[alloc_index] = heapmem_alloc(alloc_size);
+    if(ptrs[alloc_index] == NULL) {
+      failed_allocations++;
+    }
+
+    if(count % (TEST_STRESS_LIMIT / 100) == 0) {
+      heapmem_stats(&stats);
+      if(stats.fragmentation > max_fragmentation) {
+        max_fragmentation = stats.fragmentation;
+      }
+    }
+  }
+  rtimer_clock_t elapsed = RTIMER_NOW() - start;
+
+  heapmem_stats(&stats);
+  printf("Stress: %u allocations in %lu ticks, %lu ns per allocation and free\n",
+         TEST_STRESS_LIMIT, (unsigned long)elapsed,
+         (unsigned long)((unsigned long long)elapsed * 1000000000ull
+                         / RTIMER_SECOND / TEST_STRESS_LIMIT));
+  printf("Stress: footprint %zu, %zu free chunks, fragmentation %u%% (max %u%%)\n",
+         stats.footprint, stats.free_chunks, stats.fragmentation,
+         max_fragmentation);
+
+  for(unsigned alloc_index = 0; alloc_index < TEST_STRESS_CONCURRENT;
+      alloc_index++) {
+    if(ptrs[alloc_index] != NULL) {
+      UNIT_TEST_ASSERT(heapmem_free(ptrs[alloc_index]));
+    }
+  }
+
+  UNIT_TEST_ASSERT(failed_allocations == 0);
+
+  /* All free chunks must have been coalesced and released. */
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+  UNIT_TEST_ASSERT(stats.fragmentation == 0);
+  UNIT_TEST_ASSERT(stats.available == HEAPMEM_CONF_ARENA_SIZE);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 UNIT_TEST_REGISTER(zones, "Zone allocations");
 UNIT_TEST(zones)
 {
@@ -307,6 +384,16 @@ UNIT_TEST(zones)
 
   void *ptr = heapmem_zone_alloc(zone, 100);
   UNIT_TEST_ASSERT(ptr != NULL);
+
+  heapmem_stats_t stats;
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.zones[zone].zone_size == 1000);
+  UNIT_TEST_ASSERT(stats.zones[zone].chunks == 1);
+  UNIT_TEST_ASSERT(stats.zones[zone].allocated > 100);
+  UNIT_TEST_ASSERT(stats.zones[zone].largest_free <
+                   1000 - stats.zones[zone].allocated);
+  UNIT_TEST_ASSERT(stats.zones[HEAPMEM_ZONE_GENERAL].chunks == 0);
+
   UNIT_TEST_ASSERT(heapmem_free(ptr) != false);
 
   UNIT_TEST_ASSERT(heapmem_zone_alloc(zone, 1001) == NULL);
@@ -334,6 +421,7 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(reallocations);
   UNIT_TEST_RUN(zero_init_alloc);
   UNIT_TEST_RUN(stats_check);
+  UNIT_TEST_RUN(fragmentation_stress);
   UNIT_TEST_RUN(zones);
 
   if(!UNIT_TEST_PASSED(do_many_allocations) ||
@@ -342,6 +430,7 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
      !UNIT_TEST_PASSED(reallocations) ||
      !UNIT_TEST_PASSED(zero_init_alloc) ||
      !UNIT_TEST_PASSED(stats_check) ||
+     !UNIT_TEST_PASSED(fragmentation_stress) ||
      !UNIT_TEST_PASSED(zones)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Randomised stress test of event timers: timers of several
+ *         processes are set, reset, restarted, adjusted and stopped at
+ *         random, and their processes exit and restart, while checking
+ *         that every pending timer fires once, not early, and that
+ *         stopped timers never fire. Run with ETIMER_CONF_HEAP_SIZE set
+ *         to 0, to a value below NUM_TIMERS (heap overflowing into the
+ *         list), and to a value above it.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_WORKERS        4
+#define TIMERS_PER_WORKER 16
+#define NUM_TIMERS        (NUM_WORKERS * TIMERS_PER_WORKER)
+
+/* Number of rounds, one clock tick apart, and operations per round */
+#define ROUNDS          2000
+#define OPS_PER_ROUND      8
+/* One round out of EXIT_INTERVAL has a worker process exit */
+#define EXIT_INTERVAL    100
+#define MAX_INTERVAL      64
+/* Time allowed for the pending timers to fire after the last round */
+#define DRAIN_TIME  (4 * MAX_INTERVAL)
+
+static struct etimer timers[NUM_TIMERS];
+/* Whether the timer is set and has not fired yet */
+static bool armed[NUM_TIMERS];
+static struct etimer round_timer;
+
+static unsigned long ops;
+static unsigned long fired;
+static unsigned long early;
+static unsigned long unexpected;
+/*---------------------------------------------------------------------------*/
+static void
+timer_fired(process_event_t ev, process_data_t data)
+{
+  struct etimer *et = data;
+  int i;
+
+  if(ev != PROCESS_EVENT_TIMER) {
+    return;
+  }
+  i = et - timers;
+  if(i < 0 || i >= NUM_TIMERS || !armed[i]) {
+    unexpected++;
+    return;
+  }
+  if(!timer_expired(&et->timer)) {
+    early++;
+  }
+  armed[i] = false;
+  fired++;
+}
+/*---------------------------------------------------------------------------*/
+#define WORKER(n)                                     \
+  PROCESS(worker##n, "Worker " #n);                   \
+  PROCESS_THREAD(worker##n, ev, data)                 \
+  {                                                   \
+    PROCESS_BEGIN();                                  \
+    while(1) {                                        \
+      PROCESS_WAIT_EVENT();                           \
+      timer_fired(ev, data);                          \
+    }                                                 \
+    PROCESS_END();                                    \
+  }
+
+WORKER(0)
+WORKER(1)
+WORKER(2)
+WORKER(3)
+
+static struct process *const workers[NUM_WORKERS] = {
+  &worker0, &worker1, &worker2, &worker3
+};
+
+PROCESS(test_process, "etimer test");
+AUTOSTART_PROCESSES(&test_process);
+/*---------------------------------------------------------------------------*/
+static void
+random_op(void)
+{
+  int i = random_rand() % NUM_TIMERS;
+  struct etimer *et = &timers[i];
+  clock_time_t interval = 1 + random_rand() % MAX_INTERVAL;
+
+  /* Leave alone the timers that have expired: their event may be on its
+   * way to the worker */
+  if(armed[i] && timer_expired(&et->timer)) {
+    return;
+  }
+
+  ops++;
+  PROCESS_CONTEXT_BEGIN(workers[i / TIMERS_PER_WORKER]);
+  if(!armed[i]) {
+    etimer_set(et, interval);
+    armed[i] = true;
+  } else {
+    switch(random_rand() % 5) {
+    case 0:
+      etimer_stop(et);
+      armed[i] = false;
+      break;
+    case 1:
+      etimer_restart(et);
+      break;
+    case 2:
+      etimer_reset_with_new_interval(et, interval);
+      break;
+    case 3:
+      etimer_adjust(et, (int)(random_rand() % MAX_INTERVAL) - MAX_INTERVAL / 2);
+      break;
+    default:
+      etimer_set(et, interval);
+      break;
+    }
+  }
+  PROCESS_CONTEXT_END(workers[i / TIMERS_PER_WORKER]);
+}
+/*---------------------------------------------------------------------------*/
+static void
+exit_worker(int w)
+{
+  int i;
+
+  /* The timers of the process are dropped as it exits */
+  process_exit(workers[w]);
+  for(i = w * TIMERS_PER_WORKER; i < (w + 1) * TIMERS_PER_WORKER; i++) {
+    armed[i] = false;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+any_armed(void)
+{
+  int i;
+
+  for(i = 0; i < NUM_TIMERS; i++) {
+    if(armed[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(stress, "Random set/stop/adjust/exit");
+UNIT_TEST(stress)
+{
+  static int round;
+  static int exited;
+  static clock_time_t deadline;
+  int w;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  exited = -1;
+  for(round = 0; round < ROUNDS; round++) {
+    /* The worker exited in the previous round has had its pending events
+     * dropped by now */
+    if(exited >= 0) {
+      process_start(workers[exited], NULL);
+      exited = -1;
+    }
+    for(i = 0; i < OPS_PER_ROUND; i++) {
+      random_op();
+    }
+    if(round % EXIT_INTERVAL == EXIT_INTERVAL - 1) {
+      exited = random_rand() % NUM_WORKERS;
+      exit_worker(exited);
+    }
+
+    etimer_set(&round_timer, 1);
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&round_timer));
+  }
+  if(exited >= 0) {
+    process_start(workers[exited], NULL);
+  }
+
+  /* Every timer still set must fire */
+  deadline = clock_time() + DRAIN_TIME;
+  while(any_armed() && clock_time() < deadline) {
+    etimer_set(&round_timer, 1);
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&round_timer));
+  }
+
+  for(i = 0; i < NUM_TIMERS; i++) {
+    if(armed[i]) {
+      printf("Timer %d did not fire\n", i);
+    }
+  }
+  UNIT_TEST_ASSERT(!any_armed());
+
+  /* Set all timers, then have all workers exit: none of them may fire */
+  for(i = 0; i < NUM_TIMERS; i++) {
+    PROCESS_CONTEXT_BEGIN(workers[i / TIMERS_PER_WORKER]);
+    etimer_set(&timers[i], 1 + random_rand() % MAX_INTERVAL);
+    PROCESS_CONTEXT_END(workers[i / TIMERS_PER_WORKER]);
+  }
+  for(w = 0; w < NUM_WORKERS; w++) {
+    exit_worker(w);
+  }
+  etimer_set(&round_timer, 2 * MAX_INTERVAL);
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&round_timer));
+
+  printf("%lu operations, %lu timers fired, %lu early, %lu unexpected\n",
+         ops, fired, early, unexpected);
+  UNIT_TEST_ASSERT(early == 0);
+  UNIT_TEST_ASSERT(unexpected == 0);
+  UNIT_TEST_ASSERT(fired > 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  int w;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  printf("etimer heap size %u, %u timers\n",
+         (unsigned)ETIMER_HEAP_SIZE, NUM_TIMERS);
+  random_init(0x1234);
+  for(w = 0; w < NUM_WORKERS; w++) {
+    process_start(workers[w], NULL);
+  }
+
+  UNIT_TEST_RUN(stress);
+
+  if(!UNIT_TEST_PASSED(stress)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests of the process event queues: an event posted to a
+ *         high-priority process after a flood of events to another
+ *         process, and the statistics of a queue that overflows. Run
+ *         with PROCESS_CONF_PRIORITY_NUMEVENTS set to 0 and non-zero.
+ */
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+/* Number of events posted ahead of the urgent one */
+#define FLOOD 8
+
+static process_event_t flood_event;
+static unsigned sink_events;
+/* Events to the sink dispatched before the urgent one, -1 until then */
+static int sink_events_before_urgent;
+static struct etimer wait_timer;
+
+PROCESS(sink_process, "Sink");
+PROCESS(urgent_process, "Urgent");
+PROCESS(test_process, "Process events test");
+AUTOSTART_PROCESSES(&test_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == flood_event);
+    sink_events++;
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(urgent_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == flood_event);
+    sink_events_before_urgent = sink_events;
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(priority, "High-priority event after a flood");
+UNIT_TEST(priority)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  sink_events = 0;
+  sink_events_before_urgent = -1;
+  for(i = 0; i < FLOOD; i++) {
+    UNIT_TEST_ASSERT(process_post(&sink_process, flood_event, NULL) == PROCESS_ERR_OK);
+  }
+  UNIT_TEST_ASSERT(process_post(&urgent_process, flood_event, NULL) == PROCESS_ERR_OK);
+
+  while(sink_events < FLOOD || sink_events_before_urgent < 0) {
+    etimer_set(&wait_timer, 1);
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&wait_timer));
+  }
+
+  printf("Urgent event dispatched after %d of %d flood events\n",
+         sink_events_before_urgent, FLOOD);
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  UNIT_TEST_ASSERT(sink_events_before_urgent == 0);
+#else /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+  UNIT_TEST_ASSERT(sink_events_before_urgent == FLOOD);
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "Queue overflow statistics");
+UNIT_TEST(overflow)
+{
+  struct process_stats stats;
+  static unsigned posted;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  process_stats_reset();
+  process_stats_get(&stats);
+  UNIT_TEST_ASSERT(stats.dropped_events == 0);
+
+  /* Fill the queue, then try a few more */
+  sink_events = 0;
+  posted = 0;
+  while(process_post(&sink_process, flood_event, NULL) == PROCESS_ERR_OK) {
+    posted++;
+    UNIT_TEST_ASSERT(posted <= PROCESS_CONF_NUMEVENTS);
+  }
+  for(i = 0; i < 3; i++) {
+    UNIT_TEST_ASSERT(process_post(&sink_process, flood_event, NULL) == PROCESS_ERR_FULL);
+  }
+
+  process_stats_get(&stats);
+  printf("Posted %u events, max %u queued, %lu dropped\n",
+         posted, (unsigned)stats.max_events, (unsigned long)stats.dropped_events);
+  UNIT_TEST_ASSERT(stats.dropped_events == 4);
+  UNIT_TEST_ASSERT(stats.max_events >= PROCESS_CONF_NUMEVENTS);
+
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  /* The priority queue is not affected by the full normal queue */
+  sink_events_before_urgent = -1;
+  UNIT_TEST_ASSERT(process_post(&urgent_process, flood_event, NULL) == PROCESS_ERR_OK);
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
+  while(sink_events < posted) {
+    etimer_set(&wait_timer, 1);
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&wait_timer));
+  }
+#if PROCESS_CONF_PRIORITY_NUMEVENTS
+  UNIT_TEST_ASSERT(sink_events_before_urgent == 0);
+#endif /* PROCESS_CONF_PRIORITY_NUMEVENTS */
+
+  /* The counters restart from the current state */
+  process_stats_reset();
+  process_stats_get(&stats);
+  UNIT_TEST_ASSERT(stats.dropped_events == 0);
+  UNIT_TEST_ASSERT(stats.max_events < PROCESS_CONF_NUMEVENTS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  printf("Event queue %u, priority queue %u\n",
+         PROCESS_CONF_NUMEVENTS, PROCESS_CONF_PRIORITY_NUMEVENTS);
+  flood_event = process_alloc_event();
+  process_start(&sink_process, NULL);
+  process_start(&urgent_process, NULL);
+  process_set_priority(&urgent_process, PROCESS_PRIORITY_HIGH);
+
+  UNIT_TEST_RUN(priority);
+  UNIT_TEST_RUN(overflow);
+
+  if(!UNIT_TEST_PASSED(priority) || !UNIT_TEST_PASSED(overflow)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
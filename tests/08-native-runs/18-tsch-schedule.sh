@@ -0,0 +1,4 @@
+#!/bin/sh -e
+
+make -C ../../tools/native-sim
+TEST_RUNNER="../../../tools/native-sim/native-sim -t 60" ./run-one.sh 18-tsch-schedule
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests of the TSCH schedule that do not need TSCH to run: the
+ *         neighbor of links, compact or not, as links come and go and
+ *         neighbor entries are freed and reused, the slotframe registry
+ *         with slotframes of non-coprime lengths, and the per-cell ETX of
+ *         link-stats as cells are added and removed. Runs as a single node
+ *         of tools/native-sim, the only native radio TSCH supports.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/link-stats.h"
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+/* Fills the neighbor table, next to the broadcast and EB neighbors */
+#define NUM_NBRS (NBR_TABLE_MAX_NEIGHBORS - 2)
+
+PROCESS(test_process, "TSCH schedule test");
+AUTOSTART_PROCESSES(&test_process);
+/*---------------------------------------------------------------------------*/
+static void
+nbr_addr(linkaddr_t *addr, uint8_t n)
+{
+  linkaddr_copy(addr, &linkaddr_null);
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 1] = n;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether a link resolves to the neighbor entry of addr, both ways.
+ * Only compact links keep an entry for Rx-only links. */
+static bool
+link_is_to(const struct tsch_link *l, const linkaddr_t *addr)
+{
+  return l != NULL
+    && linkaddr_cmp(tsch_schedule_get_link_addr(l), addr)
+    && (!TSCH_SCHEDULE_COMPACT_LINKS || tsch_schedule_get_link_nbr(l) != NULL)
+    && tsch_schedule_get_link_nbr(l) == tsch_queue_get_nbr(addr);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(link_nbr, "Link neighbors: add, remove, reuse");
+UNIT_TEST(link_nbr)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *links[NUM_NBRS];
+  struct tsch_link *rx_link;
+  struct tsch_link *l;
+  linkaddr_t addr[NUM_NBRS + 1];
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  tsch_nbr_index_t freed_index;
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  sf = tsch_schedule_add_slotframe(0, 17);
+  UNIT_TEST_ASSERT(sf != NULL);
+
+  /* One Tx link per neighbor */
+  for(i = 0; i < NUM_NBRS; i++) {
+    nbr_addr(&addr[i], i + 1);
+    links[i] = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                      &addr[i], i, 1, 1);
+    UNIT_TEST_ASSERT(links[i] != NULL);
+  }
+  for(i = 0; i < NUM_NBRS; i++) {
+    UNIT_TEST_ASSERT(link_is_to(links[i], &addr[i]));
+    UNIT_TEST_ASSERT(tsch_queue_get_nbr(&addr[i])->tx_links_count == 1);
+  }
+
+  /* Links without neighbor map to the EB neighbor */
+  l = tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             NULL, 10, 0, 1);
+  UNIT_TEST_ASSERT(link_is_to(l, &linkaddr_null));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, l));
+
+  /* An Rx-only link to the second neighbor */
+  rx_link = tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                                   &addr[1], 11, 2, 1);
+  UNIT_TEST_ASSERT(link_is_to(rx_link, &addr[1]));
+
+  /* Without Tx links, the first two neighbors are freed, unless a link
+   * still refers to them by index */
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  freed_index = links[0]->nbr_index;
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, links[0]));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, links[1]));
+  tsch_queue_free_unused_neighbors();
+  UNIT_TEST_ASSERT(tsch_queue_get_nbr(&addr[0]) == NULL);
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  UNIT_TEST_ASSERT(tsch_queue_get_nbr(&addr[1]) != NULL);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+  UNIT_TEST_ASSERT(link_is_to(rx_link, &addr[1]));
+
+  /* A new neighbor takes the freed entry: the remaining links still
+   * resolve to their own neighbors */
+  nbr_addr(&addr[NUM_NBRS], NUM_NBRS + 1);
+  links[0] = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                    &addr[NUM_NBRS], 12, 3, 1);
+  UNIT_TEST_ASSERT(link_is_to(links[0], &addr[NUM_NBRS]));
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  UNIT_TEST_ASSERT(links[0]->nbr_index == freed_index);
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+  UNIT_TEST_ASSERT(link_is_to(rx_link, &addr[1]));
+  for(i = 2; i < NUM_NBRS; i++) {
+    UNIT_TEST_ASSERT(link_is_to(links[i], &addr[i]));
+  }
+
+  /* Removing every link lets all neighbors go */
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, rx_link));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf));
+  tsch_queue_free_unused_neighbors();
+  for(i = 0; i <= NUM_NBRS; i++) {
+    UNIT_TEST_ASSERT(tsch_queue_get_nbr(&addr[i]) == NULL);
+  }
+
+#if TSCH_SCHEDULE_COMPACT_LINKS
+  /* Values compact links cannot hold are rejected */
+  UNIT_TEST_ASSERT(tsch_schedule_add_slotframe(256, 7) == NULL);
+  sf = tsch_schedule_add_slotframe(1, 7);
+  UNIT_TEST_ASSERT(sf != NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                          &addr[2], 0, 256, 1) == NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf));
+#endif /* TSCH_SCHEDULE_COMPACT_LINKS */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reservations, "Slotframe registry: non-coprime overlaps");
+UNIT_TEST(reservations)
+{
+  /* An Orchestra-like owner with a 6-slot slotframe that reserves timeslot 0
+   * and a 5-slot one that reserves it all, next to an SF-like owner */
+  static const char *owner_a = "rules";
+  static const char *owner_b = "sf";
+  struct tsch_slotframe *sf_a6, *sf_a5, *sf_b4, *sf_b9;
+  uint16_t ha6, ha5, hb4, hb9;
+  linkaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  nbr_addr(&addr, 1);
+
+  UNIT_TEST_ASSERT(tsch_schedule_allocate_slotframe_handle(owner_a, &ha6));
+  UNIT_TEST_ASSERT(tsch_schedule_allocate_slotframe_handle(owner_a, &ha5));
+  UNIT_TEST_ASSERT(tsch_schedule_allocate_slotframe_handle(owner_b, &hb4));
+  UNIT_TEST_ASSERT(tsch_schedule_allocate_slotframe_handle(owner_b, &hb9));
+  UNIT_TEST_ASSERT(ha6 != ha5 && ha5 != hb4 && hb4 != hb9);
+  UNIT_TEST_ASSERT(tsch_schedule_get_owner(ha6) == owner_a);
+  UNIT_TEST_ASSERT(tsch_schedule_get_owner(hb9) == owner_b);
+
+  sf_a6 = tsch_schedule_add_slotframe(ha6, 6);
+  sf_a5 = tsch_schedule_add_slotframe(ha5, 5);
+  sf_b4 = tsch_schedule_add_slotframe(hb4, 4);
+  sf_b9 = tsch_schedule_add_slotframe(hb9, 9);
+  UNIT_TEST_ASSERT(sf_a6 != NULL && sf_a5 != NULL && sf_b4 != NULL && sf_b9 != NULL);
+
+  UNIT_TEST_ASSERT(tsch_schedule_reserve_timeslots(owner_a, ha6, 0, 1));
+  UNIT_TEST_ASSERT(tsch_schedule_reserve_timeslots(owner_a, ha5, 0, 5));
+  /* Ranges of another owner on the same handle may not overlap */
+  UNIT_TEST_ASSERT(!tsch_schedule_reserve_timeslots(owner_b, ha6, 0, 2));
+  UNIT_TEST_ASSERT(tsch_schedule_reserve_timeslots(owner_a, ha6, 0, 2));
+
+  /* Timeslots 0 and 1 of sf_a6 meet the even, resp. odd timeslots of sf_b4
+   * (gcd 2), and the timeslots 0, 3, 6, resp. 1, 4, 7 of sf_b9 (gcd 3).
+   * sf_a5 is coprime with both, and is ignored despite being reserved */
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_b, sf_b4, 0));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_b, sf_b4, 3));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_b, sf_b9, 4));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_b, sf_b9, 2));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_b, sf_b9, 8));
+  /* The reservations of an owner do not get in its own way */
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a6, 1));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a5, 0));
+
+  /* A link of sf_b9 at timeslot 5 takes the timeslots 2 and 5 of sf_a6 */
+  UNIT_TEST_ASSERT(tsch_schedule_add_link(sf_b9, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                          &addr, 5, 0, 1) != NULL);
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_b, sf_b9, 5));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_a, sf_a6, 2));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_a, sf_a6, 5));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a6, 4));
+
+  /* A range of sf_b4 reserved by owner_b takes the timeslots of the same
+   * parity in sf_a6: only timeslot 3 of sf_a6 is left free */
+  UNIT_TEST_ASSERT(tsch_schedule_reserve_timeslots(owner_b, hb4, 2, 1));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_a, sf_a6, 4));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a6, 3));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a5, 2));
+
+  /* Releasing owner_b gives its ranges back, but not its links */
+  tsch_schedule_release(owner_b);
+  UNIT_TEST_ASSERT(tsch_schedule_get_owner(hb4) == NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a6, 4));
+  UNIT_TEST_ASSERT(!tsch_schedule_is_cell_free(owner_a, sf_a6, 5));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf_b4));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf_b9));
+  UNIT_TEST_ASSERT(tsch_schedule_is_cell_free(owner_a, sf_a6, 5));
+
+  tsch_schedule_release(owner_a);
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf_a6));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf_a5));
+  tsch_queue_free_unused_neighbors();
+
+  UNIT_TEST_END();
+}
+#if LINK_STATS_PER_CELL_ETX
+/*---------------------------------------------------------------------------*/
+/* As many Tx cells to the parent as a 6P child may have */
+#define NUM_CELLS 30
+/* Cells below this index lose half of their packets */
+#define NUM_BAD_CELLS 10
+
+UNIT_TEST_REGISTER(cell_etx, "Link-stats: per-cell counts and ETX");
+UNIT_TEST(cell_etx)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *links[NUM_CELLS];
+  struct tsch_link *other_link;
+  const struct link_stats_cell *c;
+  linkaddr_t parent, other;
+  uint16_t tx_count, ack_count;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  nbr_addr(&parent, 1);
+  nbr_addr(&other, 2);
+
+  /* The table holds every link of the schedule */
+  UNIT_TEST_ASSERT(LINK_STATS_MAX_CELLS == TSCH_SCHEDULE_MAX_LINKS);
+
+  sf = tsch_schedule_add_slotframe(2, 101);
+  UNIT_TEST_ASSERT(sf != NULL);
+  for(i = 0; i < NUM_CELLS; i++) {
+    links[i] = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                      &parent, i, 0, 1);
+    UNIT_TEST_ASSERT(links[i] != NULL);
+  }
+  other_link = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                                      &other, NUM_CELLS, 0, 1);
+  UNIT_TEST_ASSERT(other_link != NULL);
+
+  /* Neighbors get their statistics with a first acknowledged packet */
+  link_stats_packet_sent(&parent, MAC_TX_OK, 1);
+  link_stats_packet_sent(&other, MAC_TX_OK, 1);
+
+  /* Two attempts per cell, one lost on the bad cells. The other neighbor
+   * loses all of its packets, which does not count for the parent */
+  for(i = 0; i < NUM_CELLS; i++) {
+    link_stats_cell_packet_sent(&parent, links[i]->handle,
+                                i < NUM_BAD_CELLS ? MAC_TX_NOACK : MAC_TX_OK);
+    link_stats_cell_packet_sent(&parent, links[i]->handle, MAC_TX_OK);
+    link_stats_cell_packet_sent(&other, other_link->handle, MAC_TX_NOACK);
+  }
+  /* Collisions are not counted */
+  link_stats_cell_packet_sent(&parent, links[0]->handle, MAC_TX_COLLISION);
+
+  /* No cell was replaced */
+  for(i = 0; i < NUM_CELLS; i++) {
+    c = link_stats_get_cell(&parent, links[i]->handle);
+    UNIT_TEST_ASSERT(c != NULL);
+    UNIT_TEST_ASSERT(c->tx_count == 2);
+    UNIT_TEST_ASSERT(c->ack_count == (i < NUM_BAD_CELLS ? 1 : 2));
+  }
+  UNIT_TEST_ASSERT(link_stats_get_cell(&other, links[0]->handle) == NULL);
+  c = link_stats_get_cell(&other, other_link->handle);
+  UNIT_TEST_ASSERT(c != NULL && c->tx_count == NUM_CELLS && c->ack_count == 0);
+
+  /* The ETX is set from the cells at the end of the next packet */
+  link_stats_packet_sent(&parent, MAC_TX_OK, 1);
+  tx_count = 2 * NUM_CELLS;
+  ack_count = 2 * NUM_CELLS - NUM_BAD_CELLS;
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&parent)->etx
+                   == tx_count * LINK_STATS_ETX_DIVISOR / ack_count);
+
+  /* Relocating the bad cells away takes them out of the ETX right away */
+  for(i = 0; i < NUM_BAD_CELLS; i++) {
+    uint16_t handle = links[i]->handle;
+    UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, links[i]));
+    UNIT_TEST_ASSERT(link_stats_get_cell(&parent, handle) == NULL);
+  }
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&parent)->etx == LINK_STATS_ETX_DIVISOR);
+
+  /* Removing a neighbor's statistics forgets its cells */
+  link_stats_reset();
+  UNIT_TEST_ASSERT(link_stats_get_cell(&parent, links[NUM_BAD_CELLS]->handle) == NULL);
+
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf));
+  tsch_queue_free_unused_neighbors();
+
+  UNIT_TEST_END();
+}
+#endif /* LINK_STATS_PER_CELL_ETX */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  printf("Compact links: %u\n", TSCH_SCHEDULE_COMPACT_LINKS);
+  printf("Per-cell ETX: %u\n", LINK_STATS_PER_CELL_ETX);
+
+  UNIT_TEST_RUN(link_nbr);
+  UNIT_TEST_RUN(reservations);
+
+  if(!UNIT_TEST_PASSED(link_nbr) || !UNIT_TEST_PASSED(reservations)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+#if LINK_STATS_PER_CELL_ETX
+  UNIT_TEST_RUN(cell_etx);
+
+  if(!UNIT_TEST_PASSED(cell_etx)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+#endif /* LINK_STATS_PER_CELL_ETX */
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
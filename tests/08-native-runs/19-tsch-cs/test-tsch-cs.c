@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests of tsch-cs: which channel replaces a bad one of the hopping
+ *         sequence, and whether a bad cell is to be relocated or blamed on
+ *         a channel. TSCH is not started, the test sets the statistics.
+ *         Runs as a single node of tools/native-sim, the only native radio
+ *         TSCH supports.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "services/tsch-cs/tsch-cs.h"
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define FREE     TSCH_STATS_BINARY_SCALING_FACTOR
+/* Above TSCH_CS_FREE_THRESHOLD */
+#define MOSTLY_FREE ((tsch_stat_t)(90ul * TSCH_STATS_BINARY_SCALING_FACTOR / 100))
+#define BUSY     0
+
+PROCESS(test_process, "TSCH CS test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const uint8_t default_sequence[] = TSCH_DEFAULT_HOPPING_SEQUENCE;
+/*---------------------------------------------------------------------------*/
+static void
+set_channel_free(uint8_t channel, tsch_stat_t value)
+{
+  tsch_stats.channel_free_ewma[tsch_stats_channel_to_index(channel)] = value;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_all_channels_free(tsch_stat_t value)
+{
+  int i;
+  for(i = 0; i < TSCH_STATS_NUM_CHANNELS; i++) {
+    tsch_stats.channel_free_ewma[i] = value;
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bad_cell, "Bad cells: relocate or blame a channel");
+UNIT_TEST(bad_cell)
+{
+  struct tsch_neighbor *n;
+  struct tsch_neighbor_stats *stats;
+  linkaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  linkaddr_copy(&addr, &linkaddr_null);
+  addr.u8[0] = 0x02;
+  n = tsch_queue_add_nbr(&addr);
+  UNIT_TEST_ASSERT(n != NULL);
+
+  /* Nothing to blame */
+  set_all_channels_free(FREE);
+  tsch_set_coordinator(1);
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(NULL, 1, 2) == TSCH_CS_RELOCATE_CELL);
+
+  /* A single noisy channel is to blame, where it can be replaced */
+  set_channel_free(tsch_hopping_sequence[1], BUSY);
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(NULL, 1, 2)
+                   == (TSCH_CS_WITH_CHANNEL_ADAPTATION ? TSCH_CS_REPLACE_CHANNEL
+                                                       : TSCH_CS_RELOCATE_CELL));
+  tsch_set_coordinator(0);
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(NULL, 1, 2) == TSCH_CS_RELOCATE_CELL);
+
+  /* When most of the sequence is noisy, no single channel is to blame */
+  tsch_set_coordinator(1);
+  set_channel_free(tsch_hopping_sequence[2], BUSY);
+  set_channel_free(tsch_hopping_sequence[3], BUSY);
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(NULL, 1, 2) == TSCH_CS_RELOCATE_CELL);
+
+  /* A channel bad for the transmissions to the time source only */
+  set_all_channels_free(FREE);
+  n->is_time_source = 1;
+  stats = tsch_stats_get_from_neighbor(n);
+  UNIT_TEST_ASSERT(stats != NULL);
+  stats->channel_stats[tsch_stats_channel_to_index(tsch_hopping_sequence[2])].p_tx_success =
+    TSCH_CS_TX_THRESHOLD - 1;
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(n, 1, 2)
+                   == (TSCH_CS_WITH_CHANNEL_ADAPTATION ? TSCH_CS_REPLACE_CHANNEL
+                                                       : TSCH_CS_RELOCATE_CELL));
+  /* Without the neighbor, there is nothing to blame */
+  UNIT_TEST_ASSERT(tsch_cs_bad_cell_action(NULL, 1, 2) == TSCH_CS_RELOCATE_CELL);
+
+  tsch_stats_reset_neighbor_stats();
+  n->is_time_source = 0;
+  tsch_set_coordinator(0);
+  tsch_queue_free_unused_neighbors();
+
+  /* The blacklist keeps the most recent cells */
+  tsch_cs_cell_blacklist_clear();
+  {
+    int i;
+    for(i = 0; i < TSCH_CS_CELL_BLACKLIST_SIZE + 1; i++) {
+      tsch_cs_cell_blacklist_add(i, i + 1);
+    }
+  }
+  UNIT_TEST_ASSERT(tsch_cs_cell_blacklist_count() == TSCH_CS_CELL_BLACKLIST_SIZE);
+  UNIT_TEST_ASSERT(!tsch_cs_cell_is_blacklisted(0, 1));
+  UNIT_TEST_ASSERT(tsch_cs_cell_is_blacklisted(1, 2));
+  UNIT_TEST_ASSERT(tsch_cs_cell_blacklist_get(0)->timeslot == 1);
+  UNIT_TEST_ASSERT(tsch_cs_cell_is_blacklisted(TSCH_CS_CELL_BLACKLIST_SIZE,
+                                               TSCH_CS_CELL_BLACKLIST_SIZE + 1));
+  tsch_cs_cell_blacklist_clear();
+
+  UNIT_TEST_END();
+}
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
+/*---------------------------------------------------------------------------*/
+/* The channel that replaced a busy one, to rule out for a while */
+static uint8_t removed_channel;
+/*---------------------------------------------------------------------------*/
+static bool
+is_in_sequence(uint8_t channel)
+{
+  int i;
+  for(i = 0; i < tsch_hopping_sequence_length.val; i++) {
+    if(tsch_hopping_sequence[i] == channel) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(replace_best, "Channel ranking: best channel first");
+UNIT_TEST(replace_best)
+{
+  uint8_t busy;
+  uint8_t best = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  tsch_set_coordinator(1);
+
+  /* The best channel outside of the sequence is the last one */
+  set_all_channels_free(MOSTLY_FREE);
+  for(i = TSCH_STATS_FIRST_CHANNEL; i < TSCH_STATS_FIRST_CHANNEL + TSCH_STATS_NUM_CHANNELS; i++) {
+    if(!is_in_sequence(i)) {
+      best = i;
+    }
+  }
+  set_channel_free(best, FREE);
+
+  /* A channel of the sequence becomes busy */
+  busy = tsch_hopping_sequence[1];
+  set_channel_free(busy, BUSY);
+  tsch_cs_channel_stats_updated(busy, MOSTLY_FREE);
+
+  UNIT_TEST_ASSERT(tsch_cs_process());
+  UNIT_TEST_ASSERT(tsch_hopping_sequence[1] == best);
+  UNIT_TEST_ASSERT(tsch_hopping_sequence[0] == default_sequence[0]);
+  UNIT_TEST_ASSERT(tsch_hopping_sequence[2] == default_sequence[2]);
+  UNIT_TEST_ASSERT(!is_in_sequence(busy));
+  removed_channel = busy;
+
+  /* Changes are rate-limited */
+  set_channel_free(tsch_hopping_sequence[2], BUSY);
+  tsch_cs_channel_stats_updated(tsch_hopping_sequence[2], MOSTLY_FREE);
+  UNIT_TEST_ASSERT(!tsch_cs_process());
+  UNIT_TEST_ASSERT(is_in_sequence(default_sequence[2]));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(replace_tie, "Channel ranking: ties and recent removals");
+UNIT_TEST(replace_tie)
+{
+  uint8_t busy;
+  uint8_t lowest = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Equal channels rank by number. The channel removed last is the best
+   * one now, but may not come back yet */
+  set_all_channels_free(MOSTLY_FREE);
+  set_channel_free(removed_channel, FREE);
+  for(i = TSCH_STATS_FIRST_CHANNEL + TSCH_STATS_NUM_CHANNELS - 1; i >= TSCH_STATS_FIRST_CHANNEL; i--) {
+    if(!is_in_sequence(i) && i != removed_channel) {
+      lowest = i;
+    }
+  }
+
+  busy = tsch_hopping_sequence[2];
+  set_channel_free(busy, BUSY);
+  tsch_cs_channel_stats_updated(busy, MOSTLY_FREE);
+
+  UNIT_TEST_ASSERT(tsch_cs_process());
+  UNIT_TEST_ASSERT(tsch_hopping_sequence[2] == lowest);
+  UNIT_TEST_ASSERT(!is_in_sequence(removed_channel));
+  UNIT_TEST_ASSERT(!is_in_sequence(busy));
+
+  tsch_set_coordinator(0);
+
+  UNIT_TEST_END();
+}
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static bool passed;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  printf("Channel adaptation: %u\n", TSCH_CS_WITH_CHANNEL_ADAPTATION);
+
+  /* The hopping sequence of a coordinator, TSCH being off */
+  memcpy(tsch_hopping_sequence, default_sequence, sizeof(default_sequence));
+  TSCH_ASN_DIVISOR_INIT(tsch_hopping_sequence_length, sizeof(default_sequence));
+  tsch_cs_adaptations_init();
+
+  /* tsch-cs ignores the statistics of the learning period */
+  etimer_set(&et, (TSCH_CS_LEARNING_PERIOD_SEC + 1) * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(bad_cell);
+  passed = UNIT_TEST_PASSED(bad_cell);
+
+#if TSCH_CS_WITH_CHANNEL_ADAPTATION
+  /* Clear the request left by the bad cells, with nothing to replace */
+  set_all_channels_free(FREE);
+  tsch_cs_process();
+
+  UNIT_TEST_RUN(replace_best);
+  passed = passed && UNIT_TEST_PASSED(replace_best);
+
+  /* Past the minimum interval between two changes */
+  etimer_set(&et, 61 * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(replace_tie);
+  passed = passed && UNIT_TEST_PASSED(replace_tie);
+#endif /* TSCH_CS_WITH_CHANNEL_ADAPTATION */
+
+  if(!passed) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -3,6 +3,8 @@
 source ../utils.sh
 
 BIN_PREFIX=${TEST_PREFIX:-test}
+# Command the test is run with, e.g. tools/native-sim for NATIVE_SIM builds
+RUNNER=${TEST_RUNNER:-}
 BASENAME=$(basename $1)
 
 cd ${1}
@@ -15,7 +17,7 @@ for TEST in ./build/native/${BIN_PREFIX}*.native; do
   register_logfile $RUNLOG
 
   # Start test in background
-  $TEST &> $RUNLOG &
+  $RUNNER $TEST &> $RUNLOG &
   register_last_bg_cmd
 
   wait_log_assert "start $TEST" "Run unit-test" $RUNLOG 30
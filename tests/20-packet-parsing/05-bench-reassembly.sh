@@ -0,0 +1,10 @@
+#!/bin/bash
+source ../utils.sh
+
+# Example code directory
+CODE_DIR=reassembly-benchmark
+CODE=reassembly-benchmark
+
+# The benchmark exits with a non-zero status if a datagram is lost or corrupted
+echo "Starting native node"
+$CMD_TIMEOUT -k 1s 60s "$CODE_DIR/build/native/$CODE.native"
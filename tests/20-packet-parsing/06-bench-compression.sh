@@ -0,0 +1,11 @@
+#!/bin/bash
+source ../utils.sh
+
+# Example code directory
+CODE_DIR=compression-benchmark
+CODE=compression-benchmark
+
+# The benchmark exits with a non-zero status if a packet is not
+# decompressed as it was sent
+echo "Starting native node"
+$CMD_TIMEOUT -k 1s 60s "$CODE_DIR/build/native/$CODE.native"
@@ -0,0 +1,11 @@
+#!/bin/bash
+source ../utils.sh
+
+# Example code directory
+CODE_DIR=fragment-forwarding
+CODE=fragment-forwarding
+
+# The test exits with a non-zero status if a datagram is not relayed
+# fragment by fragment, or not reassembled as it was sent
+echo "Starting native node"
+$CMD_TIMEOUT -k 1s 60s "$CODE_DIR/build/native/$CODE.native"
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Throughput benchmark of the 6LoWPAN header compression. Small
+ *         UDP packets of several kinds of flows are sent through the
+ *         6LoWPAN output to a MAC driver that drops them: link-local and
+ *         context-based addresses elided with the link-layer addresses,
+ *         routed packets to more flows than the address compression
+ *         cache holds, and link-local multicast. The compressed headers
+ *         of every flow are decompressed and compared with the original
+ *         packet. The process exits with a non-zero status on mismatch.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/linkaddr.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/sicslowpan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef COMPRESSION_BENCHMARK_CONF_ROUNDS
+#define COMPRESSION_BENCHMARK_ROUNDS COMPRESSION_BENCHMARK_CONF_ROUNDS
+#else
+#define COMPRESSION_BENCHMARK_ROUNDS 1000
+#endif
+
+/* Minimum duration of the measurement of a kind of flow, in rtimer ticks */
+#ifdef COMPRESSION_BENCHMARK_CONF_DURATION
+#define COMPRESSION_BENCHMARK_DURATION COMPRESSION_BENCHMARK_CONF_DURATION
+#else
+#define COMPRESSION_BENCHMARK_DURATION (RTIMER_SECOND / 4)
+#endif
+
+#define PAYLOAD_LEN       16
+#define PACKET_LEN        (UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN)
+#define MAX_FLOWS         16
+#define NEIGHBORS         4
+
+enum { FLOWS_LINK_LOCAL, FLOWS_CONTEXT, FLOWS_ROUTED, FLOWS_MANY_ROUTED,
+       FLOWS_MULTICAST, FLOWS_KINDS };
+static const char *const kind_names[] = {
+  "link-local", "context", "routed", "many-routed", "multicast"
+};
+
+struct flow {
+  uint8_t packet[PACKET_LEN];
+  linkaddr_t receiver;
+};
+
+static struct flow flows[MAX_FLOWS];
+static unsigned num_flows;
+static uint8_t frame[PACKETBUF_SIZE];
+static uint16_t frame_len;
+static int capture;
+static const struct flow *checked;
+static int decompressed_ok;
+/*---------------------------------------------------------------------------*/
+PROCESS(compression_benchmark_process, "Compression benchmark process");
+AUTOSTART_PROCESSES(&compression_benchmark_process);
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(mac_callback_t sent, void *ptr)
+{
+  if(capture) {
+    frame_len = packetbuf_copyto(frame);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+max_payload(void)
+{
+  return 127 - 2 - 23;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver compression_benchmark_mac = {
+  "compression-benchmark",
+  init,
+  send,
+  input,
+  on,
+  off,
+  max_payload,
+};
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  decompressed_ok = uip_len == PACKET_LEN &&
+    memcmp(uip_buf, checked->packet, PACKET_LEN) == 0;
+  /* Consumed here, keep the IP stack out of the benchmark */
+  uip_len = 0;
+}
+NETSTACK_SNIFFER(sniffer, input_callback, NULL);
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_lladdr(uip_lladdr_t *lladdr, unsigned n)
+{
+  memset(lladdr, 0, sizeof(*lladdr));
+  lladdr->addr[0] = 0x02;
+  lladdr->addr[sizeof(*lladdr) - 1] = n + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_flow(struct flow *f, const uip_ipaddr_t *src, const uip_ipaddr_t *dst,
+          unsigned neighbor)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)f->packet;
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&f->packet[UIP_IPH_LEN];
+  uip_lladdr_t lladdr;
+  unsigned i;
+
+  memset(f->packet, 0, sizeof(f->packet));
+  ip->vtc = 0x60;
+  ip->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  ip->proto = UIP_PROTO_UDP;
+  ip->ttl = 64;
+  uip_ipaddr_copy(&ip->srcipaddr, src);
+  uip_ipaddr_copy(&ip->destipaddr, dst);
+  udp->srcport = UIP_HTONS(5678);
+  udp->destport = UIP_HTONS(8765);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  udp->udpchksum = UIP_HTONS(0x1234);
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    f->packet[UIP_IPH_LEN + UIP_UDPH_LEN + i] = i;
+  }
+
+  if(uip_is_addr_mcast(dst)) {
+    linkaddr_copy(&f->receiver, &linkaddr_null);
+  } else {
+    neighbor_lladdr(&lladdr, neighbor);
+    memcpy(&f->receiver, &lladdr, sizeof(f->receiver));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_flows(int kind)
+{
+  uip_ipaddr_t src;
+  uip_ipaddr_t dst;
+  uip_lladdr_t lladdr;
+  unsigned i;
+
+  num_flows = kind == FLOWS_MANY_ROUTED ? MAX_FLOWS :
+    kind == FLOWS_ROUTED ? NEIGHBORS : 1;
+  for(i = 0; i < num_flows; i++) {
+    switch(kind) {
+    case FLOWS_LINK_LOCAL:
+      uip_ip6addr(&src, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+      uip_ip6addr(&dst, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+      break;
+    case FLOWS_MULTICAST:
+      uip_ip6addr(&src, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+      uip_ip6addr(&dst, 0xff02, 0, 0, 0, 0, 0, 0, 0x001a);
+      break;
+    default:
+      uip_ip6addr(&src, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+      uip_ip6addr(&dst, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+      break;
+    }
+    uip_ds6_set_addr_iid(&src, &uip_lladdr);
+    /* Routed flows are to nodes beyond the neighbors */
+    neighbor_lladdr(&lladdr, kind == FLOWS_ROUTED ||
+                    kind == FLOWS_MANY_ROUTED ? NEIGHBORS + i : i);
+    uip_ds6_set_addr_iid(&dst, &lladdr);
+    if(kind == FLOWS_MULTICAST) {
+      uip_ip6addr(&dst, 0xff02, 0, 0, 0, 0, 0, 0, 0x001a);
+    }
+    init_flow(&flows[i], &src, &dst, i % NEIGHBORS);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_flow(const struct flow *f)
+{
+  memcpy(uip_buf, f->packet, PACKET_LEN);
+  uip_len = PACKET_LEN;
+  sicslowpan_driver.output(&f->receiver);
+}
+/*---------------------------------------------------------------------------*/
+/* Compresses the packet of a flow and decompresses it. Returns the
+ * length of the frame if the result is the original packet, else 0 */
+static int
+check_flow(const struct flow *f)
+{
+  capture = 1;
+  frame_len = 0;
+  send_flow(f);
+  capture = 0;
+  if(frame_len == 0) {
+    return 0;
+  }
+
+  checked = f;
+  decompressed_ok = 0;
+  packetbuf_copyfrom(frame, frame_len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &f->receiver);
+  sicslowpan_driver.input();
+  return decompressed_ok ? frame_len : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(compression_benchmark_process, ev, data)
+{
+  static int failed;
+  rtimer_clock_t start;
+  unsigned long elapsed;
+  unsigned long packets;
+  unsigned long ns;
+  unsigned i;
+  int len;
+  int kind;
+
+  PROCESS_BEGIN();
+
+  /* Not the network layer of the native platform, set its contexts */
+  sicslowpan_driver.init();
+  netstack_sniffer_add(&sniffer);
+
+  printf("Compression benchmark: %u-byte UDP packets, %lu rtimer ticks/s\n",
+         PACKET_LEN, (unsigned long)RTIMER_SECOND);
+
+  failed = 0;
+  for(kind = 0; kind < FLOWS_KINDS; kind++) {
+    init_flows(kind);
+
+    packets = 0;
+    start = RTIMER_NOW();
+    do {
+      for(i = 0; i < COMPRESSION_BENCHMARK_ROUNDS; i++) {
+        send_flow(&flows[i % num_flows]);
+      }
+      packets += COMPRESSION_BENCHMARK_ROUNDS;
+      elapsed = RTIMER_NOW() - start;
+    } while(elapsed < COMPRESSION_BENCHMARK_DURATION);
+
+    ns = (unsigned long)((unsigned long long)elapsed * 1000000000ull
+                         / RTIMER_SECOND / packets);
+    /* Check every flow, the cache is hot after the measurement */
+    len = 0;
+    for(i = 0; i < num_flows; i++) {
+      len = check_flow(&flows[i]);
+      if(len == 0) {
+        break;
+      }
+    }
+    /* The same addresses through another neighbor must not be
+     * compressed as before */
+    if(len != 0 && !linkaddr_cmp(&flows[0].receiver, &linkaddr_null)) {
+      flows[0].receiver.u8[LINKADDR_SIZE - 1] ^= 0x80;
+      if(check_flow(&flows[0]) == 0) {
+        len = 0;
+        i = 0;
+      }
+    }
+
+    printf("%-11s %2u flows: %8lu packets in %5lu ticks, "
+           "%lu ns per packet, %lu packets/s",
+           kind_names[kind], num_flows, packets, elapsed, ns,
+           ns ? 1000000000ul / ns : 0);
+    if(len == 0) {
+      printf(", FAILED: flow %u\n", i);
+      failed = 1;
+    } else {
+      printf(", %d-byte frames\n", len);
+    }
+  }
+
+  netstack_sniffer_remove(&sniffer);
+  printf("Compression benchmark %s\n", failed ? "FAILED" : "OK");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,7 @@
+/* Sink for the compressed packets, see compression-benchmark.c */
+#define NETSTACK_CONF_MAC                          compression_benchmark_mac
+
+/* Exercise the address compression cache unless set otherwise */
+#ifndef SICSLOWPAN_CONF_IPHC_CACHE_SIZE
+#define SICSLOWPAN_CONF_IPHC_CACHE_SIZE            4
+#endif
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of 6LoWPAN fragment forwarding. The node plays in turn a
+ *         source, a relay and a destination on a line: the fragments of
+ *         datagrams sent by the sources are fed to the relay, and the
+ *         fragments it sends are fed to the destination, where the
+ *         datagrams must be reassembled as sent, hop limit aside. The
+ *         relay must send fragments as they arrive, without reassembling,
+ *         and must reassemble the datagrams for itself. The process exits
+ *         with a non-zero status on failure.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/linkaddr.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/sicslowpan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define PAYLOAD_LEN       400
+#define DATAGRAM_LEN      (UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN)
+#define MAX_FRAMES        32
+#define MAX_DATAGRAMS     2
+
+/* Nodes of the line, by the last byte of their link-layer address */
+enum { NODE_SOURCE1 = 1, NODE_SOURCE2, NODE_RELAY, NODE_DESTINATION };
+
+struct frame {
+  linkaddr_t receiver;
+  uint16_t len;
+  uint8_t data[PACKETBUF_SIZE];
+};
+
+struct frames {
+  struct frame frame[MAX_FRAMES];
+  unsigned count;
+};
+
+/* Fragments sent by the node in its current role */
+static struct frames *sent_frames;
+static struct frames source_frames[MAX_DATAGRAMS];
+static struct frames relay_frames;
+static struct frames discarded;
+
+static uint8_t datagrams[MAX_DATAGRAMS][DATAGRAM_LEN];
+static unsigned num_datagrams;
+/* Hop limit decrement expected at reassembly */
+static unsigned forwarded_hops;
+static unsigned reassembled;
+static unsigned corrupted;
+/*---------------------------------------------------------------------------*/
+PROCESS(fragment_forwarding_process, "Fragment forwarding test process");
+AUTOSTART_PROCESSES(&fragment_forwarding_process);
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(mac_callback_t sent, void *ptr)
+{
+  struct frames *f = sent_frames != NULL ? sent_frames : &discarded;
+
+  if(f->count < MAX_FRAMES) {
+    linkaddr_copy(&f->frame[f->count].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    f->frame[f->count].len = packetbuf_copyto(f->frame[f->count].data);
+    f->count++;
+  }
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+max_payload(void)
+{
+  return 127 - 2 - 23;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver fragment_forwarding_mac = {
+  "fragment-forwarding",
+  init,
+  send,
+  input,
+  on,
+  off,
+  max_payload,
+};
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  unsigned d;
+
+  for(d = 0; d < num_datagrams; d++) {
+    if(uip_len == DATAGRAM_LEN &&
+       memcmp(uip_buf, datagrams[d], 7) == 0 &&
+       UIP_IP_BUF->ttl == datagrams[d][7] - forwarded_hops &&
+       memcmp(uip_buf + 8, datagrams[d] + 8, DATAGRAM_LEN - 8) == 0) {
+      reassembled++;
+      break;
+    }
+  }
+  if(d == num_datagrams) {
+    corrupted++;
+  }
+  /* Consumed here, keep the IP stack out of the test */
+  uip_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_callback(int status)
+{
+}
+/*---------------------------------------------------------------------------*/
+NETSTACK_SNIFFER(sniffer, input_callback, output_callback);
+/*---------------------------------------------------------------------------*/
+static void
+node_lladdr(linkaddr_t *lladdr, unsigned n)
+{
+  memset(lladdr, 0, sizeof(*lladdr));
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 1] = n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_ipaddr(uip_ipaddr_t *ipaddr, unsigned n)
+{
+  linkaddr_t lladdr;
+
+  node_lladdr(&lladdr, n);
+  uip_ip6addr(ipaddr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(ipaddr, (uip_lladdr_t *)&lladdr);
+}
+/*---------------------------------------------------------------------------*/
+/* Takes the role of node n, with its link-layer and global addresses */
+static void
+set_node(unsigned n)
+{
+  static uip_ds6_addr_t *node_addr;
+  uip_ipaddr_t ipaddr;
+  linkaddr_t lladdr;
+
+  node_lladdr(&lladdr, n);
+  linkaddr_set_node_addr(&lladdr);
+  memcpy(&uip_lladdr, &lladdr, sizeof(uip_lladdr));
+
+  if(node_addr != NULL) {
+    uip_ds6_addr_rm(node_addr);
+  }
+  node_ipaddr(&ipaddr, n);
+  node_addr = uip_ds6_addr_add(&ipaddr, 0, ADDR_MANUAL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_datagram(unsigned d, unsigned from, unsigned to)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)datagrams[d];
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&datagrams[d][UIP_IPH_LEN];
+  unsigned i;
+
+  memset(datagrams[d], 0, DATAGRAM_LEN);
+  ip->vtc = 0x60;
+  ip->len[0] = (DATAGRAM_LEN - UIP_IPH_LEN) >> 8;
+  ip->len[1] = (DATAGRAM_LEN - UIP_IPH_LEN) & 0xff;
+  ip->proto = UIP_PROTO_UDP;
+  ip->ttl = 64;
+  node_ipaddr(&ip->srcipaddr, from);
+  node_ipaddr(&ip->destipaddr, to);
+  udp->srcport = UIP_HTONS(5678);
+  udp->destport = UIP_HTONS(8765);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  udp->udpchksum = UIP_HTONS(0x1234);
+  for(i = UIP_IPH_LEN + UIP_UDPH_LEN; i < DATAGRAM_LEN; i++) {
+    datagrams[d][i] = d * 7 + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Fragments datagram d at its source, for the relay */
+static void
+send_from_source(unsigned d, unsigned from)
+{
+  linkaddr_t relay;
+
+  set_node(from);
+  node_lladdr(&relay, NODE_RELAY);
+  source_frames[d].count = 0;
+  sent_frames = &source_frames[d];
+  memcpy(uip_buf, datagrams[d], DATAGRAM_LEN);
+  uip_len = DATAGRAM_LEN;
+  sicslowpan_driver.output(&relay);
+  sent_frames = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive(const struct frame *f, unsigned from, unsigned to)
+{
+  linkaddr_t sender;
+  linkaddr_t receiver;
+
+  set_node(to);
+  node_lladdr(&sender, from);
+  node_lladdr(&receiver, to);
+  packetbuf_copyfrom(f->data, f->len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receiver);
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Feeds the fragments of the sources to the relay, interleaved, and
+ * returns the number of fragments the relay sent after the first one */
+static unsigned
+relay(const unsigned *from)
+{
+  unsigned after_first = 0;
+  unsigned d;
+  unsigned i;
+
+  relay_frames.count = 0;
+  sent_frames = &relay_frames;
+  for(i = 0; i < MAX_FRAMES; i++) {
+    for(d = 0; d < num_datagrams; d++) {
+      if(i < source_frames[d].count) {
+        receive(&source_frames[d].frame[i], from[d], NODE_RELAY);
+      }
+    }
+    if(i == 0) {
+      after_first = relay_frames.count;
+    }
+  }
+  sent_frames = NULL;
+  return after_first;
+}
+/*---------------------------------------------------------------------------*/
+/* Feeds the fragments sent by the relay to the destination */
+static void
+deliver(void)
+{
+  linkaddr_t destination;
+  unsigned i;
+
+  node_lladdr(&destination, NODE_DESTINATION);
+  for(i = 0; i < relay_frames.count; i++) {
+    if(!linkaddr_cmp(&relay_frames.frame[i].receiver, &destination)) {
+      corrupted++;
+      continue;
+    }
+    receive(&relay_frames.frame[i], NODE_RELAY, NODE_DESTINATION);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_neighbor(unsigned n)
+{
+  uip_ipaddr_t ipaddr;
+  linkaddr_t lladdr;
+
+  node_lladdr(&lladdr, n);
+  node_ipaddr(&ipaddr, n);
+  uip_ds6_nbr_add(&ipaddr, (uip_lladdr_t *)&lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_create_linklocal_prefix(&ipaddr);
+  uip_ds6_nbr_add(&ipaddr, (uip_lladdr_t *)&lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(const char *name, unsigned expected_reassembled, int forwarded)
+{
+  int ok = reassembled == expected_reassembled && corrupted == 0 &&
+    (forwarded ? relay_frames.count > 0 : relay_frames.count == 0);
+  unsigned received = 0;
+  unsigned d;
+
+  for(d = 0; d < num_datagrams; d++) {
+    received += source_frames[d].count;
+  }
+  printf("%-24s: %u fragments in, %u out, %u reassembled, %u corrupted: %s\n",
+         name, received, relay_frames.count, reassembled, corrupted,
+         ok ? "OK" : "FAILED");
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(fragment_forwarding_process, ev, data)
+{
+  static const unsigned one_source[] = { NODE_SOURCE1 };
+  static const unsigned two_sources[] = { NODE_SOURCE1, NODE_SOURCE2 };
+  static int failed;
+  uip_ipaddr_t ipaddr;
+  unsigned after_first;
+
+  PROCESS_BEGIN();
+
+  netstack_sniffer_add(&sniffer);
+
+  /* The relay reaches the destination directly */
+  add_neighbor(NODE_DESTINATION);
+  node_ipaddr(&ipaddr, NODE_DESTINATION);
+  uip_create_linklocal_prefix(&ipaddr);
+  uip_ds6_defrt_add(&ipaddr, 0);
+
+  failed = 0;
+
+  /* One datagram, relayed fragment by fragment */
+  num_datagrams = 1;
+  forwarded_hops = 1;
+  init_datagram(0, NODE_SOURCE1, NODE_DESTINATION);
+  send_from_source(0, NODE_SOURCE1);
+  reassembled = corrupted = 0;
+  after_first = relay(one_source);
+  if(reassembled != 0 || after_first == 0) {
+    printf("The relay did not forward the first fragment on arrival\n");
+    failed = 1;
+  }
+  deliver();
+  failed |= !check("forwarded", 1, 1);
+
+  /* Two datagrams from different sources, fragments interleaved */
+  num_datagrams = 2;
+  init_datagram(0, NODE_SOURCE1, NODE_DESTINATION);
+  init_datagram(1, NODE_SOURCE2, NODE_DESTINATION);
+  send_from_source(0, NODE_SOURCE1);
+  send_from_source(1, NODE_SOURCE2);
+  reassembled = corrupted = 0;
+  relay(two_sources);
+  if(reassembled != 0) {
+    failed = 1;
+  }
+  deliver();
+  failed |= !check("forwarded, interleaved", 2, 1);
+
+  /* A datagram for the relay is reassembled there, not forwarded */
+  num_datagrams = 1;
+  forwarded_hops = 0;
+  init_datagram(0, NODE_SOURCE1, NODE_RELAY);
+  send_from_source(0, NODE_SOURCE1);
+  reassembled = corrupted = 0;
+  relay(one_source);
+  failed |= !check("for the relay", 1, 0);
+
+  netstack_sniffer_remove(&sniffer);
+  printf("Fragment forwarding test %s\n", failed ? "FAILED" : "OK");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+/* Relay the fragments of datagrams for other nodes */
+#define SICSLOWPAN_CONF_FRAG_FORWARDING            1
+
+/* Sink for the forwarded fragments, see fragment-forwarding.c */
+#define NETSTACK_CONF_MAC                          fragment_forwarding_mac
+
+/* Next hops are set up by hand, no address resolution */
+#define UIP_CONF_ND6_SEND_NS                       0
+
+/* Instead of the tun interface, for the relay to send fragments */
+#define NETSTACK_CONF_NETWORK                      sicslowpan_driver
@@ -0,0 +1,3 @@
+/* Enough reassembly contexts and buffers for the largest round */
+#define SICSLOWPAN_CONF_REASS_CONTEXTS             16
+#define SICSLOWPAN_CONF_FRAGMENT_BUFFERS           (16 * 15)
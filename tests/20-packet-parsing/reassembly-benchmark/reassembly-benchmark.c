@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Throughput benchmark of the 6LoWPAN reassembly. Rounds of
+ *         concurrent 1280-byte datagrams from distinct senders are
+ *         fragmented and fed to the 6LoWPAN input with their fragments
+ *         interleaved: in order, with duplicates, and in reverse order.
+ *         Every reassembled datagram is compared with the original. The
+ *         process exits with a non-zero status if a datagram is lost or
+ *         corrupted.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/linkaddr.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/sicslowpan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* Minimum duration of the measurement of a configuration, in rtimer ticks */
+#ifdef REASS_BENCHMARK_CONF_DURATION
+#define REASS_BENCHMARK_DURATION REASS_BENCHMARK_CONF_DURATION
+#else
+#define REASS_BENCHMARK_DURATION (RTIMER_SECOND / 4)
+#endif
+
+#define DATAGRAM_SIZE     1280
+/* IPv6 payload in the first fragment and in the subsequent ones */
+#define FRAG1_PAYLOAD     64
+#define FRAGN_PAYLOAD     96
+#define FIRST_FRAG_SIZE   (UIP_IPH_LEN + FRAG1_PAYLOAD)
+#define NUM_FRAGS         (1 + (DATAGRAM_SIZE - FIRST_FRAG_SIZE \
+                                + FRAGN_PAYLOAD - 1) / FRAGN_PAYLOAD)
+#define MAX_CONCURRENT    16
+
+enum { ORDER_IN_ORDER, ORDER_DUPLICATES, ORDER_REVERSED };
+static const char *const order_names[] = {
+  "in-order", "duplicates", "reversed"
+};
+static const unsigned concurrency[] = { 1, 4, MAX_CONCURRENT };
+
+static uint8_t datagrams[MAX_CONCURRENT][DATAGRAM_SIZE];
+static uint8_t frame[PACKETBUF_SIZE];
+static uint16_t tag;
+static unsigned long received;
+static unsigned long corrupted;
+/*---------------------------------------------------------------------------*/
+PROCESS(reassembly_benchmark_process, "Reassembly benchmark process");
+AUTOSTART_PROCESSES(&reassembly_benchmark_process);
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  unsigned d = UIP_IP_BUF->srcipaddr.u8[15];
+
+  if(uip_len != DATAGRAM_SIZE || d >= MAX_CONCURRENT ||
+     memcmp(uip_buf, datagrams[d], DATAGRAM_SIZE) != 0) {
+    corrupted++;
+  } else {
+    received++;
+  }
+  /* Consumed here, keep the IP stack out of the measurement */
+  uip_len = 0;
+}
+NETSTACK_SNIFFER(sniffer, input_callback, NULL);
+/*---------------------------------------------------------------------------*/
+static void
+init_datagrams(void)
+{
+  unsigned d;
+  unsigned i;
+
+  for(d = 0; d < MAX_CONCURRENT; d++) {
+    memset(datagrams[d], 0, UIP_IPH_LEN);
+    datagrams[d][0] = 0x60;
+    datagrams[d][4] = (DATAGRAM_SIZE - UIP_IPH_LEN) >> 8;
+    datagrams[d][5] = (DATAGRAM_SIZE - UIP_IPH_LEN) & 0xff;
+    datagrams[d][6] = UIP_PROTO_NONE;
+    datagrams[d][7] = 64;
+    /* Source fe80::<d>, destination fe80::ff */
+    datagrams[d][8] = 0xfe;
+    datagrams[d][9] = 0x80;
+    datagrams[d][23] = d;
+    datagrams[d][24] = 0xfe;
+    datagrams[d][25] = 0x80;
+    datagrams[d][39] = 0xff;
+    for(i = UIP_IPH_LEN; i < DATAGRAM_SIZE; i++) {
+      datagrams[d][i] = d * 7 + i;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Feeds fragment f of datagram d, sent with the given tag, to 6LoWPAN */
+static void
+send_fragment(unsigned d, unsigned f, uint16_t t)
+{
+  linkaddr_t sender;
+  unsigned offset;
+  unsigned len;
+  unsigned hdr_len;
+
+  if(f == 0) {
+    frame[0] = SICSLOWPAN_DISPATCH_FRAG1 | (DATAGRAM_SIZE >> 8);
+    frame[4] = SICSLOWPAN_DISPATCH_IPV6;
+    hdr_len = SICSLOWPAN_FRAG1_HDR_LEN + 1;
+    offset = 0;
+    len = FIRST_FRAG_SIZE;
+  } else {
+    frame[0] = SICSLOWPAN_DISPATCH_FRAGN | (DATAGRAM_SIZE >> 8);
+    offset = FIRST_FRAG_SIZE + (f - 1) * FRAGN_PAYLOAD;
+    frame[4] = offset >> 3;
+    hdr_len = SICSLOWPAN_FRAGN_HDR_LEN;
+    len = MIN(FRAGN_PAYLOAD, DATAGRAM_SIZE - offset);
+  }
+  frame[1] = DATAGRAM_SIZE & 0xff;
+  frame[2] = t >> 8;
+  frame[3] = t & 0xff;
+  memcpy(&frame[hdr_len], &datagrams[d][offset], len);
+
+  packetbuf_copyfrom(frame, hdr_len + len);
+  memset(&sender, 0, sizeof(sender));
+  sender.u8[LINKADDR_SIZE - 1] = d;
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Sends one round of k concurrent datagrams, fragments interleaved */
+static void
+send_round(unsigned k, int order)
+{
+  unsigned d;
+  unsigned i;
+  unsigned f;
+
+  for(i = 0; i < NUM_FRAGS; i++) {
+    f = order == ORDER_REVERSED ? NUM_FRAGS - 1 - i : i;
+    for(d = 0; d < k; d++) {
+      send_fragment(d, f, tag + d);
+      /* A copy of the completing fragment would open a new context */
+      if(order == ORDER_DUPLICATES && i < NUM_FRAGS - 1) {
+        send_fragment(d, f, tag + d);
+      }
+    }
+  }
+  tag += k;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(reassembly_benchmark_process, ev, data)
+{
+  static int failed;
+  rtimer_clock_t start;
+  unsigned long elapsed;
+  unsigned long rounds;
+  unsigned long ns;
+  unsigned k;
+  int order;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  init_datagrams();
+  netstack_sniffer_add(&sniffer);
+
+  printf("Reassembly benchmark: %u-byte datagrams in %u fragments, "
+         "%lu rtimer ticks/s\n", DATAGRAM_SIZE, (unsigned)NUM_FRAGS,
+         (unsigned long)RTIMER_SECOND);
+
+  failed = 0;
+  for(order = ORDER_IN_ORDER; order <= ORDER_REVERSED; order++) {
+    for(i = 0; i < sizeof(concurrency) / sizeof(concurrency[0]); i++) {
+      k = concurrency[i];
+      received = 0;
+      corrupted = 0;
+      rounds = 0;
+      start = RTIMER_NOW();
+      do {
+        send_round(k, order);
+        rounds++;
+        elapsed = RTIMER_NOW() - start;
+      } while(elapsed < REASS_BENCHMARK_DURATION);
+
+      ns = (unsigned long)((unsigned long long)elapsed * 1000000000ull
+                           / RTIMER_SECOND / (rounds * k));
+      printf("%-10s %2u concurrent: %7lu datagrams in %5lu ticks, "
+             "%lu ns per datagram, %lu datagrams/s",
+             order_names[order], k, rounds * k, elapsed, ns,
+             ns ? 1000000000ul / ns : 0);
+      if(received != rounds * k || corrupted != 0) {
+        printf(", FAILED: %lu received, %lu corrupted\n",
+               received, corrupted);
+        failed = 1;
+      } else {
+        printf("\n");
+      }
+    }
+  }
+
+  netstack_sniffer_remove(&sniffer);
+  printf("Reassembly benchmark %s\n", failed ? "FAILED" : "OK");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+
+# Rebuilds the text of the deferred, binary log records of
+# os/sys/log-deferred.h, reading the format strings from the firmware.
+#
+# Input is a Cooja or native-sim log ("<time>\tID:<id>\t<line>") or raw
+# serial output of a single node. Records ("#L" lines) are replaced by
+# the text they stand for, other lines are passed through.
+
+import argparse
+import ipaddress
+import re
+import struct
+import sys
+
+PREFIX = "#L"
+ANCHOR = "log_deferred_anchor"
+
+SYNC, FORMAT, LOST, LLADDR, IP6ADDR, BYTES, BYTES_SPACED, STRING = range(8)
+
+LOG_LINE = re.compile(r"^(?P<time>\d+)\s+ID:(?P<id>\d+)\s+(?P<msg>.*)$")
+CONVERSION = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                        r"(?P<length>hh|h|ll|l|z|t|j|L)?(?P<conv>[diouxXcspfFeEgGaAn%])")
+
+###########################################
+# Firmware
+
+class Elf:
+    """The loadable segments and symbols of an ELF file"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit("{} is not an ELF file".format(path))
+        is64 = self.data[4] == 2
+        self.endian = "<" if self.data[5] == 1 else ">"
+        if is64:
+            hdr = struct.unpack_from(self.endian + "16sHHIQQQIHHHHHH", self.data)
+        else:
+            hdr = struct.unpack_from(self.endian + "16sHHIIIIIHHHHHH", self.data)
+        phoff, shoff, phentsize, phnum, shentsize, shnum = \
+            hdr[5], hdr[6], hdr[9], hdr[10], hdr[11], hdr[12]
+
+        # (vaddr, offset, size) of the loadable segments
+        self.segments = []
+        for i in range(phnum):
+            off = phoff + i * phentsize
+            if is64:
+                ptype, _, poffset, vaddr, _, filesz, _, _ = \
+                    struct.unpack_from(self.endian + "IIQQQQQQ", self.data, off)
+            else:
+                ptype, poffset, vaddr, _, filesz, _, _, _ = \
+                    struct.unpack_from(self.endian + "IIIIIIII", self.data, off)
+            if ptype == 1:
+                self.segments.append((vaddr, poffset, filesz))
+
+        sections = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if is64:
+                s = struct.unpack_from(self.endian + "IIQQQQIIQQ", self.data, off)
+            else:
+                s = struct.unpack_from(self.endian + "IIIIIIIIII", self.data, off)
+            # type, offset, size, link, entsize
+            sections.append((s[1], s[4], s[5], s[6], s[9]))
+
+        self.anchor = None
+        for stype, offset, size, link, entsize in sections:
+            if stype != 2 or entsize == 0:
+                continue
+            strtab = sections[link][1]
+            for off in range(offset, offset + size, entsize):
+                if is64:
+                    name, _, _, _, value, _ = struct.unpack_from(self.endian + "IBBHQQ", self.data, off)
+                else:
+                    name, value, _, _, _, _ = struct.unpack_from(self.endian + "IIIBBH", self.data, off)
+                if self.cstring(strtab + name) == ANCHOR:
+                    self.anchor = value
+        if self.anchor is None:
+            sys.exit("{}: no symbol {}, not built with LOG_CONF_DEFERRED?".format(path, ANCHOR))
+        self.strings = {}
+
+    def cstring(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("utf-8", "replace")
+
+    def string_at(self, vaddr):
+        if vaddr not in self.strings:
+            self.strings[vaddr] = None
+            for start, offset, size in self.segments:
+                if start <= vaddr < start + size:
+                    self.strings[vaddr] = self.cstring(offset + vaddr - start)
+                    break
+        return self.strings[vaddr]
+
+###########################################
+# Records
+
+class Node:
+    """Decoding state of one node: its firmware, sizes and current line"""
+
+    def __init__(self, elf):
+        self.elf = elf
+        self.sizes = None
+        self.bias = 0
+        self.text = ""
+        self.log_time = None
+
+class Reader:
+    def __init__(self, rec, node):
+        self.rec = rec
+        self.pos = 0
+        self.node = node
+
+    def take(self, n):
+        if self.pos + n > len(self.rec):
+            raise ValueError("truncated record")
+        b = self.rec[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def int(self, size, signed=False):
+        order = "little" if self.node.sizes["little"] else "big"
+        return int.from_bytes(self.take(size), order, signed=signed)
+
+    def double(self):
+        return struct.unpack(("<" if self.node.sizes["little"] else ">") + "d", self.take(8))[0]
+
+    def string(self):
+        end = self.rec.index(b"\0", self.pos)
+        s = self.rec[self.pos:end].decode("utf-8", "replace")
+        self.pos = end + 1
+        return s
+
+def format_record(r, fmt):
+    """Formats the arguments of a record as printf would"""
+    sizes = r.node.sizes
+    out = []
+    last = 0
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        conv, length = m.group("conv"), m.group("length")
+        if conv == "%":
+            out.append("%")
+            continue
+        width = m.group("width") or ""
+        if width == "*":
+            width = str(r.int(sizes["int"], True))
+        prec = m.group("prec")
+        if prec == "*":
+            prec = str(r.int(sizes["int"], True))
+        spec = "%" + m.group("flags") + width + ("." + prec if prec is not None else "")
+        if conv in "diouxX":
+            size = {"ll": 8, "j": 8, "l": sizes["long"], "z": sizes["size_t"],
+                    "t": sizes["size_t"]}.get(length, sizes["int"])
+            value = r.int(size, conv in "di")
+            if length in ("h", "hh"):
+                bits = 16 if length == "h" else 8
+                value &= (1 << bits) - 1
+                if conv in "di" and value >= 1 << (bits - 1):
+                    value -= 1 << bits
+            out.append((spec + ("d" if conv in "diu" else conv)) % value)
+        elif conv == "c":
+            out.append((spec + "c") % (r.int(sizes["int"]) & 0xff))
+        elif conv == "p":
+            out.append((spec + "s") % hex(r.int(sizes["ptr"])))
+        elif conv == "s":
+            out.append((spec + "s") % r.string())
+        elif conv in "fFeEgGaA":
+            value = r.double()
+            out.append((spec + ("g" if conv in "aA" else conv)) % value)
+    out.append(fmt[last:])
+    return "".join(out)
+
+def decode(rec, node):
+    """Returns the text of a record, or None"""
+    kind = rec[0]
+    if kind == SYNC:
+        node.sizes = {"int": rec[1], "long": rec[2], "size_t": rec[3],
+                      "ptr": rec[4], "little": rec[5] == 1}
+        r = Reader(rec[6:], node)
+        node.bias = r.int(node.sizes["ptr"]) - node.elf.anchor
+        return None
+    if node.sizes is None:
+        # Nothing can be decoded before the first sync record
+        return None
+    r = Reader(rec[1:], node)
+    if kind == FORMAT:
+        addr = r.int(node.sizes["ptr"])
+        fmt = node.elf.string_at(addr - node.bias)
+        if fmt is None:
+            return "[log: unknown format string at {:#x}]\n".format(addr)
+        return format_record(r, fmt)
+    if kind == LOST:
+        return "[log: {} records lost]\n".format(r.int(2))
+    data = rec[1:]
+    if kind == LLADDR:
+        return ".".join(data[i:i + 2].hex() for i in range(0, len(data), 2))
+    if kind == IP6ADDR:
+        return str(ipaddress.IPv6Address(bytes(data)))
+    if kind == BYTES:
+        return data.hex()
+    if kind == BYTES_SPACED:
+        return " ".join("{:02x}".format(b) for b in data)
+    if kind == STRING:
+        return data.decode("utf-8", "replace")
+    return None
+
+###########################################
+# Log
+
+class Decoder:
+    """Turns log lines into text lines"""
+
+    def __init__(self, elfs):
+        # Node ID (None for all) -> ELF
+        self.elfs = elfs
+        self.nodes = {}
+
+    def node(self, node_id):
+        if node_id not in self.nodes:
+            elf = self.elfs.get(node_id, self.elfs.get(None))
+            self.nodes[node_id] = Node(elf) if elf else None
+        return self.nodes[node_id]
+
+    def feed(self, line, node_id=None):
+        """Returns the complete lines of text, without newline, as a list"""
+        log_time = None
+        prefix = ""
+        m = LOG_LINE.match(line)
+        if m:
+            log_time = m.group("time")
+            node_id = int(m.group("id"))
+            prefix = "{}\tID:{}\t".format(log_time, node_id)
+            line = m.group("msg")
+        pos = line.find(PREFIX)
+        node = self.node(node_id)
+        if pos < 0 or node is None:
+            return [prefix + line]
+        try:
+            text = decode(bytes.fromhex(line[pos + len(PREFIX):].strip()), node)
+        except ValueError:
+            return [prefix + line]
+        if not text:
+            return []
+        if not node.text:
+            node.log_time = prefix
+        node.text += text
+        lines = node.text.split("\n")
+        node.text = lines.pop()
+        return [node.log_time + l for l in lines]
+
+def parse_elfs(specs):
+    elfs = {}
+    for s in specs:
+        node_id, sep, path = s.partition("=")
+        if sep and node_id.isdigit():
+            elfs[int(node_id)] = Elf(path)
+        else:
+            elfs[None] = Elf(s)
+    return elfs
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode Contiki-NG deferred log records")
+    ap.add_argument("log", nargs="?", help="log file (default: standard input)")
+    ap.add_argument("-e", "--elf", action="append", required=True, metavar="[ID=]FILE",
+                    help="firmware of all nodes, or of node ID; may be repeated")
+    ap.add_argument("-n", "--node", type=int, help="node ID for logs without Cooja prefix")
+    args = ap.parse_args()
+
+    decoder = Decoder(parse_elfs(args.elf))
+    source = open(args.log, errors="replace") if args.log else sys.stdin
+    for line in source:
+        for text in decoder.feed(line.rstrip("\n"), args.node):
+            print(text)
+
+#######################################################
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+
+# Decodes the records of os/sys/metrics.h from node output and writes them
+# as a table, one row per sample.
+#
+# Input is a Cooja or native-sim log ("<time>\tID:<id>\t<line>") or raw
+# serial output of a single node. Lines that are not metric records are
+# ignored. The output format follows the file name: CSV by default,
+# Parquet for *.parquet (requires pandas and pyarrow).
+
+import argparse
+import csv
+import re
+import sys
+
+PREFIX = "#M"
+TYPES = {1: "counter", 2: "gauge", 3: "timestamp"}
+COLUMNS = ["log_time", "node", "time_ms", "metric", "type", "index", "value"]
+
+LOG_LINE = re.compile(r"^(?P<time>\d+)\s+ID:(?P<id>\d+)\s+(?P<msg>.*)$")
+
+class Decoder:
+    """Turns log lines into samples. Keeps the metric names of every node."""
+
+    def __init__(self):
+        # (node, metric ID) -> (name, type)
+        self.names = {}
+
+    def feed(self, line, node=None):
+        """Returns a sample as a dict, or None for anything else"""
+        log_time = None
+        m = LOG_LINE.match(line)
+        if m:
+            log_time = int(m.group("time"))
+            node = int(m.group("id"))
+            line = m.group("msg")
+        pos = line.find(PREFIX)
+        if pos < 0:
+            return None
+        try:
+            rec = bytes.fromhex(line[pos + len(PREFIX):].strip())
+        except ValueError:
+            return None
+        if len(rec) >= 3 and rec[0] == 0:
+            self.names[(node, rec[1])] = (rec[3:].decode("ascii", "replace"),
+                                          TYPES.get(rec[2], str(rec[2])))
+            return None
+        if len(rec) != 12 or (node, rec[1]) not in self.names:
+            return None
+        name, mtype = self.names[(node, rec[1])]
+        return {
+            "log_time": log_time,
+            "node": node,
+            "time_ms": int.from_bytes(rec[8:12], "big"),
+            "metric": name,
+            "type": mtype,
+            "index": int.from_bytes(rec[2:4], "big"),
+            "value": int.from_bytes(rec[4:8], "big", signed=True),
+        }
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode Contiki-NG metric records")
+    ap.add_argument("log", nargs="?", help="log file (default: standard input)")
+    ap.add_argument("-o", "--output", default="-", help="output file, .csv or .parquet (default: CSV on standard output)")
+    ap.add_argument("-n", "--node", type=int, help="node ID for logs without Cooja prefix")
+    args = ap.parse_args()
+
+    decoder = Decoder()
+    source = open(args.log, errors="replace") if args.log else sys.stdin
+
+    if args.output.endswith(".parquet"):
+        import pandas as pd
+        rows = [s for s in (decoder.feed(line.rstrip("\n"), args.node) for line in source) if s]
+        pd.DataFrame(rows, columns=COLUMNS).to_parquet(args.output, index=False)
+        return
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    writer = csv.DictWriter(out, fieldnames=COLUMNS)
+    writer.writeheader()
+    for line in source:
+        sample = decoder.feed(line.rstrip("\n"), args.node)
+        if sample:
+            writer.writerow(sample)
+
+#######################################################
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,696 @@
+/*
+ * Copyright (c) 2026, Contiki-NG Project.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/*
+ * Medium and virtual clock for native nodes built with NATIVE_SIM=1.
+ *
+ * Every node is a separate process. Nodes run until they are idle or
+ * busy-wait, then report the deadline they wait for. Once all nodes
+ * wait, the medium jumps to the earliest deadline or radio event and
+ * wakes the nodes concerned. Nodes woken at the same time run in
+ * parallel on the host cores.
+ *
+ * Node output is printed as "<time in us>\tID:<id>\t<line>", the format
+ * of Cooja's log, in node order within each time step.
+ */
+#define _GNU_SOURCE
+/*---------------------------------------------------------------------------*/
+#include "native-sim-protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_NODES     256
+#define MAX_FRAMES    (2 * MAX_NODES)
+#define MAX_PRESSES   64
+/*---------------------------------------------------------------------------*/
+struct node {
+  pid_t pid;
+  int sock;
+  int out;
+  int alive;
+  int waiting;
+  int woken;
+  native_sim_time_t deadline;
+  int radio_on;
+  int channel;
+  native_sim_time_t tx_end;
+  int rx_frame;
+  int rx_bad;
+  char *line;
+  size_t line_len;
+  size_t line_size;
+};
+
+struct frame {
+  int used;
+  int started;
+  int src;
+  int channel;
+  native_sim_time_t start;
+  native_sim_time_t end;
+  uint16_t len;
+  uint8_t data[NATIVE_SIM_MAX_FRAME];
+};
+
+struct press {
+  int node;
+  native_sim_time_t time;
+};
+
+static struct node nodes[MAX_NODES];
+static int node_count;
+static struct frame frames[MAX_FRAMES];
+static struct press presses[MAX_PRESSES];
+static int press_count;
+
+/* Packet reception ratio between nodes, indexed [src][dst] */
+static float prr[MAX_NODES][MAX_NODES];
+
+static native_sim_time_t now;
+static uint64_t rng_state;
+
+static unsigned long frames_sent;
+static unsigned long frames_received;
+static unsigned long frames_lost;
+/*---------------------------------------------------------------------------*/
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [options] [count:]node.native ...\n"
+          "Options are:\n"
+          " -t seconds   simulated time (default 60)\n"
+          " -s seed      simulation seed (default 1)\n"
+          " -p prr       reception ratio of all links (default 1.0)\n"
+          " -l file      link file with \"src dst prr\" lines; only listed\n"
+          "              links exist\n"
+          " -b id@sec    press the button of node id at the given time\n"
+          "Node IDs are assigned from 1 in command line order.\n", prog);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+static double
+rng_uniform(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state >> 11) * (1.0 / 9007199254740992.0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_all(int fd, const void *buf, size_t len)
+{
+  const uint8_t *p = buf;
+  ssize_t n;
+
+  while(len > 0) {
+    n = write(fd, p, len);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      return;
+    }
+    p += n;
+    len -= n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_all(int fd, void *buf, size_t len)
+{
+  uint8_t *p = buf;
+  ssize_t n;
+
+  while(len > 0) {
+    n = read(fd, p, len);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      return -1;
+    }
+    p += n;
+    len -= n;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_msg(int i, uint8_t type, const void *payload, uint16_t len)
+{
+  struct native_sim_msg_hdr hdr;
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = type;
+  hdr.len = len;
+  hdr.time = now;
+  write_all(nodes[i].sock, &hdr, sizeof(hdr));
+  if(len > 0) {
+    write_all(nodes[i].sock, payload, len);
+  }
+  nodes[i].woken = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+kill_node(int i)
+{
+  if(nodes[i].alive) {
+    nodes[i].alive = 0;
+    nodes[i].waiting = 1;
+    close(nodes[i].sock);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+read_output(int i)
+{
+  struct node *n = &nodes[i];
+  ssize_t r;
+
+  if(n->out < 0) {
+    return;
+  }
+  while(1) {
+    if(n->line_size - n->line_len < 512) {
+      n->line_size = n->line_size ? 2 * n->line_size : 4096;
+      n->line = realloc(n->line, n->line_size);
+      if(n->line == NULL) {
+        err(EXIT_FAILURE, "realloc");
+      }
+    }
+    r = read(n->out, n->line + n->line_len, n->line_size - n->line_len);
+    if(r > 0) {
+      n->line_len += r;
+    } else if(r == 0) {
+      close(n->out);
+      n->out = -1;
+      return;
+    } else {
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+flush_output(void)
+{
+  int i;
+  char *p;
+  char *nl;
+  size_t rest;
+
+  for(i = 0; i < node_count; i++) {
+    read_output(i);
+    p = nodes[i].line;
+    rest = nodes[i].line_len;
+    while(rest > 0 && (nl = memchr(p, '\n', rest)) != NULL) {
+      printf("%llu\tID:%d\t%.*s\n", (unsigned long long)now, i + 1,
+             (int)(nl - p), p);
+      rest -= nl - p + 1;
+      p = nl + 1;
+    }
+    if(rest > 0 && p != nodes[i].line) {
+      memmove(nodes[i].line, p, rest);
+    }
+    nodes[i].line_len = rest;
+  }
+  fflush(stdout);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_msg(int i)
+{
+  struct native_sim_msg_hdr hdr;
+  uint8_t payload[NATIVE_SIM_MAX_FRAME + 1];
+  struct node *n = &nodes[i];
+  int f;
+
+  if(read_all(n->sock, &hdr, sizeof(hdr)) < 0
+     || hdr.len > sizeof(payload)
+     || (hdr.len > 0 && read_all(n->sock, payload, hdr.len) < 0)) {
+    warnx("node %d disconnected at %llu us", i + 1, (unsigned long long)now);
+    kill_node(i);
+    return;
+  }
+
+  switch(hdr.type) {
+  case NATIVE_SIM_MSG_HELLO:
+    break;
+  case NATIVE_SIM_MSG_WAIT:
+    n->waiting = 1;
+    n->deadline = hdr.time;
+    break;
+  case NATIVE_SIM_MSG_RADIO:
+    if(hdr.len >= 2) {
+      if(!payload[0] || payload[1] != n->channel) {
+        /* Reception aborted */
+        n->rx_frame = -1;
+      }
+      n->radio_on = payload[0];
+      n->channel = payload[1];
+    }
+    break;
+  case NATIVE_SIM_MSG_TX:
+    if(hdr.len < 2) {
+      break;
+    }
+    for(f = 0; f < MAX_FRAMES && frames[f].used; f++);
+    if(f == MAX_FRAMES) {
+      warnx("too many frames in the air, dropping one");
+      break;
+    }
+    frames_sent++;
+    frames[f].used = 1;
+    frames[f].started = 0;
+    frames[f].src = i;
+    frames[f].channel = payload[0];
+    frames[f].len = hdr.len - 1;
+    memcpy(frames[f].data, payload + 1, frames[f].len);
+    frames[f].start = now;
+    frames[f].end = now + NATIVE_SIM_AIRTIME(frames[f].len);
+    /* Half duplex */
+    n->rx_frame = -1;
+    n->tx_end = frames[f].end;
+    break;
+  default:
+    warnx("node %d: unknown message type %u", i + 1, hdr.type);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the woken nodes until every node waits again */
+static void
+run_nodes(void)
+{
+  struct pollfd pfd[2 * MAX_NODES];
+  int idx[2 * MAX_NODES];
+  int count;
+  int i;
+  int k;
+
+  while(1) {
+    count = 0;
+    for(i = 0; i < node_count; i++) {
+      if(nodes[i].alive && !nodes[i].waiting) {
+        pfd[count].fd = nodes[i].sock;
+        pfd[count].events = POLLIN;
+        idx[count++] = i;
+      }
+    }
+    if(count == 0) {
+      return;
+    }
+    /* Keep draining output so that nodes never block on a full pipe */
+    for(i = 0; i < node_count; i++) {
+      if(nodes[i].out >= 0) {
+        pfd[count].fd = nodes[i].out;
+        pfd[count].events = POLLIN;
+        idx[count++] = -1 - i;
+      }
+    }
+    if(poll(pfd, count, -1) < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      err(EXIT_FAILURE, "poll");
+    }
+    for(k = 0; k < count; k++) {
+      if(pfd[k].revents == 0) {
+        continue;
+      }
+      if(idx[k] >= 0) {
+        handle_msg(idx[k]);
+      } else {
+        read_output(-1 - idx[k]);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+frame_start(int f)
+{
+  struct frame *fr = &frames[f];
+  int i;
+
+  fr->started = 1;
+  for(i = 0; i < node_count; i++) {
+    struct node *n = &nodes[i];
+    if(i == fr->src || !n->alive || !n->radio_on || n->channel != fr->channel
+       || n->tx_end > now || prr[fr->src][i] <= 0) {
+      continue;
+    }
+    if(n->rx_frame >= 0) {
+      /* Collision: the frame being received is corrupted */
+      n->rx_bad = 1;
+      continue;
+    }
+    n->rx_frame = f;
+    n->rx_bad = 0;
+    send_msg(i, NATIVE_SIM_MSG_RX_START, NULL, 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+frame_end(int f)
+{
+  struct frame *fr = &frames[f];
+  uint8_t payload[NATIVE_SIM_MAX_FRAME + 1];
+  int i;
+
+  for(i = 0; i < node_count; i++) {
+    struct node *n = &nodes[i];
+    if(!n->alive || n->rx_frame != f) {
+      continue;
+    }
+    payload[0] = !n->rx_bad && rng_uniform() < prr[fr->src][i];
+    memcpy(payload + 1, fr->data, fr->len);
+    n->rx_frame = -1;
+    if(payload[0]) {
+      frames_received++;
+    } else {
+      frames_lost++;
+    }
+    send_msg(i, NATIVE_SIM_MSG_RX_END, payload, fr->len + 1);
+  }
+  fr->used = 0;
+}
+/*---------------------------------------------------------------------------*/
+static native_sim_time_t
+next_event(void)
+{
+  native_sim_time_t t = NATIVE_SIM_TIME_NONE;
+  int i;
+
+  for(i = 0; i < node_count; i++) {
+    if(nodes[i].alive && nodes[i].deadline < t) {
+      t = nodes[i].deadline;
+    }
+  }
+  for(i = 0; i < MAX_FRAMES; i++) {
+    if(frames[i].used) {
+      native_sim_time_t ft = frames[i].started ? frames[i].end : frames[i].start;
+      if(ft < t) {
+        t = ft;
+      }
+    }
+  }
+  for(i = 0; i < press_count; i++) {
+    if(presses[i].time < t) {
+      t = presses[i].time;
+    }
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+load_links(const char *file)
+{
+  FILE *fp;
+  int src;
+  int dst;
+  float p;
+
+  fp = fopen(file, "r");
+  if(fp == NULL) {
+    err(EXIT_FAILURE, "%s", file);
+  }
+  memset(prr, 0, sizeof(prr));
+  while(fscanf(fp, "%d %d %f", &src, &dst, &p) == 3) {
+    if(src < 1 || src > MAX_NODES || dst < 1 || dst > MAX_NODES) {
+      errx(EXIT_FAILURE, "%s: bad link %d %d", file, src, dst);
+    }
+    prr[src - 1][dst - 1] = p;
+  }
+  fclose(fp);
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_node(int i, const char *binary, const char *path, unsigned long seed)
+{
+  int out[2];
+  char id[16];
+  char seed_str[24];
+  pid_t pid;
+
+  if(pipe(out) < 0) {
+    err(EXIT_FAILURE, "pipe");
+  }
+  snprintf(id, sizeof(id), "%d", i + 1);
+  snprintf(seed_str, sizeof(seed_str), "%lu", seed);
+
+  pid = fork();
+  if(pid < 0) {
+    err(EXIT_FAILURE, "fork");
+  }
+  if(pid == 0) {
+    int devnull = open("/dev/null", O_RDONLY);
+    dup2(devnull, STDIN_FILENO);
+    dup2(out[1], STDOUT_FILENO);
+    close(out[0]);
+    close(out[1]);
+    execl(binary, binary, "--sim-socket", path, "--sim-id", id,
+          "--sim-seed", seed_str, (char *)NULL);
+    err(EXIT_FAILURE, "exec %s", binary);
+  }
+  close(out[1]);
+  fcntl(out[0], F_SETFL, O_NONBLOCK);
+
+  nodes[i].pid = pid;
+  nodes[i].out = out[0];
+  nodes[i].sock = -1;
+  nodes[i].rx_frame = -1;
+  nodes[i].channel = -1;
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  char dir[] = "/tmp/native-sim-XXXXXX";
+  char path[sizeof(dir) + 16];
+  struct sockaddr_un addr;
+  double duration = 60;
+  double default_prr = 1.0;
+  unsigned long seed = 1;
+  const char *link_file = NULL;
+  native_sim_time_t end;
+  struct timespec t0, t1;
+  int listener;
+  int opt;
+  int i;
+  int j;
+
+  while((opt = getopt(argc, argv, "t:s:p:l:b:h")) != -1) {
+    switch(opt) {
+    case 't':
+      duration = atof(optarg);
+      break;
+    case 's':
+      seed = strtoul(optarg, NULL, 0);
+      break;
+    case 'p':
+      default_prr = atof(optarg);
+      break;
+    case 'l':
+      link_file = optarg;
+      break;
+    case 'b':
+      if(press_count == MAX_PRESSES) {
+        errx(EXIT_FAILURE, "too many button presses");
+      }
+      {
+        const char *at = strchr(optarg, '@');
+        presses[press_count].node = atoi(optarg) - 1;
+        presses[press_count].time = at ? atof(at + 1) * 1000000 : 0;
+        press_count++;
+      }
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if(optind >= argc) {
+    usage(argv[0]);
+  }
+
+  rng_state = seed * 0x9e3779b97f4a7c15ULL + 1;
+  end = duration * 1000000;
+
+  for(i = 0; i < MAX_NODES; i++) {
+    for(j = 0; j < MAX_NODES; j++) {
+      prr[i][j] = default_prr;
+    }
+  }
+  if(link_file != NULL) {
+    load_links(link_file);
+  }
+
+  if(mkdtemp(dir) == NULL) {
+    err(EXIT_FAILURE, "mkdtemp");
+  }
+  snprintf(path, sizeof(path), "%s/medium", dir);
+  listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(listener < 0) {
+    err(EXIT_FAILURE, "socket");
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  if(bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0
+     || listen(listener, MAX_NODES) < 0) {
+    err(EXIT_FAILURE, "%s", path);
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  for(; optind < argc; optind++) {
+    const char *binary = argv[optind];
+    const char *colon = strchr(binary, ':');
+    int count = 1;
+
+    if(colon != NULL && colon != binary
+       && strspn(binary, "0123456789") == (size_t)(colon - binary)) {
+      count = atoi(binary);
+      binary = colon + 1;
+    }
+    if(access(binary, X_OK) < 0) {
+      err(EXIT_FAILURE, "%s", binary);
+    }
+    while(count-- > 0) {
+      if(node_count == MAX_NODES) {
+        errx(EXIT_FAILURE, "at most %d nodes", MAX_NODES);
+      }
+      start_node(node_count++, binary, path, seed);
+    }
+  }
+
+  /* Nodes identify themselves with their first message */
+  for(i = 0; i < node_count; i++) {
+    struct native_sim_msg_hdr hdr;
+    uint16_t id;
+    struct pollfd pfd = { listener, POLLIN, 0 };
+    int s;
+    if(poll(&pfd, 1, 10000) <= 0) {
+      errx(EXIT_FAILURE, "nodes failed to start");
+    }
+    s = accept(listener, NULL, NULL);
+    if(s < 0 || read_all(s, &hdr, sizeof(hdr)) < 0
+       || hdr.type != NATIVE_SIM_MSG_HELLO || hdr.len != sizeof(id)
+       || read_all(s, &id, sizeof(id)) < 0 || id < 1 || id > node_count) {
+      errx(EXIT_FAILURE, "node failed to connect");
+    }
+    nodes[id - 1].sock = s;
+    nodes[id - 1].alive = 1;
+  }
+  close(listener);
+  unlink(path);
+  rmdir(dir);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  while(1) {
+    native_sim_time_t t;
+
+    run_nodes();
+    flush_output();
+
+    t = next_event();
+    if(t == NATIVE_SIM_TIME_NONE || t > end) {
+      break;
+    }
+    if(t > now) {
+      now = t;
+    }
+
+    for(i = 0; i < MAX_FRAMES; i++) {
+      if(frames[i].used && frames[i].started && frames[i].end <= now) {
+        frame_end(i);
+      }
+    }
+    for(i = 0; i < MAX_FRAMES; i++) {
+      if(frames[i].used && !frames[i].started && frames[i].start <= now) {
+        frame_start(i);
+      }
+    }
+    for(i = 0; i < press_count; i++) {
+      if(presses[i].time <= now) {
+        if(presses[i].node >= 0 && presses[i].node < node_count
+           && nodes[presses[i].node].alive) {
+          send_msg(presses[i].node, NATIVE_SIM_MSG_BUTTON, NULL, 0);
+        }
+        presses[i--] = presses[--press_count];
+      }
+    }
+
+    for(i = 0; i < node_count; i++) {
+      if(nodes[i].alive && (nodes[i].woken || nodes[i].deadline <= now)) {
+        nodes[i].woken = 0;
+        nodes[i].waiting = 0;
+        nodes[i].deadline = NATIVE_SIM_TIME_NONE;
+        send_msg(i, NATIVE_SIM_MSG_WAKE, NULL, 0);
+        nodes[i].woken = 0;
+      }
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  for(i = 0; i < node_count; i++) {
+    kill_node(i);
+    kill(nodes[i].pid, SIGTERM);
+  }
+  for(i = 0; i < node_count; i++) {
+    waitpid(nodes[i].pid, NULL, 0);
+  }
+
+  {
+    double wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    fprintf(stderr, "native-sim: %d nodes, %.1f s simulated in %.2f s (x%.0f)\n",
+            node_count, now / 1e6, wall, wall > 0 ? now / 1e6 / wall : 0);
+    fprintf(stderr, "native-sim: %lu frames sent, %lu received, %lu lost\n",
+            frames_sent, frames_received, frames_lost);
+  }
+  return EXIT_SUCCESS;
+}
+/*---------------------------------------------------------------------------*/